@@ -0,0 +1,45 @@
+#version 460 core
+#pragma features BINDLESS
+
+#ifdef BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+in vec3 ourColor;
+in vec2 TexCoord;
+in vec4 tintColor;
+flat in uint drawIndex;
+
+out vec4 FragColor;
+
+// Текстуры отрисовки, раскладка MaterialData (std430)
+struct MaterialData
+{
+    uvec2 textures[4]; // Дескрипторы bindless текстур
+    vec4 layers;       // Слои массивов текстур без bindless
+};
+
+layout (std430, binding = 1) readonly buffer MaterialBuffer
+{
+    MaterialData materials[];
+};
+
+#ifndef BINDLESS
+// Без bindless у всех отрисовок вызова общие массивы текстур, различаются только слои
+layout (binding = 0) uniform sampler2DArray ourTexture1;
+layout (binding = 1) uniform sampler2DArray ourTexture2;
+#endif
+
+void main()
+{
+    MaterialData material = materials[drawIndex];
+#ifdef BINDLESS
+    // drawIndex одинаков в пределах команды, поэтому дескриптор динамически однороден
+    vec4 first = texture(sampler2D(material.textures[0]), TexCoord);
+    vec4 second = texture(sampler2D(material.textures[1]), TexCoord);
+#else
+    vec4 first = texture(ourTexture1, vec3(TexCoord, material.layers.x));
+    vec4 second = texture(ourTexture2, vec3(TexCoord, material.layers.y));
+#endif
+    FragColor = mix(first, second, 0.2f) * tintColor;
+}
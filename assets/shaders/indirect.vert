@@ -0,0 +1,46 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 texCoord;
+
+// Данные отрисовки, раскладка DrawData (std430)
+struct DrawData
+{
+    mat4 model;
+    vec4 color;
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer
+{
+    DrawData draws[];
+};
+
+// Общие данные кадра, раскладка FrameData (std140)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec2 viewportSize;
+    float time;
+    float deltaTime;
+} frame;
+
+out vec3 ourColor;
+out vec2 TexCoord;
+out vec4 tintColor;
+flat out uint drawIndex; // gl_BaseInstance есть только в вершинном шейдере
+
+void main()
+{
+    // baseInstance команды - индекс ее данных. Совпадает с gl_DrawID, пока команды не сжаты GPU отсечением
+    DrawData draw = draws[gl_BaseInstance];
+
+    gl_Position = frame.viewProjection * draw.model * vec4(aPosition, 1.0);
+    ourColor = aColor;
+    TexCoord = vec2(texCoord.x, 1.0f - texCoord.y);
+    tintColor = draw.color;
+    drawIndex = uint(gl_BaseInstance);
+}
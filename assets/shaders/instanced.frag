@@ -0,0 +1,17 @@
+#version 460 core
+
+in vec3 ourColor;
+in vec2 TexCoord;
+in vec4 tintColor;
+flat in float textureLayer;
+
+out vec4 FragColor;
+
+// Упакованные текстуры (ResourceManager::AcquireTextureLayer, слои заполняет Scene::SubmitDraws) - экземпляры
+// с разными текстурами различаются только слоем и рисуются одним вызовом
+uniform sampler2DArray ourTextures;
+
+void main()
+{
+    FragColor = texture(ourTextures, vec3(TexCoord, textureLayer)) * tintColor;
+}
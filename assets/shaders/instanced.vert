@@ -0,0 +1,36 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 texCoord;
+
+// Атрибуты экземпляра (divisor = 1), раскладка InstanceData
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in vec4 instanceColor;
+layout (location = 8) in float instanceLayer;
+
+// Общие данные кадра, раскладка FrameData (std140)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec2 viewportSize;
+    float time;
+    float deltaTime;
+} frame;
+
+out vec3 ourColor;
+out vec2 TexCoord;
+out vec4 tintColor;
+flat out float textureLayer;
+
+void main()
+{
+    gl_Position = frame.viewProjection * instanceModel * vec4(aPosition, 1.0);
+    ourColor = aColor;
+    TexCoord = vec2(texCoord.x, 1.0f - texCoord.y);
+    tintColor = instanceColor;
+    textureLayer = instanceLayer;
+}
@@ -1,12 +1,26 @@
 #version 460 core
 
+// Ключевые слова вариантов: без TEXTURED выводится только градиент
+#pragma features TEXTURED
+
 in vec3 ourColor;
 in vec2 TexCoord;
 
 out vec4 FragColor;
 
+// Общие данные кадра, раскладка FrameData (std140)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec2 viewportSize;
+    float time;
+    float deltaTime;
+} frame;
+
 // Uniform переменные для градиента
-uniform float time;
 uniform vec3 colorStart;
 uniform vec3 colorEnd;
 
@@ -17,9 +31,13 @@ uniform sampler2D ourTexture2;
 void main()
 {
     // Градиент
-    float t = (sin(time) + 1.0f) / 2.0f;
+    float t = (sin(frame.time) + 1.0f) / 2.0f;
     vec3 gradientColor = mix(colorStart, colorEnd, t);
 
+#ifdef TEXTURED
     // Привязка текстуры
     FragColor = mix(texture(ourTexture1, TexCoord), texture(ourTexture2, TexCoord), 0.2f);
+#else
+    FragColor = vec4(gradientColor, 1.0f);
+#endif
 }
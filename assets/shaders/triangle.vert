@@ -4,9 +4,19 @@ layout (location = 0) in vec3 aPosition;
 layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec2 texCoord;
 
+// Общие данные кадра, раскладка FrameData (std140)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec2 viewportSize;
+    float time;
+    float deltaTime;
+} frame;
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform mat4 transform;
 
 out vec3 ourColor;
@@ -15,7 +25,7 @@ out vec2 TexCoord;
 void main()
 {
     //gl_Position = transform * vec4(aPosition, 1.0);
-    gl_Position = projection * view * model * vec4(aPosition, 1.0);
+    gl_Position = frame.viewProjection * model * vec4(aPosition, 1.0);
     ourColor = aColor;
     TexCoord = vec2(texCoord.x, 1.0f - texCoord.y);
 }
@@ -6,7 +6,10 @@
 #include "../platform/Window.h"
 #include "../platform/Input.h"
 #include "../render/Renderer.h"
+#include "../scene/Scene.h"
 #include "../utils/Logger.h"
+#include "../utils/ResourceManager.h"
+#include "../utils/ThreadPool.h"
 #include <glm/glm.hpp>
 
 Application* Application::s_instance = nullptr;
@@ -25,6 +28,13 @@ Application::Application(int width, int height, const std::string& title)
     WindowProps windowProps(title, width, height, true);
     m_window   = std::make_unique<Window>(windowProps);
     m_renderer = std::make_unique<Renderer>();
+    // Пул создается до пользовательской инициализации - на нем декодируются асинхронные загрузки
+    m_threadPool = std::make_unique<ThreadPool>();
+    m_scene      = std::make_unique<Scene>();
+
+    // Загрузчик ресурсов не знает о приложении - рендер и пул передаются ему явно
+    RESOURCE_MANAGER.SetRenderer(m_renderer.get());
+    RESOURCE_MANAGER.SetThreadPool(m_threadPool.get());
 }
 
 Application::~Application()
@@ -67,12 +77,36 @@ void Application::Run()
         // Обновляем логику приложения с учетом времени кадра
         Update(m_deltaTime);
 
+        // Структурные изменения, отложенные во время обхода, и матрицы сущностей
+        m_scene->FlushCommands();
+        m_scene->UpdateTransforms();
+
+        // Начало кадра в рендере - сброс покадровой статистики
+        m_renderer->BeginFrame();
+
+        // Объекты GL, освобожденные в прошлом кадре, больше не используются его пакетами
+        RESOURCE_MANAGER.CollectGarbage();
+        // Загрузка декодированных в фоне текстур в пределах бюджета кадра
+        RESOURCE_MANAGER.ProcessPendingUploads(TEXTURE_UPLOAD_BUDGET_MS);
+        // Уровни mip потоковых текстур по запросам прошлого кадра
+        RESOURCE_MANAGER.ProcessTextureStreaming(TEXTURE_UPLOAD_BUDGET_MS);
+        // Программы, которые драйвер уже собрал на своих потоках
+        RESOURCE_MANAGER.ProcessPendingShaders();
+        // Измененные на диске ассеты подменяются за теми же дескрипторами
+        RESOURCE_MANAGER.ProcessHotReload();
+
         // Очистка буфера кадра перед следующей отрисовкой
         m_renderer->Clear(glm::vec4(0.5f, 0.54f, 1.0f, 1.0f));
 
-        // Выполнение отрисовки сцены
+        // Выполнение отрисовки сцены - приложение заполняет очередь команд
         Render();
 
+        // Видимые сущности сцены уходят в очередь - камеру кадра приложение выставило в Render()
+        m_scene->SubmitDraws(*m_renderer, m_threadPool.get());
+        // Сортировка и исполнение накопленных за кадр пакетов
+        m_renderer->FlushRenderQueue();
+        m_renderer->EndFrame();
+
         // Отображение отрисованного кадра пользователю
         m_window->SwapBuffers();
         //Обработка события окна
@@ -113,6 +147,8 @@ void Application::InitializeEngine()
         LOG_ERROR("Failed to initialize Renderer!");
         return;
     }
+    // Начальная область отрисовки по размеру окна - от нее считается соотношение сторон проекции
+    m_renderer->SetViewport(m_window->GetWidth(), m_window->GetHeight());
 
     // Вызываем пользовательскую инициализацию
     Initialize();
@@ -128,7 +164,20 @@ void Application::ShutdownEngine()
     // Вызываем пользовательскую очистку ресурсов
     Shutdown();
 
+    // Освобожденные объекты GL удаляет CollectGarbage следующего кадра, а его уже не будет - все удаляется
+    // здесь, пока живы контекст, рендер и пул
+    RESOURCE_MANAGER.Shutdown();
+
+    // Компоненты держат невладеющие дескрипторы - сцена очищается вместе с ресурсами приложения
+    if (m_scene) m_scene.reset();
+
     // Освобождаем ресурсы в обратном порядку создания
+    // Пул останавливается первым - фоновые задачи не должны пережить рендер
+    RESOURCE_MANAGER.SetThreadPool(nullptr);
+    if (m_threadPool) m_threadPool.reset();
+
+    RESOURCE_MANAGER.SetRenderer(nullptr);
+
     if (m_renderer) m_renderer.reset();
 
     if (m_window) m_window.reset();
@@ -16,6 +16,8 @@
 
 class Window;
 class Renderer;
+class Scene;
+class ThreadPool;
 
 class Application {
 public:
@@ -45,6 +47,10 @@ public:
     // Геттеры - дают доступ к внутренним компонентам
     Window*   GetWindow() const { return m_window.get(); }
     Renderer* GetRenderer() const { return m_renderer.get(); }
+    // Общий пул рабочих потоков для фоновых задач
+    ThreadPool* GetThreadPool() const { return m_threadPool.get(); }
+    // Сущности сцены: отложенные изменения применяются после Update, пакеты отправляются после Render
+    Scene* GetScene() const { return m_scene.get(); }
 
     // Синглтон, дающий глобальный доступ к приложению
     static Application* GetInstance() { return s_instance; }
@@ -57,8 +63,13 @@ private:
 
 private:
     // Основные компоненты движка - умные указатели для автоматической очистки памяти
-    std::unique_ptr<Window>   m_window;
-    std::unique_ptr<Renderer> m_renderer;
+    std::unique_ptr<Window>     m_window;
+    std::unique_ptr<Renderer>   m_renderer;
+    std::unique_ptr<ThreadPool> m_threadPool;
+    std::unique_ptr<Scene>      m_scene;
+
+    // Время на загрузку готовых текстур в GPU за кадр, мс
+    static constexpr double TEXTURE_UPLOAD_BUDGET_MS = 2.0;
 
     // Состояние приложения
     bool  m_running       = true; // Флаг продолжения работы основного цикла while
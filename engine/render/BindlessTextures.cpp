@@ -0,0 +1,74 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "BindlessTextures.h"
+#include "GLExtensions.h"
+#include "../utils/Logger.h"
+
+#include <GLFW/glfw3.h>
+
+bool BindlessTextures::Initialize()
+{
+    m_supported = false;
+    m_handles.clear();
+
+    if (!HasGLExtension("GL_ARB_bindless_texture"))
+    {
+        LOG_INFO("GL_ARB_bindless_texture is not available, falling back to texture arrays");
+        return false;
+    }
+
+    // Расширение не входит в сгенерированный glad - функции загружаются вручную
+    m_getTextureHandle = reinterpret_cast<GetTextureHandleFn>(glfwGetProcAddress("glGetTextureHandleARB"));
+    m_makeResident     = reinterpret_cast<MakeHandleResidentFn>(glfwGetProcAddress("glMakeTextureHandleResidentARB"));
+    m_makeNonResident =
+        reinterpret_cast<MakeHandleNonResidentFn>(glfwGetProcAddress("glMakeTextureHandleNonResidentARB"));
+    if (!m_getTextureHandle || !m_makeResident || !m_makeNonResident)
+    {
+        LOG_WARN("GL_ARB_bindless_texture is advertised but its functions could not be loaded");
+        return false;
+    }
+
+    m_supported = true;
+    LOG_INFO("Bindless textures enabled");
+    return true;
+}
+
+void BindlessTextures::Shutdown()
+{
+    if (m_supported)
+    {
+        for (const auto& [texture, handle] : m_handles) { m_makeNonResident(handle); }
+    }
+    m_handles.clear();
+    m_supported = false;
+}
+
+GLuint64 BindlessTextures::GetHandle(GLuint texture)
+{
+    if (!m_supported || texture == 0) { return 0; }
+
+    auto it = m_handles.find(texture);
+    if (it != m_handles.end()) { return it->second; }
+
+    GLuint64 handle = m_getTextureHandle(texture);
+    if (handle == 0)
+    {
+        LOG_ERROR("Failed to get bindless handle for texture {}", texture);
+        return 0;
+    }
+
+    m_makeResident(handle);
+    m_handles.emplace(texture, handle);
+    return handle;
+}
+
+void BindlessTextures::OnTextureDeleted(GLuint texture)
+{
+    auto it = m_handles.find(texture);
+    if (it == m_handles.end()) { return; }
+
+    m_makeNonResident(it->second);
+    m_handles.erase(it);
+}
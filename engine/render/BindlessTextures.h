@@ -0,0 +1,50 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef BINDLESSTEXTURES_H
+#define BINDLESSTEXTURES_H
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+/**
+ * Резидентные 64-битные дескрипторы текстур (GL_ARB_bindless_texture)
+ * Шейдер получает дескриптор из буфера и сэмплирует текстуру без привязки к юниту, поэтому отрисовки
+ * с разными текстурами сливаются в один вызов. Дескриптор создается при первом запросе и остается резидентным
+ * до удаления текстуры. После создания дескриптора параметры и хранилище текстуры менять нельзя -
+ * замены (перезагрузка, mip) идут через новую текстуру.
+ * Без расширения (например, llvmpipe) IsSupported() == false, и рендер использует массивы текстур.
+ */
+class BindlessTextures
+{
+public:
+    bool Initialize();
+    void Shutdown();
+
+    bool IsSupported() const { return m_supported; }
+
+    // Дескриптор текстуры, резидентный до OnTextureDeleted. 0, если расширение недоступно
+    GLuint64 GetHandle(GLuint texture);
+    // Вызывается до glDeleteTextures - дескриптор делается нерезидентным
+    void OnTextureDeleted(GLuint texture);
+
+    size_t GetResidentCount() const { return m_handles.size(); }
+
+private:
+    // Точки входа GL вызываются в соглашении APIENTRY (__stdcall на 32-битной Windows)
+    using GetTextureHandleFn      = GLuint64(APIENTRY*)(GLuint);
+    using MakeHandleResidentFn    = void(APIENTRY*)(GLuint64);
+    using MakeHandleNonResidentFn = void(APIENTRY*)(GLuint64);
+
+    bool                                 m_supported        = false;
+    GetTextureHandleFn                   m_getTextureHandle = nullptr;
+    MakeHandleResidentFn                 m_makeResident     = nullptr;
+    MakeHandleNonResidentFn              m_makeNonResident  = nullptr;
+    std::unordered_map<GLuint, GLuint64> m_handles; // Текстура -> резидентный дескриптор
+};
+#endif // BINDLESSTEXTURES_H
@@ -0,0 +1,43 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef FRAMEDATA_H
+#define FRAMEDATA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+/**
+ * Общие для всех программ данные кадра - uniform блок FrameData (std140)
+ * Рендер заполняет его один раз за кадр, программы с этим блоком привязываются к BINDING при рефлексии.
+ * Раскладка должна совпадать с блоком FrameData в шейдерах:
+ *
+ *   uniform FrameData
+ *   {
+ *       mat4  view;
+ *       mat4  projection;
+ *       mat4  viewProjection;
+ *       vec4  cameraPosition;
+ *       vec2  viewportSize;
+ *       float time;
+ *       float deltaTime;
+ *   } frame;
+ */
+struct FrameData
+{
+    static constexpr GLuint BINDING = 0; // Точка привязки uniform буфера
+
+    glm::mat4 view           = glm::mat4(1.0f);
+    glm::mat4 projection     = glm::mat4(1.0f);
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    glm::vec4 cameraPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // w = 1
+    glm::vec2 viewportSize   = glm::vec2(0.0f);
+    float     time           = 0.0f;
+    float     deltaTime      = 0.0f;
+};
+
+static_assert(sizeof(FrameData) == 224, "FrameData must match the std140 layout of the shader block");
+#endif // FRAMEDATA_H
@@ -0,0 +1,21 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "GLExtensions.h"
+
+#include <cstring>
+
+#include <glad/glad.h>
+
+bool HasGLExtension(const char* extension)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const auto* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (name && std::strcmp(name, extension) == 0) { return true; }
+    }
+    return false;
+}
@@ -0,0 +1,12 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef GLEXTENSIONS_H
+#define GLEXTENSIONS_H
+
+// Поддерживает ли текущий контекст расширение (по списку glGetStringi). Требует активного контекста
+bool HasGLExtension(const char* extension);
+#endif // GLEXTENSIONS_H
@@ -0,0 +1,71 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "GpuCulling.h"
+#include "IndirectDraw.h"
+#include "RenderState.h"
+#include "../utils/Logger.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Начальный размер буферов: команды примерно 3000 отрисовок, счетчики 64 вызовов по 256 байт
+    constexpr GLsizeiptr MIN_COMMAND_BYTES = 64 * 1024;
+    constexpr GLsizeiptr MIN_COUNT_BYTES   = 16 * 1024;
+} // namespace
+
+void GpuCulling::Shutdown(RenderStateCache& state)
+{
+    for (Region* region : {&m_commands, &m_counts})
+    {
+        if (region->buffer == 0) { continue; }
+        glDeleteBuffers(1, &region->buffer);
+        state.OnBufferDeleted(region->buffer);
+        *region = {};
+    }
+    m_program = nullptr;
+}
+
+void GpuCulling::BeginFrame()
+{
+    m_commands.offset = 0;
+    m_counts.offset   = 0;
+    m_submitted       = 0;
+}
+
+GpuCulling::Output GpuCulling::Reserve(uint32_t count, RenderStateCache& state)
+{
+    Output output;
+    output.commandOffset = Allocate(m_commands, count * sizeof(DrawElementsIndirectCommand), MIN_COMMAND_BYTES, state);
+    output.countOffset   = Allocate(m_counts, sizeof(GLuint), MIN_COUNT_BYTES, state);
+    output.commandBuffer = m_commands.buffer;
+    output.countBuffer   = m_counts.buffer;
+    if (output) { m_submitted += count; }
+    return output;
+}
+
+GLintptr GpuCulling::Allocate(Region& region, GLsizeiptr size, GLsizeiptr minimumCapacity, RenderStateCache& state)
+{
+    GLintptr offset = (region.offset + m_alignment - 1) / m_alignment * m_alignment;
+    if (region.buffer == 0 || offset + size > region.capacity)
+    {
+        // Буфер только для GPU: команды пишет шейдер, счетчик обнуляет glClearNamedBufferSubData
+        GLsizeiptr capacity = std::max({region.capacity * 2, size * 2, minimumCapacity});
+        if (region.buffer != 0)
+        {
+            glDeleteBuffers(1, &region.buffer);
+            state.OnBufferDeleted(region.buffer);
+        }
+
+        glCreateBuffers(1, &region.buffer);
+        glNamedBufferStorage(region.buffer, capacity, nullptr, 0);
+        region.capacity = capacity;
+        offset          = 0;
+        LOG_DEBUG("GPU culling buffer {} grown to {} bytes", region.buffer, capacity);
+    }
+
+    region.offset = offset + size;
+    return offset;
+}
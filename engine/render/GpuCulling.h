@@ -0,0 +1,78 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef GPUCULLING_H
+#define GPUCULLING_H
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+class RenderStateCache;
+class ShaderProgram;
+
+/**
+ * Буферы GPU отсечения indirect отрисовок (cull.comp)
+ * Вычислительный шейдер проверяет бокс каждой отрисовки по пирамиде видимости и дописывает видимые команды
+ * в выходной буфер через атомарный счетчик, а glMultiDrawElementsIndirectCount читает число команд из того же
+ * счетчика - CPU не узнает и не ждет результата. Каждому вызову кадра выделяется свой диапазон команд и свой
+ * счетчик, буферы только в видеопамяти и растут по необходимости.
+ */
+class GpuCulling
+{
+public:
+    // Должны совпадать с cull.comp
+    static constexpr GLuint GROUP_SIZE     = 64;
+    static constexpr GLuint INPUT_BINDING  = 3; // Исходные команды
+    static constexpr GLuint OUTPUT_BINDING = 4; // Сжатые видимые команды
+    static constexpr GLuint COUNT_BINDING  = 5; // Счетчик видимых, он же параметр draw count
+
+    // Место под результат одного вызова
+    struct Output
+    {
+        GLuint   commandBuffer = 0;
+        GLintptr commandOffset = 0;
+        GLuint   countBuffer   = 0;
+        GLintptr countOffset   = 0;
+
+        explicit operator bool() const { return commandBuffer != 0 && countBuffer != 0; }
+    };
+
+    // alignment - GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT: оба диапазона привязываются как SSBO
+    void Initialize(GLintptr alignment) { m_alignment = alignment; }
+    void Shutdown(RenderStateCache& state);
+
+    // nullptr выключает отсечение
+    void           SetProgram(ShaderProgram* program) { m_program = program; }
+    ShaderProgram* GetProgram() const { return m_program; }
+    bool           IsEnabled() const { return m_program != nullptr; }
+
+    // Диапазоны прошлого кадра освобождаются - GPU исполняет кадры по порядку
+    void   BeginFrame();
+    // Выходные диапазоны для count команд. Рост пересоздает буфер - вызовы кадра, уже отправленные драйверу,
+    // держат старый буфер до своего исполнения
+    Output Reserve(uint32_t count, RenderStateCache& state);
+
+    // Отрисовки, отправленные на отсечение за текущий кадр
+    uint32_t GetSubmittedCount() const { return m_submitted; }
+
+private:
+    struct Region
+    {
+        GLuint     buffer   = 0;
+        GLsizeiptr capacity = 0;
+        GLintptr   offset   = 0;
+    };
+
+    GLintptr Allocate(Region& region, GLsizeiptr size, GLsizeiptr minimumCapacity, RenderStateCache& state);
+
+    ShaderProgram* m_program   = nullptr;
+    GLintptr       m_alignment = 16;
+    Region         m_commands;
+    Region         m_counts;
+    uint32_t       m_submitted = 0;
+};
+#endif // GPUCULLING_H
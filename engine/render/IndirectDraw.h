@@ -0,0 +1,69 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef INDIRECTDRAW_H
+#define INDIRECTDRAW_H
+
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Команда glMultiDrawElementsIndirect - раскладка фиксирована спецификацией OpenGL
+struct DrawElementsIndirectCommand
+{
+    GLuint count;         // Количество индексов
+    GLuint instanceCount; // Количество экземпляров
+    GLuint firstIndex;    // Первый индекс в EBO
+    GLint  baseVertex;    // Смещение, добавляемое к каждому индексу
+    GLuint baseInstance;  // Первый экземпляр
+};
+
+/**
+ * Данные одной отрисовки в SSBO (std430), шейдер читает их по gl_BaseInstance (baseInstance команды)
+ * Раскладка должна совпадать с DrawData в indirect.vert и cull.comp
+ */
+struct DrawData
+{
+    static constexpr GLuint BINDING = 0; // layout(std430, binding = 0) buffer DrawDataBuffer
+
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec4 color = glm::vec4(1.0f);
+};
+
+/**
+ * Текстуры одной отрисовки в SSBO (std430), шейдер читает их по индексу данных отрисовки
+ * С GL_ARB_bindless_texture - резидентные дескрипторы (uvec2 в шейдере), без него - слои массивов текстур,
+ * привязанных к юнитам общим для всего вызова. Раскладка должна совпадать с MaterialData в indirect.frag
+ */
+struct MaterialData
+{
+    static constexpr GLuint   BINDING      = 1; // layout(std430, binding = 1) buffer MaterialBuffer
+    static constexpr uint32_t MAX_TEXTURES = 4;
+
+    GLuint64  textures[MAX_TEXTURES] = {};              // Дескриптор текстуры юнита i, 0 - не используется
+    glm::vec4 layers                 = glm::vec4(0.0f); // Слой массива текстур юнита i
+};
+
+/**
+ * Локальный AABB отрисовки для GPU отсечения в SSBO (std430), мировой бокс считается в cull.comp
+ * по матрице DrawData::model. Раскладка должна совпадать с DrawBounds в cull.comp
+ */
+struct DrawBounds
+{
+    static constexpr GLuint BINDING = 2; // layout(std430, binding = 2) buffer DrawBoundsBuffer
+
+    glm::vec4 center  = glm::vec4(0.0f);
+    glm::vec4 extents = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f); // w < 0 - отрисовка видима всегда
+
+    static DrawBounds FromLocal(const glm::vec3& localCenter, const glm::vec3& localExtents)
+    {
+        return {glm::vec4(localCenter, 1.0f), glm::vec4(localExtents, 0.0f)};
+    }
+
+    bool IsCullable() const { return extents.w >= 0.0f; }
+};
+#endif // INDIRECTDRAW_H
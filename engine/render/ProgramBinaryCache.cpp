@@ -0,0 +1,197 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "ProgramBinaryCache.h"
+#include "../utils/Logger.h"
+#include "../utils/MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr uint32_t CACHE_MAGIC   = 0x43425059; // "YPBC"
+    constexpr uint32_t CACHE_VERSION = 1;
+
+    // Заголовок файла записи, за ним - бинарник программы
+    struct CacheEntryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+        uint64_t key;
+        uint64_t checksum; // Хэш бинарника - защита от обрезанных и испорченных файлов
+    };
+
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+    uint64_t HashBytes(const void* data, size_t size, uint64_t hash = FNV_OFFSET)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string GetGLString(GLenum name)
+    {
+        const auto* value = reinterpret_cast<const char*>(glGetString(name));
+        return value ? value : "";
+    }
+} // namespace
+
+bool ProgramBinaryCache::Initialize(const std::string& directory)
+{
+    m_directory = directory;
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0)
+    {
+        LOG_WARN("Driver exposes no program binary formats, shader cache disabled");
+        m_enabled = false;
+        return false;
+    }
+
+    // Бинарник действителен только для того же драйвера - его строки входят в каждый ключ
+    std::string driver = GetGLString(GL_VENDOR) + "|" + GetGLString(GL_RENDERER) + "|" + GetGLString(GL_VERSION) + "|" +
+                         GetGLString(GL_SHADING_LANGUAGE_VERSION);
+    m_driverHash = HashBytes(driver.data(), driver.size());
+
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+    if (error)
+    {
+        LOG_WARN("Failed to create shader cache directory {}: {}", m_directory, error.message());
+        m_enabled = false;
+        return false;
+    }
+
+    m_enabled = true;
+    LOG_INFO("Program binary cache enabled in {}", m_directory);
+    return true;
+}
+
+uint64_t ProgramBinaryCache::MakeKey(std::initializer_list<std::string_view> sources) const
+{
+    uint64_t hash = HashBytes(&m_driverHash, sizeof(m_driverHash));
+    for (std::string_view source : sources)
+    {
+        // Длина перед текстом - разные разбиения на стадии не дают одинаковый ключ
+        uint64_t length = source.size();
+        hash            = HashBytes(&length, sizeof(length), hash);
+        hash            = HashBytes(source.data(), source.size(), hash);
+    }
+    return hash;
+}
+
+std::string ProgramBinaryCache::GetEntryPath(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return m_directory + "/" + name;
+}
+
+GLuint ProgramBinaryCache::Load(uint64_t key)
+{
+    if (!m_enabled) { return 0; }
+
+    std::string path = GetEntryPath(key);
+    if (!fs::exists(path)) { return 0; }
+
+    MappedFile file;
+    if (!file.Open(path)) { return 0; }
+
+    CacheEntryHeader header{};
+    bool             valid = file.GetSize() >= sizeof(header);
+    if (valid)
+    {
+        std::memcpy(&header, file.GetData(), sizeof(header));
+        const uint8_t* binary = file.GetData() + sizeof(header);
+        valid = header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.key == key &&
+                file.GetSize() - sizeof(header) == header.binaryLength &&
+                HashBytes(binary, header.binaryLength) == header.checksum;
+    }
+
+    GLuint program = 0;
+    if (valid)
+    {
+        program = glCreateProgram();
+        glProgramBinary(program,
+                        header.binaryFormat,
+                        file.GetData() + sizeof(header),
+                        static_cast<GLsizei>(header.binaryLength));
+
+        // Драйвер вправе отвергнуть бинарник (например, после обновления) - тогда собираем из исходников
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            glDeleteProgram(program);
+            program = 0;
+            valid   = false;
+        }
+    }
+
+    if (!valid)
+    {
+        LOG_WARN("Discarding stale shader cache entry {}", path);
+        file.Close();
+        std::error_code error;
+        fs::remove(path, error);
+        return 0;
+    }
+
+    LOG_DEBUG("Program loaded from binary cache {}", path);
+    return program;
+}
+
+void ProgramBinaryCache::Store(uint64_t key, GLuint program)
+{
+    if (!m_enabled || program == 0) { return; }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) { return; }
+
+    std::vector<uint8_t> binary(static_cast<size_t>(length));
+    GLenum               format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    CacheEntryHeader header{};
+    header.magic        = CACHE_MAGIC;
+    header.version      = CACHE_VERSION;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(length);
+    header.key          = key;
+    header.checksum     = HashBytes(binary.data(), static_cast<size_t>(length));
+
+    // Запись во временный файл и переименование - параллельный запуск не прочитает недописанную запись
+    std::string path     = GetEntryPath(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARN("Failed to write shader cache entry {}", tempPath);
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(binary.data()), length);
+    }
+
+    std::error_code error;
+    fs::rename(tempPath, path, error);
+    if (error) { LOG_WARN("Failed to store shader cache entry {}: {}", path, error.message()); }
+}
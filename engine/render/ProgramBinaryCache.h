@@ -0,0 +1,45 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef PROGRAMBINARYCACHE_H
+#define PROGRAMBINARYCACHE_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+#include <glad/glad.h>
+
+/**
+ * Дисковый кэш слинкованных программ (glGetProgramBinary / glProgramBinary)
+ * Ключ - хэш исходников всех стадий вместе со строками драйвера (vendor, renderer, version),
+ * поэтому обновление драйвера или правка шейдера просто дают промах.
+ * Поврежденный или отвергнутый драйвером файл удаляется, программа собирается из исходников.
+ */
+class ProgramBinaryCache
+{
+public:
+    // false - драйвер не поддерживает ни одного формата бинарников, кэш отключен
+    bool Initialize(const std::string& directory);
+
+    bool IsEnabled() const { return m_enabled; }
+
+    uint64_t MakeKey(std::initializer_list<std::string_view> sources) const;
+
+    // Слинкованная программа из кэша или 0 при промахе
+    GLuint Load(uint64_t key);
+    // Программа должна быть слинкована с GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    void Store(uint64_t key, GLuint program);
+
+private:
+    std::string GetEntryPath(uint64_t key) const;
+
+    bool        m_enabled    = false;
+    uint64_t    m_driverHash = 0;
+    std::string m_directory;
+};
+#endif // PROGRAMBINARYCACHE_H
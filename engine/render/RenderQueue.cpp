@@ -0,0 +1,411 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "RenderQueue.h"
+#include "Renderer.h"
+#include "../utils/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr uint64_t Bits(uint64_t value, uint32_t count) { return value & ((1ull << count) - 1); }
+
+    // Квантование глубины в count бит
+    uint64_t QuantizeDepth(float depth, float nearPlane, float farPlane, uint32_t count)
+    {
+        float range = std::max(farPlane - nearPlane, 1e-6f);
+        float t     = std::clamp((depth - nearPlane) / range, 0.0f, 1.0f);
+        return static_cast<uint64_t>(t * static_cast<float>((1ull << count) - 1));
+    }
+
+    // Размер индекса в байтах - firstIndex indirect команды отсчитывается в индексах, а не в байтах
+    uint32_t IndexSize(GLenum indexType)
+    {
+        switch (indexType)
+        {
+        case GL_UNSIGNED_BYTE: return 1;
+        case GL_UNSIGNED_SHORT: return 2;
+        default: return 4;
+        }
+    }
+} // namespace
+
+void RenderQueue::SetDepthRange(float nearPlane, float farPlane)
+{
+    m_nearPlane = nearPlane;
+    m_farPlane  = farPlane;
+}
+
+void RenderQueue::PushUniform(UniformId id, UniformType type, const void* data, uint32_t size)
+{
+    auto offset = static_cast<uint32_t>(m_uniformData.size());
+    m_uniformData.resize(offset + size);
+    std::memcpy(m_uniformData.data() + offset, data, size);
+    m_uniforms.push_back({id, type, offset});
+}
+
+void RenderQueue::DropPendingUniforms()
+{
+    if (m_uniforms.size() > m_pendingUniformFirst) { m_uniformData.resize(m_uniforms[m_pendingUniformFirst].offset); }
+    m_uniforms.resize(m_pendingUniformFirst);
+}
+
+void RenderQueue::AddUniform(UniformId id, GLint value) { PushUniform(id, UniformType::Int, &value, sizeof(value)); }
+
+void RenderQueue::AddUniform(UniformId id, GLfloat value)
+{
+    PushUniform(id, UniformType::Float, &value, sizeof(value));
+}
+
+void RenderQueue::AddUniform(UniformId id, const glm::vec2& value)
+{
+    PushUniform(id, UniformType::Vec2, &value, sizeof(value));
+}
+
+void RenderQueue::AddUniform(UniformId id, const glm::vec3& value)
+{
+    PushUniform(id, UniformType::Vec3, &value, sizeof(value));
+}
+
+void RenderQueue::AddUniform(UniformId id, const glm::vec4& value)
+{
+    PushUniform(id, UniformType::Vec4, &value, sizeof(value));
+}
+
+void RenderQueue::AddUniform(UniformId id, const glm::mat4& value)
+{
+    PushUniform(id, UniformType::Mat4, &value, sizeof(value));
+}
+
+void RenderQueue::Submit(const DrawPacket& packet)
+{
+    if (!packet.program || packet.vao == 0)
+    {
+        LOG_WARN("Draw packet without program or VAO was dropped");
+        DropPendingUniforms();
+        return;
+    }
+
+    DrawPacket& stored  = m_packets.emplace_back(packet);
+    stored.uniformFirst = m_pendingUniformFirst;
+    stored.uniformCount = static_cast<uint32_t>(m_uniforms.size()) - m_pendingUniformFirst;
+
+    m_pendingUniformFirst = static_cast<uint32_t>(m_uniforms.size());
+}
+
+void RenderQueue::Submit(const DrawPacket& packet, const DrawData& drawData, const DrawBounds& bounds)
+{
+    size_t packetCount = m_packets.size();
+    Submit(packet);
+    if (m_packets.size() == packetCount) { return; }
+
+    m_packets.back().drawDataIndex = static_cast<uint32_t>(m_drawData.size());
+    m_drawData.push_back(drawData);
+    m_drawBounds.push_back(bounds);
+}
+
+void RenderQueue::SubmitInstanced(const DrawPacket& packet, const InstanceData* instances, uint32_t instanceCount)
+{
+    if (instanceCount == 0)
+    {
+        DropPendingUniforms();
+        return;
+    }
+
+    size_t packetCount = m_packets.size();
+    Submit(packet);
+    if (m_packets.size() == packetCount) { return; }
+
+    DrawPacket& stored   = m_packets.back();
+    stored.instanceFirst = static_cast<uint32_t>(m_instances.size());
+    stored.instanceCount = instanceCount;
+    m_instances.insert(m_instances.end(), instances, instances + instanceCount);
+}
+
+uint64_t RenderQueue::EncodeKey(const DrawPacket& packet) const
+{
+    uint64_t key = Bits(packet.layer, 3) << 61;
+
+    uint64_t program = packet.program->GetID();
+    // Текстуры bindless материалов не привязываются - группировать по ним незачем
+    uint64_t texture = IsBindlessMaterial(packet) ? 0 : packet.textures[0];
+    uint64_t vao     = packet.vao;
+
+    if (!packet.transparent)
+    {
+        // Сначала группируем по состоянию, внутри группы - от ближних к дальним для раннего отсечения по глубине
+        key |= Bits(program, 14) << 46;
+        key |= Bits(texture, 14) << 32;
+        key |= Bits(vao, 12) << 20;
+        key |= QuantizeDepth(packet.depth, m_nearPlane, m_farPlane, 20);
+    }
+    else
+    {
+        // Для корректного смешивания порядок по глубине важнее смены состояния
+        uint64_t depth = Bits(~QuantizeDepth(packet.depth, m_nearPlane, m_farPlane, 24), 24);
+        key |= 1ull << 60;
+        key |= depth << 36;
+        key |= Bits(program, 12) << 24;
+        key |= Bits(texture, 12) << 12;
+        key |= Bits(vao, 12);
+    }
+
+    return key;
+}
+
+bool RenderQueue::IsBindlessMaterial(const DrawPacket& packet) const
+{
+    return m_bindless && packet.drawDataIndex != DrawPacket::NO_DRAW_DATA && packet.program->UsesDrawData()
+        && packet.program->UsesMaterials();
+}
+
+void RenderQueue::SortKeys()
+{
+    const size_t count = m_keys.size();
+    m_keysTmp.resize(count);
+    m_orderTmp.resize(count);
+
+    // Гистограммы всех 8 байтов за один проход
+    uint32_t histograms[8][256] = {};
+    for (uint64_t key : m_keys)
+    {
+        for (uint32_t pass = 0; pass < 8; ++pass) { ++histograms[pass][(key >> (pass * 8)) & 0xFF]; }
+    }
+
+    // LSD поразрядная сортировка по байтам, устойчивая - равные ключи сохраняют порядок отправки
+    for (uint32_t pass = 0; pass < 8; ++pass)
+    {
+        uint32_t* histogram = histograms[pass];
+        uint32_t  shift     = pass * 8;
+
+        // Все ключи совпадают в этом байте - проход ничего не изменит
+        if (histogram[(m_keys[0] >> shift) & 0xFF] == count) { continue; }
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < 256; ++bucket)
+        {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket]    = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t destination    = histogram[(m_keys[i] >> shift) & 0xFF]++;
+            m_keysTmp[destination]  = m_keys[i];
+            m_orderTmp[destination] = m_order[i];
+        }
+
+        m_keys.swap(m_keysTmp);
+        m_order.swap(m_orderTmp);
+    }
+}
+
+void RenderQueue::ApplyUniforms(const DrawPacket& packet)
+{
+    ShaderProgram& program = *packet.program;
+    for (uint32_t i = 0; i < packet.uniformCount; ++i)
+    {
+        const UniformWrite& write = m_uniforms[packet.uniformFirst + i];
+        const uint8_t*      data  = m_uniformData.data() + write.offset;
+
+        switch (write.type)
+        {
+        case UniformType::Int: program.SetInt(write.id, *reinterpret_cast<const GLint*>(data)); break;
+        case UniformType::Float: program.SetFloat(write.id, *reinterpret_cast<const GLfloat*>(data)); break;
+        case UniformType::Vec2: program.SetVec2(write.id, *reinterpret_cast<const glm::vec2*>(data)); break;
+        case UniformType::Vec3: program.SetVec3(write.id, *reinterpret_cast<const glm::vec3*>(data)); break;
+        case UniformType::Vec4: program.SetVec4(write.id, *reinterpret_cast<const glm::vec4*>(data)); break;
+        case UniformType::Mat4: program.SetMat4(write.id, *reinterpret_cast<const glm::mat4*>(data)); break;
+        }
+    }
+}
+
+size_t RenderQueue::CollectIndirectRun(size_t first) const
+{
+    const DrawPacket& head = m_packets[m_order[first]];
+    if (head.drawDataIndex == DrawPacket::NO_DRAW_DATA || head.instanceCount > 0 || !head.program->UsesDrawData())
+    {
+        return 1;
+    }
+
+    // Слить можно только пакеты без собственных uniform значений и с тем же состоянием.
+    // Текстуры bindless материалов читаются из MaterialBuffer и в состояние не входят
+    bool   bindless = IsBindlessMaterial(head);
+    size_t last     = first + 1;
+    while (last < m_order.size())
+    {
+        const DrawPacket& packet = m_packets[m_order[last]];
+        bool compatible = packet.drawDataIndex != DrawPacket::NO_DRAW_DATA && packet.instanceCount == 0
+                       && packet.uniformCount == 0 && packet.program == head.program && packet.vao == head.vao
+                       && (bindless || packet.textures == head.textures) && packet.mode == head.mode
+                       && packet.indexType == head.indexType && packet.transparent == head.transparent;
+        if (!compatible) { break; }
+        ++last;
+    }
+    return last - first;
+}
+
+void RenderQueue::ExecuteIndirectRun(Renderer& renderer, size_t first, size_t count)
+{
+    const DrawPacket& head      = m_packets[m_order[first]];
+    bool              materials = head.program->UsesMaterials();
+    bool              culled    = false;
+    uint32_t          indexSize = IndexSize(head.indexType);
+
+    m_indirectCommands.clear();
+    m_indirectData.clear();
+    m_indirectMaterials.clear();
+    m_indirectBounds.clear();
+
+    for (size_t i = first; i < first + count; ++i)
+    {
+        const DrawPacket& packet = m_packets[m_order[i]];
+        auto              index  = static_cast<GLuint>(m_indirectCommands.size());
+
+        DrawElementsIndirectCommand command{};
+        command.count         = static_cast<GLuint>(packet.indexCount);
+        command.instanceCount = 1;
+        command.firstIndex    = static_cast<GLuint>(packet.indexOffset / indexSize);
+        command.baseVertex    = packet.baseVertex;
+        command.baseInstance  = index; // Индекс данных отрисовки - сохраняется, когда GPU отсечение сжимает команды
+
+        m_indirectCommands.push_back(command);
+        m_indirectData.push_back(m_drawData[packet.drawDataIndex]);
+        if (m_gpuCulling)
+        {
+            const DrawBounds& bounds = m_drawBounds[packet.drawDataIndex];
+            m_indirectBounds.push_back(bounds);
+            culled = culled || bounds.IsCullable();
+        }
+
+        if (!materials) { continue; }
+
+        MaterialData& material = m_indirectMaterials.emplace_back();
+        for (uint32_t unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+        {
+            if (m_bindless) { material.textures[unit] = renderer.GetBindlessHandle(packet.textures[unit]); }
+            material.layers[static_cast<int>(unit)] = packet.layers[unit];
+        }
+    }
+
+    renderer.MultiDrawIndirect(head.mode,
+                               head.indexType,
+                               m_indirectCommands.data(),
+                               m_indirectData.data(),
+                               static_cast<uint32_t>(m_indirectCommands.size()),
+                               materials ? m_indirectMaterials.data() : nullptr,
+                               culled ? m_indirectBounds.data() : nullptr);
+}
+
+void RenderQueue::Execute(Renderer& renderer)
+{
+    m_stats      = {};
+    m_bindless   = renderer.SupportsBindlessTextures();
+    m_gpuCulling = renderer.IsGpuCullingEnabled();
+    if (m_packets.empty())
+    {
+        Clear();
+        return;
+    }
+
+    m_keys.resize(m_packets.size());
+    m_order.resize(m_packets.size());
+    for (size_t i = 0; i < m_packets.size(); ++i)
+    {
+        m_keys[i]  = EncodeKey(m_packets[i]);
+        m_order[i] = static_cast<uint32_t>(i);
+    }
+
+    SortKeys();
+
+    GLuint lastProgram = 0;
+    GLuint lastVAO     = 0;
+    bool   blending    = false;
+
+    for (size_t i = 0; i < m_order.size();)
+    {
+        const DrawPacket& packet = m_packets[m_order[i]];
+
+        // Прозрачные идут после всех непрозрачных внутри слоя
+        if (packet.transparent != blending)
+        {
+            blending = packet.transparent;
+            renderer.SetBlending(blending);
+            renderer.SetDepthWrite(!blending);
+        }
+
+        if (packet.program->GetID() != lastProgram)
+        {
+            lastProgram = packet.program->GetID();
+            renderer.UseProgram(lastProgram);
+            ++m_stats.programChanges;
+        }
+
+        if (packet.vao != lastVAO)
+        {
+            lastVAO = packet.vao;
+            renderer.BindVertexArray(lastVAO);
+            ++m_stats.vaoChanges;
+        }
+
+        for (GLuint unit = 0; unit < DrawPacket::MAX_TEXTURES && !IsBindlessMaterial(packet); ++unit)
+        {
+            if (packet.textures[unit] != 0) { renderer.BindTexture(unit, packet.textures[unit]); }
+        }
+
+        ApplyUniforms(packet);
+        ++m_stats.drawCalls;
+
+        size_t run = CollectIndirectRun(i);
+        if (packet.drawDataIndex != DrawPacket::NO_DRAW_DATA && packet.program->UsesDrawData())
+        {
+            ExecuteIndirectRun(renderer, i, run);
+        }
+        else if (packet.instanceCount > 0)
+        {
+            renderer.DrawInstanced(packet.vao,
+                                   packet.indexCount,
+                                   m_instances.data() + packet.instanceFirst,
+                                   static_cast<GLsizei>(packet.instanceCount),
+                                   packet.mode,
+                                   packet.indexType,
+                                   packet.indexOffset,
+                                   packet.baseVertex);
+        }
+        else
+        {
+            // Ошибки проверяются один раз на всю очередь в Renderer::FlushRenderQueue
+            glDrawElementsBaseVertex(packet.mode,
+                                     packet.indexCount,
+                                     packet.indexType,
+                                     reinterpret_cast<const void*>(packet.indexOffset),
+                                     packet.baseVertex);
+        }
+
+        i += run;
+    }
+
+    if (blending)
+    {
+        renderer.SetBlending(false);
+        renderer.SetDepthWrite(true);
+    }
+
+    m_stats.packets = static_cast<uint32_t>(m_packets.size());
+    Clear();
+}
+
+void RenderQueue::Clear()
+{
+    m_packets.clear();
+    m_uniforms.clear();
+    m_uniformData.clear();
+    m_instances.clear();
+    m_drawData.clear();
+    m_drawBounds.clear();
+    m_pendingUniformFirst = 0;
+}
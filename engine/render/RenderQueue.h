@@ -0,0 +1,152 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "IndirectDraw.h"
+#include "ShaderProgram.h"
+#include "VertexLayout.h"
+
+class Renderer;
+
+/**
+ * Легковесный пакет отрисовки - все, что нужно для одного glDrawElements
+ * Uniform значения пакета хранятся в общем буфере очереди и задаются через RenderQueue::AddUniform
+ */
+struct DrawPacket
+{
+    static constexpr uint32_t MAX_TEXTURES = MaterialData::MAX_TEXTURES;
+    static constexpr uint32_t NO_DRAW_DATA = ~0u;
+
+    ShaderProgram*                   program = nullptr;
+    GLuint                           vao     = 0;
+    std::array<GLuint, MAX_TEXTURES> textures{}; // Текстура на юните i, 0 - юнит не используется
+    std::array<float, MAX_TEXTURES>  layers{};   // Слой, если на юните массив текстур (программы с MaterialBuffer)
+
+    GLenum    mode        = GL_TRIANGLES;
+    GLsizei   indexCount  = 0;
+    GLenum    indexType   = GL_UNSIGNED_INT;
+    uintptr_t indexOffset = 0; // Смещение в байтах внутри EBO
+    GLint     baseVertex  = 0; // Смещение, добавляемое к каждому индексу
+
+    float   depth       = 0.0f;  // Расстояние до камеры по оси взгляда
+    bool    transparent = false; // Прозрачные рисуются после непрозрачных, от дальних к ближним
+    uint8_t layer       = 0;     // Слой отрисовки (0-7), старшие биты ключа
+
+    // Заполняется очередью при Submit/SubmitInstanced
+    uint32_t uniformFirst  = 0;
+    uint32_t uniformCount  = 0;
+    uint32_t instanceFirst = 0;
+    uint32_t instanceCount = 0; // 0 - обычная отрисовка, иначе glDrawElementsInstanced
+    uint32_t drawDataIndex = NO_DRAW_DATA;
+};
+
+/**
+ * Очередь команд отрисовки с сортировкой по 64-битному ключу
+ * Пакеты копятся за кадр, кодируются в ключи, сортируются поразрядной сортировкой
+ * так, чтобы минимизировать смену программ/текстур/VAO, и исполняются одним проходом.
+ *
+ * Раскладка ключа (от старших битов к младшим):
+ *   непрозрачные: [слой:3][0:1][программа:14][текстура:14][VAO:12][глубина:20, ближние первыми]
+ *   прозрачные:   [слой:3][1:1][глубина:24, дальние первыми][программа:12][текстура:12][VAO:12]
+ */
+class RenderQueue
+{
+public:
+    // Статистика исполнения за последний Execute
+    struct Stats
+    {
+        uint32_t packets        = 0;
+        uint32_t programChanges = 0;
+        uint32_t vaoChanges     = 0;
+        uint32_t drawCalls      = 0; // Реальные вызовы отрисовки после слияния indirect пакетов
+    };
+
+    // Диапазон глубин для квантования в ключе
+    void SetDepthRange(float nearPlane, float farPlane);
+
+    // Uniform значения для следующего Submit
+    void AddUniform(UniformId id, GLint value);
+    void AddUniform(UniformId id, GLfloat value);
+    void AddUniform(UniformId id, const glm::vec2& value);
+    void AddUniform(UniformId id, const glm::vec3& value);
+    void AddUniform(UniformId id, const glm::vec4& value);
+    void AddUniform(UniformId id, const glm::mat4& value);
+
+    void Submit(const DrawPacket& packet);
+    // Пакет с данными отрисовки для indirect пути. Подряд идущие после сортировки пакеты с одной программой,
+    // VAO и текстурами сливаются в один glMultiDrawElementsIndirect (программа должна читать DrawDataBuffer).
+    // Если программа читает MaterialBuffer, текстуры и слои пакета уходят в него: с bindless сливаются пакеты
+    // с любыми текстурами, без него - с одними массивами и разными слоями.
+    // bounds - локальный AABB для GPU отсечения (Renderer::EnableGpuCulling), по умолчанию отрисовка видима всегда
+    void Submit(const DrawPacket& packet, const DrawData& drawData, const DrawBounds& bounds = {});
+    // Пакет с экземплярами - данные копируются в очередь, VAO должен иметь раскладку InstanceData
+    void SubmitInstanced(const DrawPacket& packet, const InstanceData* instances, uint32_t instanceCount);
+
+    // Сортировка и исполнение всех пакетов кадра, после чего очередь очищается
+    void Execute(Renderer& renderer);
+    void Clear();
+
+    size_t       GetPacketCount() const { return m_packets.size(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    enum class UniformType : uint8_t { Int, Float, Vec2, Vec3, Vec4, Mat4 };
+
+    struct UniformWrite
+    {
+        UniformId   id;
+        UniformType type;
+        uint32_t    offset; // Смещение значения в m_uniformData
+    };
+
+    void     PushUniform(UniformId id, UniformType type, const void* data, uint32_t size);
+    // Откат uniform значений отброшенного пакета вместе с их данными
+    void     DropPendingUniforms();
+    void     ApplyUniforms(const DrawPacket& packet);
+    uint64_t EncodeKey(const DrawPacket& packet) const;
+    // Текстуры пакета передаются дескрипторами через MaterialBuffer, а не привязкой к юнитам
+    bool     IsBindlessMaterial(const DrawPacket& packet) const;
+    void     SortKeys();
+    // Количество пакетов начиная с first в m_order, которые можно слить в один indirect вызов
+    size_t   CollectIndirectRun(size_t first) const;
+    void     ExecuteIndirectRun(Renderer& renderer, size_t first, size_t count);
+
+    std::vector<DrawPacket>   m_packets;
+    std::vector<UniformWrite> m_uniforms;
+    std::vector<uint8_t>      m_uniformData;
+    std::vector<InstanceData> m_instances;
+    std::vector<DrawData>     m_drawData;
+    std::vector<DrawBounds>   m_drawBounds; // Параллельно m_drawData
+    uint32_t                  m_pendingUniformFirst = 0; // Начало uniform значений еще не отправленного пакета
+
+    // Ключи и индексы пакетов, плюс временные буферы поразрядной сортировки
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_order;
+    std::vector<uint64_t> m_keysTmp;
+    std::vector<uint32_t> m_orderTmp;
+
+    // Временные буферы сборки indirect вызова
+    std::vector<DrawElementsIndirectCommand> m_indirectCommands;
+    std::vector<DrawData>                    m_indirectData;
+    std::vector<MaterialData>                m_indirectMaterials;
+    std::vector<DrawBounds>                  m_indirectBounds;
+
+    float m_nearPlane  = 0.1f;
+    float m_farPlane   = 100.0f;
+    bool  m_bindless   = false; // Текстуры программ с MaterialBuffer не участвуют в ключе и слиянии
+    bool  m_gpuCulling = false; // Indirect вызовы с боксами отсекаются вычислительным шейдером
+    Stats m_stats;
+};
+#endif // RENDERQUEUE_H
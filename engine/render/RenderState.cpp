@@ -0,0 +1,197 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "RenderState.h"
+
+void RenderStateCache::Invalidate()
+{
+    m_program     = UNKNOWN;
+    m_vao         = UNKNOWN;
+    m_depthTest   = UNKNOWN;
+    m_depthWrite  = UNKNOWN;
+    m_blending    = UNKNOWN;
+    m_polygonMode = UNKNOWN;
+    m_buffers.fill(UNKNOWN);
+    m_textures.fill(UNKNOWN);
+    m_uniformBindings.fill({});
+    m_storageBindings.fill({});
+}
+
+int RenderStateCache::BufferSlot(GLenum target)
+{
+    switch (target)
+    {
+    case GL_ARRAY_BUFFER: return 0;
+    case GL_ELEMENT_ARRAY_BUFFER: return 1;
+    case GL_UNIFORM_BUFFER: return 2;
+    case GL_SHADER_STORAGE_BUFFER: return 3;
+    case GL_DRAW_INDIRECT_BUFFER: return 4;
+    case GL_PIXEL_UNPACK_BUFFER: return 5;
+    case GL_COPY_READ_BUFFER: return 6;
+    case GL_COPY_WRITE_BUFFER: return 7;
+    default: return -1;
+    }
+}
+
+void RenderStateCache::UseProgram(GLuint program)
+{
+    if (Track(m_program != program))
+    {
+        glUseProgram(program);
+        m_program = program;
+    }
+}
+
+void RenderStateCache::BindVertexArray(GLuint vao)
+{
+    if (Track(m_vao != vao))
+    {
+        glBindVertexArray(vao);
+        m_vao = vao;
+        // Привязка индексного буфера - часть состояния VAO
+        m_buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void RenderStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+    int slot = BufferSlot(target);
+    if (slot < 0)
+    {
+        Track(true);
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (Track(m_buffers[slot] != buffer))
+    {
+        glBindBuffer(target, buffer);
+        m_buffers[slot] = buffer;
+    }
+}
+
+void RenderStateCache::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    IndexedBinding* binding = nullptr;
+    if (index < MAX_INDEXED_BINDINGS)
+    {
+        if (target == GL_UNIFORM_BUFFER) { binding = &m_uniformBindings[index]; }
+        else if (target == GL_SHADER_STORAGE_BUFFER) { binding = &m_storageBindings[index]; }
+    }
+
+    bool changed = !binding || binding->buffer != buffer || binding->offset != offset || binding->size != size;
+    if (Track(changed))
+    {
+        glBindBufferRange(target, index, buffer, offset, size);
+        if (binding) { *binding = {buffer, offset, size}; }
+
+        int slot = BufferSlot(target);
+        if (slot >= 0) { m_buffers[slot] = buffer; }
+    }
+}
+
+void RenderStateCache::BindTexture(GLuint unit, GLuint texture)
+{
+    if (unit >= MAX_TEXTURE_UNITS)
+    {
+        Track(true);
+        glBindTextureUnit(unit, texture);
+        return;
+    }
+
+    // glBindTextureUnit (GL 4.5) не трогает glActiveTexture, поэтому активный юнит отслеживать не нужно
+    if (Track(m_textures[unit] != texture))
+    {
+        glBindTextureUnit(unit, texture);
+        m_textures[unit] = texture;
+    }
+}
+
+void RenderStateCache::SetDepthTest(bool enabled)
+{
+    GLuint value = enabled ? 1 : 0;
+    if (Track(m_depthTest != value))
+    {
+        if (enabled) { glEnable(GL_DEPTH_TEST); }
+        else { glDisable(GL_DEPTH_TEST); }
+        m_depthTest = value;
+    }
+}
+
+void RenderStateCache::SetDepthWrite(bool enabled)
+{
+    GLuint value = enabled ? 1 : 0;
+    if (Track(m_depthWrite != value))
+    {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        m_depthWrite = value;
+    }
+}
+
+void RenderStateCache::SetBlending(bool enabled)
+{
+    GLuint value = enabled ? 1 : 0;
+    if (Track(m_blending != value))
+    {
+        if (enabled)
+        {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        else { glDisable(GL_BLEND); }
+        m_blending = value;
+    }
+}
+
+void RenderStateCache::SetPolygonMode(GLenum mode)
+{
+    if (Track(m_polygonMode != mode))
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        m_polygonMode = mode;
+    }
+}
+
+void RenderStateCache::OnProgramDeleted(GLuint program)
+{
+    // Удаленная, но текущая программа остается активной до смены - сбрасываем, чтобы не спутать с новым именем
+    if (m_program == program) { m_program = UNKNOWN; }
+}
+
+void RenderStateCache::OnVertexArrayDeleted(GLuint vao)
+{
+    // Удаление привязанного VAO возвращает привязку к VAO 0, а с ней и индексный буфер, который мы не знаем.
+    // Без сброса следующая привязка IBO к VAO с тем же переиспользованным именем была бы пропущена
+    if (m_vao == vao)
+    {
+        m_vao                                          = 0;
+        m_buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void RenderStateCache::OnBufferDeleted(GLuint buffer)
+{
+    for (GLuint& bound : m_buffers)
+    {
+        if (bound == buffer) { bound = 0; }
+    }
+
+    for (IndexedBinding& binding : m_uniformBindings)
+    {
+        if (binding.buffer == buffer) { binding = {0, 0, 0}; }
+    }
+
+    for (IndexedBinding& binding : m_storageBindings)
+    {
+        if (binding.buffer == buffer) { binding = {0, 0, 0}; }
+    }
+}
+
+void RenderStateCache::OnTextureDeleted(GLuint texture)
+{
+    for (GLuint& bound : m_textures)
+    {
+        if (bound == texture) { bound = 0; }
+    }
+}
@@ -0,0 +1,97 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef RENDERSTATE_H
+#define RENDERSTATE_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+// Счетчики изменений состояния OpenGL
+struct RenderStateStats
+{
+    uint64_t issued = 0; // Вызовы, реально ушедшие в драйвер
+    uint64_t elided = 0; // Вызовы, отброшенные как избыточные
+};
+
+/**
+ * Теневая копия состояния OpenGL контекста
+ * Хранит последние выставленные программу, VAO, буферы, текстуры по юнитам и фиксированные режимы,
+ * и пропускает вызовы, которые не меняют состояние.
+ * Все привязки движка должны идти через этот кэш, иначе его нужно сбросить через Invalidate().
+ */
+class RenderStateCache
+{
+public:
+    static constexpr uint32_t MAX_TEXTURE_UNITS    = 32;
+    static constexpr uint32_t MAX_INDEXED_BINDINGS = 16;
+
+    RenderStateCache() { Invalidate(); }
+
+    // Сброс кэша - следующий вызов каждой функции гарантированно уйдет в драйвер
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindBuffer(GLenum target, GLuint buffer);
+    // Индексированная привязка UBO/SSBO (glBindBufferRange), также меняет общую привязку цели
+    void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void BindTexture(GLuint unit, GLuint texture);
+    void SetDepthTest(bool enabled);
+    void SetDepthWrite(bool enabled);
+    void SetBlending(bool enabled); // Классическое альфа-смешивание SRC_ALPHA / ONE_MINUS_SRC_ALPHA
+    void SetPolygonMode(GLenum mode);
+
+    // Удаленный объект мог остаться привязанным - GL сбрасывает такие привязки в 0
+    void OnProgramDeleted(GLuint program);
+    void OnVertexArrayDeleted(GLuint vao);
+    void OnBufferDeleted(GLuint buffer);
+    void OnTextureDeleted(GLuint texture);
+
+    // Текущая программа, ~0u после Invalidate
+    GLuint GetProgram() const { return m_program; }
+
+    const RenderStateStats& GetStats() const { return m_stats; }
+    void                    ResetStats() { m_stats = {}; }
+
+private:
+    static constexpr GLuint UNKNOWN = ~0u; // Состояние неизвестно (после Invalidate)
+
+    struct IndexedBinding
+    {
+        GLuint     buffer = UNKNOWN;
+        GLintptr   offset = 0;
+        GLsizeiptr size   = 0;
+    };
+
+    // Индекс целевой точки привязки буфера в m_buffers, -1 для неотслеживаемых
+    static int BufferSlot(GLenum target);
+
+    // Учет вызова в статистике, возвращает true если вызов нужно выполнить
+    bool Track(bool changed)
+    {
+        if (changed) { ++m_stats.issued; }
+        else { ++m_stats.elided; }
+        return changed;
+    }
+
+    GLuint                                m_program     = UNKNOWN;
+    GLuint                                m_vao         = UNKNOWN;
+    GLuint                                m_depthTest   = UNKNOWN;
+    GLuint                                m_depthWrite  = UNKNOWN;
+    GLuint                                m_blending    = UNKNOWN;
+    GLenum                                m_polygonMode = UNKNOWN;
+    std::array<GLuint, 8>                 m_buffers{};  // Привязки по отслеживаемым целям
+    std::array<GLuint, MAX_TEXTURE_UNITS> m_textures{}; // Текстура на каждом юните
+    RenderStateStats                      m_stats;
+
+    // Индексированные привязки UBO и SSBO
+    std::array<IndexedBinding, MAX_INDEXED_BINDINGS> m_uniformBindings{};
+    std::array<IndexedBinding, MAX_INDEXED_BINDINGS> m_storageBindings{};
+};
+#endif // RENDERSTATE_H
@@ -3,13 +3,15 @@
 //
 
 #include "Renderer.h"
+#include "ShaderProgram.h"
 #include "../utils/Logger.h"
 #include "GLFW/glfw3.h"
-#include "glm/gtc/type_ptr.hpp"
 
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
 
 Renderer::Renderer()
 {
@@ -25,7 +27,29 @@ bool Renderer::Initialize()
         return true;
     }
 
-    glEnable(GL_DEPTH_TEST);
+    // Состояние контекста до нас неизвестно - выставляем все отслеживаемое явно
+    m_state.Invalidate();
+    m_state.SetDepthTest(true);
+    m_state.SetDepthWrite(true);
+    m_state.SetBlending(false);
+    m_state.SetPolygonMode(GL_FILL);
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_uniformAlignment = std::max<GLintptr>(alignment, 16);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_storageAlignment = std::max<GLintptr>(alignment, 16);
+
+    if (!m_transient.Initialize(TRANSIENT_BYTES_PER_FRAME))
+    {
+        LOG_ERROR("Failed to create transient buffer");
+        return false;
+    }
+
+    // Без расширения рендер работает как раньше - материалы читают слои массивов текстур
+    m_bindless.Initialize();
+    // Выключено, пока приложение не передаст программу cull.comp
+    m_gpuCulling.Initialize(m_storageAlignment);
 
     CheckGLError("Renderer initialization");
 
@@ -39,9 +63,29 @@ void Renderer::Shutdown()
     if (!m_initialized) { return; }
 
     LOG_INFO("Shutting down Renderer");
+
+    m_staticBatcher.Clear(*this);
+    m_gpuCulling.Shutdown(m_state);
+    m_bindless.Shutdown();
+    m_transient.Shutdown();
     m_initialized = false;
 }
 
+void Renderer::BeginFrame()
+{
+    m_lastFrameStats = m_state.GetStats();
+    m_state.ResetStats();
+
+    m_transient.BeginFrame();
+    m_gpuCulling.BeginFrame();
+
+    auto time             = static_cast<float>(glfwGetTime());
+    m_frameData.deltaTime = m_frameData.time > 0.0f ? time - m_frameData.time : 0.0f;
+    m_frameData.time      = time;
+}
+
+void Renderer::EndFrame() { m_transient.EndFrame(); }
+
 void Renderer::Clear(const glm::vec4& clearColor)
 {
     glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
@@ -51,57 +95,146 @@ void Renderer::Clear(const glm::vec4& clearColor)
 void Renderer::SetViewport(int width, int height)
 {
     glViewport(0, 0, width, height);
+    m_viewportSize           = glm::ivec2(width, height);
+    m_frameData.viewportSize = glm::vec2(m_viewportSize);
     CheckGLError("SetViewport");
 }
 
+float Renderer::GetAspectRatio() const
+{
+    // Свернутое окно имеет нулевую высоту
+    if (m_viewportSize.y <= 0) { return 1.0f; }
+    return static_cast<float>(m_viewportSize.x) / static_cast<float>(m_viewportSize.y);
+}
+
+void Renderer::SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& position)
+{
+    m_frameData.view           = view;
+    m_frameData.projection     = projection;
+    m_frameData.viewProjection = projection * view;
+    m_frameData.cameraPosition = glm::vec4(position, 1.0f);
+}
+
+float Renderer::EstimateScreenSize(const glm::vec3& center, float radius) const
+{
+    float distance = glm::length(center - glm::vec3(m_frameData.cameraPosition));
+    // Камера внутри сферы - объект закрывает экран целиком
+    if (distance <= radius) { return static_cast<float>(std::max(m_viewportSize.x, m_viewportSize.y)); }
+
+    // projection[1][1] = 1 / tan(fov / 2): диаметр 2r на расстоянии d занимает r * p11 / d высоты экрана
+    return radius * m_frameData.projection[1][1] / distance * static_cast<float>(m_viewportSize.y);
+}
+
+void Renderer::UploadFrameData()
+{
+    TransientAllocation allocation = AllocTransient(sizeof(FrameData), m_uniformAlignment);
+    if (!allocation)
+    {
+        LOG_WARN("Transient buffer is full, frame data not uploaded");
+        return;
+    }
+
+    std::memcpy(allocation.data, &m_frameData, sizeof(FrameData));
+    m_state.BindBufferRange(GL_UNIFORM_BUFFER,
+                            FrameData::BINDING,
+                            allocation.buffer,
+                            allocation.offset,
+                            allocation.size);
+}
+
 void Renderer::SetWireframeMode(bool enabled)
 {
-    glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+    m_state.SetPolygonMode(enabled ? GL_LINE : GL_FILL);
     CheckGLError("SetWireframeMode");
 }
 
+void Renderer::SetDepthTest(bool enabled) { m_state.SetDepthTest(enabled); }
+
+void Renderer::SetDepthWrite(bool enabled) { m_state.SetDepthWrite(enabled); }
+
+void Renderer::SetBlending(bool enabled) { m_state.SetBlending(enabled); }
+
+void Renderer::UseProgram(GLuint program) { m_state.UseProgram(program); }
+
+void Renderer::BindVertexArray(GLuint vao) { m_state.BindVertexArray(vao); }
+
+void Renderer::BindBuffer(GLenum target, GLuint buffer) { m_state.BindBuffer(target, buffer); }
+
+void Renderer::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    m_state.BindBufferRange(target, index, buffer, offset, size);
+}
+
+void Renderer::BindTexture(GLuint unit, GLuint texture) { m_state.BindTexture(unit, texture); }
+
 // Объект меняет цвет с заданного на черный и обратно
-void Renderer::AnimateColorPulse(GLuint shaderProgram, const glm::vec3& baseColor, GLfloat speed)
+void Renderer::AnimateColorPulse(ShaderProgram& shaderProgram, const glm::vec3& baseColor, GLfloat speed)
 {
     GLfloat timeValue = glfwGetTime() * speed;
     GLfloat intensity = 0.5f * (1.0f + sin(timeValue * speed));
 
     glm::vec3 dynamicColor = baseColor * intensity;
-    GLint vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
-    glUniform4f(vertexColorLocation,
-                dynamicColor.r,
-                dynamicColor.g,
-                dynamicColor.b,
-                1.0f);
+    shaderProgram.SetVec4(UniformNames::OurColor, glm::vec4(dynamicColor, 1.0f));
 }
 
-void Renderer::SetShaderGradient(GLuint shaderProgram, const glm::vec3& colorStart, const glm::vec3& colorEnd,
+void Renderer::SetShaderGradient(ShaderProgram& shaderProgram, const glm::vec3& colorStart, const glm::vec3& colorEnd,
                                  float speed)
 {
-    GLint timeLocation = glGetUniformLocation(shaderProgram, "time");
-    GLint startLocation = glGetUniformLocation(shaderProgram, "colorStart");
-    GLint endLocation = glGetUniformLocation(shaderProgram, "colorEnd");
-
-    glUniform1f(timeLocation, glfwGetTime() * speed);
-    glUniform3f(startLocation, colorStart.r, colorStart.g, colorStart.b);
-    glUniform3f(endLocation, colorEnd.r, colorEnd.g, colorEnd.b);
+    shaderProgram.SetFloat(UniformNames::Time, glfwGetTime() * speed);
+    shaderProgram.SetVec3(UniformNames::ColorStart, colorStart);
+    shaderProgram.SetVec3(UniformNames::ColorEnd, colorEnd);
 }
 
 GLuint Renderer::CreateVAO()
 {
     GLuint VAO = 0;
-    glGenVertexArrays(1, &VAO);
+    glCreateVertexArrays(1, &VAO);
     CheckGLError("Create VAO");
     return VAO;
 }
 
+namespace
+{
+    // Настройка атрибутов раскладки на указанный binding VAO
+    void SetupVertexBinding(GLuint vao, GLuint binding, const VertexLayout& layout)
+    {
+        glVertexArrayBindingDivisor(vao, binding, layout.divisor);
+
+        for (const VertexAttribute& attribute : layout.attributes)
+        {
+            glEnableVertexArrayAttrib(vao, attribute.index);
+            glVertexArrayAttribFormat(vao,
+                                      attribute.index,
+                                      attribute.components,
+                                      attribute.type,
+                                      attribute.normalized,
+                                      attribute.offset);
+            glVertexArrayAttribBinding(vao, attribute.index, binding);
+        }
+    }
+} // namespace
+
+GLuint Renderer::CreateVAO(GLuint vbo, GLuint ebo, const VertexLayout& layout, const VertexLayout* instanceLayout)
+{
+    GLuint VAO = 0;
+    glCreateVertexArrays(1, &VAO);
+
+    glVertexArrayVertexBuffer(VAO, 0, vbo, 0, layout.stride);
+    if (ebo != 0) { glVertexArrayElementBuffer(VAO, ebo); }
+    SetupVertexBinding(VAO, 0, layout);
+
+    if (instanceLayout) { SetupVertexBinding(VAO, 1, *instanceLayout); }
+
+    CheckGLError("Create VAO with layout");
+    return VAO;
+}
+
+// Буферы создаются и заполняются через DSA (GL 4.5) - точки привязки и кэш состояния не затрагиваются
 GLuint Renderer::CreateVBO(const void* data, size_t size, GLenum usage)
 {
     GLuint VBO = 0;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, size, data, usage);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glCreateBuffers(1, &VBO);
+    glNamedBufferData(VBO, size, data, usage);
     CheckGLError("Create VBO");
     return VBO;
 }
@@ -109,36 +242,40 @@ GLuint Renderer::CreateVBO(const void* data, size_t size, GLenum usage)
 GLuint Renderer::CreateEBO(const void* data, size_t count, GLenum usage)
 {
     GLuint EBO = 0;
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, usage);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glCreateBuffers(1, &EBO);
+    glNamedBufferData(EBO, count * sizeof(GLuint), data, usage);
     CheckGLError("Create EBO");
     return EBO;
 }
 
-void Renderer::SetModelMatrix(GLuint shaderProgram, const glm::mat4& model)
+GLuint Renderer::CreateStorageBuffer(GLsizeiptr size, const void* data, GLbitfield flags)
 {
-    GLint modelLocation = glGetUniformLocation(shaderProgram, "model");
-    if (modelLocation != -1) { glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model)); }
+    GLuint buffer = 0;
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, size, data, flags);
+    CheckGLError("Create storage buffer");
+    return buffer;
+}
+
+void Renderer::SetModelMatrix(ShaderProgram& shaderProgram, const glm::mat4& model)
+{
+    shaderProgram.SetMat4(UniformNames::Model, model);
     CheckGLError("SetModelMatrix");
 }
 
-void Renderer::SetViewMatrix(GLuint shaderProgram, const glm::mat4& view)
+void Renderer::SetViewMatrix(ShaderProgram& shaderProgram, const glm::mat4& view)
 {
-    GLint viewLocation = glGetUniformLocation(shaderProgram, "view");
-    if (viewLocation != -1) { glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(view)); }
+    shaderProgram.SetMat4(UniformNames::View, view);
     CheckGLError("SetViewMatrix");
 }
 
-void Renderer::SetProjectionMatrix(GLuint shaderProgram, const glm::mat4& projection)
+void Renderer::SetProjectionMatrix(ShaderProgram& shaderProgram, const glm::mat4& projection)
 {
-    GLint projectionLocation = glGetUniformLocation(shaderProgram, "projection");
-    if (projectionLocation != -1) { glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection)); }
+    shaderProgram.SetMat4(UniformNames::Projection, projection);
     CheckGLError("SetProjectionMatrix");
 }
 
-void Renderer::SetMVPMatrices(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view,
+void Renderer::SetMVPMatrices(ShaderProgram& shaderProgram, const glm::mat4& model, const glm::mat4& view,
                               const glm::mat4& projection)
 {
     SetModelMatrix(shaderProgram, model);
@@ -149,21 +286,31 @@ void Renderer::SetMVPMatrices(GLuint shaderProgram, const glm::mat4& model, cons
 void Renderer::DeleteVAO(GLuint VAO)
 {
     glDeleteVertexArrays(1, &VAO);
+    m_state.OnVertexArrayDeleted(VAO);
     CheckGLError("Delete VAO");
 }
 
 void Renderer::DeleteVBO(GLuint VBO)
 {
     glDeleteBuffers(1, &VBO);
+    m_state.OnBufferDeleted(VBO);
     CheckGLError("Delete VBO");
 }
 
 void Renderer::DeleteEBO(GLuint EBO)
 {
     glDeleteBuffers(1, &EBO);
+    m_state.OnBufferDeleted(EBO);
     CheckGLError("Delete EBO");
 }
 
+void Renderer::DeleteStorageBuffer(GLuint buffer)
+{
+    glDeleteBuffers(1, &buffer);
+    m_state.OnBufferDeleted(buffer);
+    CheckGLError("Delete storage buffer");
+}
+
 void Renderer::DrawArrays(GLenum mode, GLint first, GLsizei count)
 {
     glDrawArrays(mode, first, count);
@@ -176,6 +323,191 @@ void Renderer::DrawElements(GLenum mode, GLsizei count, GLenum type, const void*
     CheckGLError("DrawElements");
 }
 
+TransientAllocation Renderer::AllocTransient(GLsizeiptr size, GLintptr alignment)
+{
+    return m_transient.Allocate(size, std::max<GLintptr>(alignment, 1));
+}
+
+GLsizeiptr Renderer::GetTransientBytesAvailable() const
+{
+    return m_transient.GetFrameCapacity() - m_transient.GetUsedBytes();
+}
+
+void Renderer::FlushRenderQueue()
+{
+    // Один блок на кадр вместо загрузки матриц в каждую программу
+    UploadFrameData();
+    m_staticBatcher.Rebuild(*this);
+    m_staticBatcher.Submit(m_renderQueue);
+    m_renderQueue.Execute(*this);
+    CheckGLError("FlushRenderQueue");
+}
+
+void Renderer::DrawInstanced(GLuint vao,
+                             GLsizei indexCount,
+                             const InstanceData* instances,
+                             GLsizei instanceCount,
+                             GLenum mode,
+                             GLenum indexType,
+                             uintptr_t indexOffset,
+                             GLint baseVertex)
+{
+    if (instanceCount <= 0) { return; }
+
+    auto size = static_cast<GLsizeiptr>(instanceCount * sizeof(InstanceData));
+
+    TransientAllocation allocation = AllocTransient(size, sizeof(InstanceData));
+    if (!allocation)
+    {
+        LOG_WARN("Transient buffer is full, {} instances skipped", instanceCount);
+        return;
+    }
+
+    std::memcpy(allocation.data, instances, size);
+    glVertexArrayVertexBuffer(vao, 1, allocation.buffer, allocation.offset, sizeof(InstanceData));
+
+    m_state.BindVertexArray(vao);
+    glDrawElementsInstancedBaseVertex(mode,
+                                      indexCount,
+                                      indexType,
+                                      reinterpret_cast<const void*>(indexOffset),
+                                      instanceCount,
+                                      baseVertex);
+}
+
+void Renderer::OnTextureDeleted(GLuint texture)
+{
+    m_bindless.OnTextureDeleted(texture);
+    m_state.OnTextureDeleted(texture);
+}
+
+bool Renderer::MultiDrawIndirect(GLenum mode,
+                                 GLenum indexType,
+                                 const DrawElementsIndirectCommand* commands,
+                                 const DrawData* drawData,
+                                 uint32_t count,
+                                 const MaterialData* materials,
+                                 const DrawBounds* bounds)
+{
+    if (count == 0) { return true; }
+
+    bool culled       = bounds && m_gpuCulling.IsEnabled();
+    auto commandSize  = static_cast<GLsizeiptr>(count * sizeof(DrawElementsIndirectCommand));
+    auto drawDataSize = static_cast<GLsizeiptr>(count * sizeof(DrawData));
+    auto materialSize = static_cast<GLsizeiptr>(materials ? count * sizeof(MaterialData) : 0);
+
+    // Данные отрисовок должны начинаться с выровненного для glBindBufferRange смещения.
+    // При GPU отсечении команды тоже читаются как SSBO
+    TransientAllocation commandBlock  = AllocTransient(commandSize, culled ? m_storageAlignment : sizeof(GLuint));
+    TransientAllocation drawDataBlock = AllocTransient(drawDataSize, m_storageAlignment);
+    TransientAllocation materialBlock;
+    TransientAllocation boundsBlock;
+    if (materials) { materialBlock = AllocTransient(materialSize, m_storageAlignment); }
+    if (culled) { boundsBlock = AllocTransient(count * sizeof(DrawBounds), m_storageAlignment); }
+    if (!commandBlock || !drawDataBlock || (materials && !materialBlock) || (culled && !boundsBlock))
+    {
+        LOG_WARN("Transient buffer is full, {} indirect draws skipped", count);
+        return false;
+    }
+
+    // Буфер отображен с GL_MAP_COHERENT_BIT - запись видна GPU без явного flush
+    std::memcpy(commandBlock.data, commands, commandSize);
+    std::memcpy(drawDataBlock.data, drawData, drawDataSize);
+
+    m_state.BindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                            DrawData::BINDING,
+                            drawDataBlock.buffer,
+                            drawDataBlock.offset,
+                            drawDataSize);
+    if (materials)
+    {
+        std::memcpy(materialBlock.data, materials, materialSize);
+        m_state.BindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                                MaterialData::BINDING,
+                                materialBlock.buffer,
+                                materialBlock.offset,
+                                materialSize);
+    }
+    if (culled)
+    {
+        std::memcpy(boundsBlock.data, bounds, boundsBlock.size);
+        return DrawCulled(mode, indexType, commandBlock, boundsBlock, count);
+    }
+    m_state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBlock.buffer);
+
+    glMultiDrawElementsIndirect(mode,
+                                indexType,
+                                reinterpret_cast<const void*>(commandBlock.offset),
+                                static_cast<GLsizei>(count),
+                                0);
+    return true;
+}
+
+bool Renderer::DrawCulled(GLenum mode,
+                          GLenum indexType,
+                          const TransientAllocation& commandBlock,
+                          const TransientAllocation& boundsBlock,
+                          uint32_t count)
+{
+    GpuCulling::Output output = m_gpuCulling.Reserve(count, m_state);
+    if (!output) { return false; }
+
+    m_state.BindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                            DrawBounds::BINDING,
+                            boundsBlock.buffer,
+                            boundsBlock.offset,
+                            boundsBlock.size);
+    m_state.BindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                            GpuCulling::INPUT_BINDING,
+                            commandBlock.buffer,
+                            commandBlock.offset,
+                            commandBlock.size);
+    m_state.BindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                            GpuCulling::OUTPUT_BINDING,
+                            output.commandBuffer,
+                            output.commandOffset,
+                            commandBlock.size);
+    m_state.BindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                            GpuCulling::COUNT_BINDING,
+                            output.countBuffer,
+                            output.countOffset,
+                            sizeof(GLuint));
+
+    // Счетчик обнуляется командой GL по порядку с остальными - CPU не ждет GPU ни здесь, ни при отрисовке
+    glClearNamedBufferSubData(output.countBuffer,
+                              GL_R32UI,
+                              output.countOffset,
+                              sizeof(GLuint),
+                              GL_RED_INTEGER,
+                              GL_UNSIGNED_INT,
+                              nullptr);
+
+    // Программу отрисовки привязала очередь - после прохода отсечения она возвращается
+    GLuint drawProgram = m_state.GetProgram();
+    Dispatch(*m_gpuCulling.GetProgram(), (count + GpuCulling::GROUP_SIZE - 1) / GpuCulling::GROUP_SIZE);
+    // Сжатые команды и счетчик читаются как параметры отрисовки - GL_COMMAND_BARRIER_BIT покрывает оба источника
+    IssueMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    m_state.UseProgram(drawProgram);
+
+    m_state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, output.commandBuffer);
+    m_state.BindBuffer(GL_PARAMETER_BUFFER, output.countBuffer);
+    glMultiDrawElementsIndirectCount(mode,
+                                     indexType,
+                                     reinterpret_cast<const void*>(output.commandOffset),
+                                     output.countOffset,
+                                     static_cast<GLsizei>(count),
+                                     0);
+    return true;
+}
+
+void Renderer::Dispatch(ShaderProgram& program, GLuint groupsX, GLuint groupsY, GLuint groupsZ)
+{
+    m_state.UseProgram(program.GetID());
+    glDispatchCompute(groupsX, groupsY, groupsZ);
+}
+
+void Renderer::IssueMemoryBarrier(GLbitfield barriers) { glMemoryBarrier(barriers); }
+
 void Renderer::CheckGLError(const std::string& operation)
 {
     GLenum error = glGetError();
@@ -12,6 +12,18 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "BindlessTextures.h"
+#include "FrameData.h"
+#include "GpuCulling.h"
+#include "IndirectDraw.h"
+#include "RenderQueue.h"
+#include "RenderState.h"
+#include "StaticBatcher.h"
+#include "TransientBuffer.h"
+#include "VertexLayout.h"
+
+class ShaderProgram;
+
 /**
  * Класс для управления OpenGL рендерингом
  * Абстрагирует низкоуровневые OpenGL вызовы и предоставляет удобный интерфейс
@@ -27,33 +39,73 @@ public:
     bool Initialize(); // Инициализация подсистемы рендеринга - настройка OpenGL состояния
     void Shutdown(); // Освобождение ресурсов рендеринга
 
+    // Начало нового кадра - фиксирует статистику изменений состояния за прошлый кадр
+    void BeginFrame();
+    // Конец кадра - после исполнения очереди, до SwapBuffers
+    void EndFrame();
+
     // Очистка экрана указанным цветом перед отрисовкой нового кадра
     void Clear(const glm::vec4& clearColor = glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
 
     // Установка области отрисовки
     // Нужно для изменения размера окна
     void SetViewport(int width, int height);
+    glm::ivec2 GetViewportSize() const { return m_viewportSize; }
+    // Соотношение сторон текущей области отрисовки - для построения проекции
+    float GetAspectRatio() const;
+
+    // Камера кадра - попадает в uniform блок FrameData, общий для всех программ
+    void SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& position);
+    const FrameData& GetFrameData() const { return m_frameData; }
+    // Размер сферы (center, radius) на экране в пикселях для камеры кадра - оценка для потоковой загрузки mip
+    float EstimateScreenSize(const glm::vec3& center, float radius) const;
     // Переключение между заливкой и Wireframe режимами отрисовки
     void SetWireframeMode(bool enabled);
+    void SetDepthTest(bool enabled);
+    void SetDepthWrite(bool enabled);
+    void SetBlending(bool enabled);
+
+    // Привязки через кэш состояния - повторная привязка того же объекта не уходит в драйвер
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void BindTexture(GLuint unit, GLuint texture);
+    // Сброс кэша, если кто-то менял состояние OpenGL в обход рендера
+    void InvalidateState() { m_state.Invalidate(); }
+
+    // Статистика вызовов: за прошлый кадр и накопленная за текущий
+    const RenderStateStats& GetLastFrameStateStats() const { return m_lastFrameStats; }
+    const RenderStateStats& GetStateStats() const { return m_state.GetStats(); }
 
     // Смена цвета объекта с заданного на черный и обратно
-    void AnimateColorPulse(GLuint shaderProgram, const glm::vec3& baseColor, float speed);
+    void AnimateColorPulse(ShaderProgram& shaderProgram, const glm::vec3& baseColor, float speed);
 
     // Смена цвета объекта градиентом
-    void SetShaderGradient(GLuint shaderProgram, const glm::vec3& colorStart, const glm::vec3& colorEnd, float speed);
+    void SetShaderGradient(ShaderProgram& shaderProgram,
+                           const glm::vec3& colorStart,
+                           const glm::vec3& colorEnd,
+                           float speed);
 
     // создание OpenGL объектов для управления данными вершин
     // Vertex Array Object - описание структуры вершин
     GLuint CreateVAO();
+    // VAO с готовой раскладкой: вершины из vbo (binding 0) и индексы из ebo
+    // Раскладка экземпляра (если задана) настраивается на binding 1 со своим divisor, буфер подставляет DrawInstanced
+    GLuint CreateVAO(GLuint vbo, GLuint ebo, const VertexLayout& layout, const VertexLayout* instanceLayout = nullptr);
     // Vertex Buffer Object - хранение вершин
     GLuint CreateVBO(const void* data, size_t size, GLenum usage = GL_STATIC_DRAW);
     // Element Buffer Object - хранение индекса вершин
     GLuint CreateEBO(const void* data, size_t count, GLenum usage = GL_STATIC_DRAW);
-
-    void SetModelMatrix(GLuint shaderProgram, const glm::mat4& model);
-    void SetViewMatrix(GLuint shaderProgram, const glm::mat4& view);
-    void SetProjectionMatrix(GLuint shaderProgram, const glm::mat4& projection);
-    void SetMVPMatrices(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view,
+    // Буфер неизменяемого размера для SSBO и вычислительных шейдеров, flags - флаги glNamedBufferStorage.
+    // Привязка к точке шейдера - BindBufferRange(GL_SHADER_STORAGE_BUFFER, ...)
+    GLuint CreateStorageBuffer(GLsizeiptr size, const void* data = nullptr, GLbitfield flags = GL_DYNAMIC_STORAGE_BIT);
+
+    // Загрузка матриц через закэшированные локации программы
+    void SetModelMatrix(ShaderProgram& shaderProgram, const glm::mat4& model);
+    void SetViewMatrix(ShaderProgram& shaderProgram, const glm::mat4& view);
+    void SetProjectionMatrix(ShaderProgram& shaderProgram, const glm::mat4& projection);
+    void SetMVPMatrices(ShaderProgram& shaderProgram, const glm::mat4& model, const glm::mat4& view,
                         const glm::mat4& projection);
 
     // Освобождение OpenGL объектов
@@ -61,16 +113,100 @@ public:
     void DeleteVAO(GLuint vao);
     void DeleteVBO(GLuint vbo);
     void DeleteEBO(GLuint ebo);
+    void DeleteStorageBuffer(GLuint buffer);
+    // Уведомления об удалении объектов, созданных вне рендера
+    void OnProgramDeleted(GLuint program) { m_state.OnProgramDeleted(program); }
+    // Текстуры - до glDeleteTextures, чтобы снять резидентность bindless дескриптора
+    void OnTextureDeleted(GLuint texture);
+
+    // Bindless текстуры (GL_ARB_bindless_texture). Без них программы с MaterialBuffer читают слои массивов текстур
+    bool     SupportsBindlessTextures() const { return m_bindless.IsSupported(); }
+    GLuint64 GetBindlessHandle(GLuint texture) { return m_bindless.GetHandle(texture); }
 
     // Команды отрисовки
     // Отрисовка по массиву вершин
     void DrawArrays(GLenum mode, GLint first, GLsizei count); // Отрисовка по индексам
     void DrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices = nullptr);
+    // Отрисовка instanceCount экземпляров за один вызов. Данные экземпляров копируются в потоковый буфер,
+    // VAO должен быть создан с InstanceData::Layout(). Программа и текстуры должны быть уже привязаны.
+    // indexOffset (в байтах) и baseVertex выбирают диапазон меша внутри общих EBO/VBO
+    void DrawInstanced(GLuint vao,
+                       GLsizei indexCount,
+                       const InstanceData* instances,
+                       GLsizei instanceCount,
+                       GLenum mode = GL_TRIANGLES,
+                       GLenum indexType = GL_UNSIGNED_INT,
+                       uintptr_t indexOffset = 0,
+                       GLint baseVertex = 0);
+    // Отрисовка count объектов одним glMultiDrawElementsIndirect. Команды и данные копируются в потоковый буфер,
+    // данные доступны шейдеру через SSBO DrawDataBuffer по gl_BaseInstance. Программа и VAO должны быть уже привязаны.
+    // materials (если заданы, count штук) попадают в SSBO MaterialBuffer. С bounds и включенным GPU отсечением
+    // невидимые команды отбрасывает cull.comp, а вызов идет через glMultiDrawElementsIndirectCount.
+    // indexType - общий тип индексов команд, их firstIndex отсчитывается в элементах этого типа
+    bool MultiDrawIndirect(GLenum mode,
+                           GLenum indexType,
+                           const DrawElementsIndirectCommand* commands,
+                           const DrawData* drawData,
+                           uint32_t count,
+                           const MaterialData* materials = nullptr,
+                           const DrawBounds* bounds = nullptr);
+
+    // Вычислительные шейдеры: программа привязывается через кэш состояния и остается текущей
+    void Dispatch(ShaderProgram& program, GLuint groupsX, GLuint groupsY = 1, GLuint groupsZ = 1);
+    // glMemoryBarrier - записи шейдеров в буферы и образы становятся видимы указанным потребителям
+    void IssueMemoryBarrier(GLbitfield barriers);
+
+    // GPU отсечение indirect отрисовок. program - cull.comp (ResourceManager::LoadComputeShader), nullptr выключает.
+    // Программа должна жить, пока отсечение включено
+    void EnableGpuCulling(ShaderProgram* program) { m_gpuCulling.SetProgram(program); }
+    bool IsGpuCullingEnabled() const { return m_gpuCulling.IsEnabled(); }
+    // Отрисовки, отправленные на GPU отсечение за текущий кадр
+    uint32_t GetGpuCulledCount() const { return m_gpuCulling.GetSubmittedCount(); }
+
+    // Память под данные текущего кадра в постоянно отображенном буфере - без glBufferSubData и переразметки.
+    // Действительна до конца кадра; data == nullptr, если бюджет кадра исчерпан
+    TransientAllocation AllocTransient(GLsizeiptr size, GLintptr alignment = 16);
+    // Свободно байт в области текущего кадра (без учета выравнивания)
+    GLsizeiptr GetTransientBytesAvailable() const;
+    // Требуемые выравнивания смещений для glBindBufferRange
+    GLintptr GetUniformBufferAlignment() const { return m_uniformAlignment; }
+    GLintptr GetStorageBufferAlignment() const { return m_storageAlignment; }
+
+    // Очередь отсортированных команд отрисовки текущего кадра
+    RenderQueue& GetRenderQueue() { return m_renderQueue; }
+    // Статическая геометрия, слитая в общие буферы. Измененные батчи пересобираются в FlushRenderQueue
+    StaticBatcher& GetStaticBatcher() { return m_staticBatcher; }
+    // Исполнение всех накопленных за кадр пакетов вместе с батчами статической геометрии
+    void FlushRenderQueue();
 
     // Проверка ошибок OpenGL для отладки
     void CheckGLError(const std::string& operation);
 
 private:
-    bool m_initialized = false; // Флаг успешной инициализации рендера
+    bool             m_initialized = false; // Флаг успешной инициализации рендера
+    RenderStateCache m_state;               // Теневая копия состояния OpenGL
+    RenderStateStats m_lastFrameStats;      // Статистика кэша за прошлый кадр
+    RenderQueue      m_renderQueue;         // Пакеты отрисовки текущего кадра
+    BindlessTextures m_bindless;            // Резидентные дескрипторы текстур
+    GpuCulling       m_gpuCulling;          // Выходные буферы cull.comp
+    StaticBatcher    m_staticBatcher;       // Батчи статической геометрии
+
+    // Проход cull.comp и glMultiDrawElementsIndirectCount по уже скопированным во временный буфер данным
+    bool DrawCulled(GLenum mode,
+                    GLenum indexType,
+                    const TransientAllocation& commandBlock,
+                    const TransientAllocation& boundsBlock,
+                    uint32_t count);
+
+    // Данные кадра копируются в потоковый буфер перед исполнением очереди
+    void       UploadFrameData();
+    FrameData  m_frameData;
+    glm::ivec2 m_viewportSize = glm::ivec2(0);
+
+    // Потоковые данные кадра: экземпляры, indirect команды, данные отрисовок
+    static constexpr GLsizeiptr TRANSIENT_BYTES_PER_FRAME = 8 * 1024 * 1024;
+    TransientBuffer             m_transient;
+    GLintptr                    m_uniformAlignment = 256;
+    GLintptr                    m_storageAlignment = 16;
 };
 #endif // RENDERER_H
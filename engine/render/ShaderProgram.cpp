@@ -0,0 +1,253 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "ShaderProgram.h"
+#include "FrameData.h"
+#include "IndirectDraw.h"
+#include "../utils/Logger.h"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    // Размер одного значения uniform переменной данного типа в байтах
+    uint32_t UniformTypeSize(GLenum type)
+    {
+        switch (type)
+        {
+        case GL_FLOAT_VEC2:
+        case GL_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_BOOL_VEC2: return 8;
+        case GL_FLOAT_VEC3:
+        case GL_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_BOOL_VEC3: return 12;
+        case GL_FLOAT_VEC4:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT_VEC4:
+        case GL_BOOL_VEC4:
+        case GL_FLOAT_MAT2: return 16;
+        case GL_FLOAT_MAT3: return 36;
+        case GL_FLOAT_MAT4: return 64;
+        default: return 4; // float, int, bool, uint и все типы сэмплеров/изображений
+        }
+    }
+} // namespace
+
+ShaderProgram::ShaderProgram(GLuint program) : m_id(program) { Reflect(); }
+
+void ShaderProgram::Reflect()
+{
+    m_uniforms.clear();
+    m_cache.clear();
+    m_usesDrawData     = false;
+    m_usesMaterials    = false;
+    m_usesFrameData    = false;
+    m_usesInstanceData = false;
+
+    if (m_id == 0) { return; }
+
+    // Общие блоки движка всегда привязываются к фиксированным точкам
+    GLuint frameDataBlock = glGetUniformBlockIndex(m_id, "FrameData");
+    if (frameDataBlock != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(m_id, frameDataBlock, FrameData::BINDING);
+        m_usesFrameData = true;
+    }
+
+    GLuint drawDataBlock = glGetProgramResourceIndex(m_id, GL_SHADER_STORAGE_BLOCK, "DrawDataBuffer");
+    if (drawDataBlock != GL_INVALID_INDEX)
+    {
+        glShaderStorageBlockBinding(m_id, drawDataBlock, DrawData::BINDING);
+        m_usesDrawData = true;
+    }
+
+    GLuint materialBlock = glGetProgramResourceIndex(m_id, GL_SHADER_STORAGE_BLOCK, "MaterialBuffer");
+    if (materialBlock != GL_INVALID_INDEX)
+    {
+        glShaderStorageBlockBinding(m_id, materialBlock, MaterialData::BINDING);
+        m_usesMaterials = true;
+    }
+
+    // Матрица экземпляра - первый атрибут раскладки InstanceData (instanced.vert)
+    m_usesInstanceData = glGetProgramResourceIndex(m_id, GL_PROGRAM_INPUT, "instanceModel") != GL_INVALID_INDEX;
+
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::string name(static_cast<size_t>(std::max(maxNameLength, 1)), '\0');
+    uint32_t    cacheSize = 0;
+
+    for (GLint i = 0; i < uniformCount; ++i)
+    {
+        GLsizei length    = 0;
+        GLint   arraySize = 0;
+        GLenum  type      = 0;
+        glGetActiveUniform(m_id, i, maxNameLength, &length, &arraySize, &type, name.data());
+
+        std::string_view uniformName(name.data(), static_cast<size_t>(length));
+        // Uniform из блоков не имеют location и обслуживаются через буферы
+        GLint location = glGetUniformLocation(m_id, name.c_str());
+        if (location == -1) { continue; }
+
+        // Массивы отдаются как "name[0]" - регистрируем по базовому имени
+        if (uniformName.ends_with("[0]")) { uniformName.remove_suffix(3); }
+
+        UniformSlot slot{};
+        slot.id          = HashUniformName(uniformName);
+        slot.location    = location;
+        slot.type        = type;
+        slot.cacheOffset = cacheSize;
+        slot.cacheSize   = UniformTypeSize(type);
+        slot.uploaded    = false;
+        cacheSize += slot.cacheSize;
+
+        m_uniforms.push_back(slot);
+    }
+
+    std::sort(m_uniforms.begin(), m_uniforms.end(), [](const UniformSlot& a, const UniformSlot& b) {
+        return a.id < b.id;
+    });
+
+    for (size_t i = 1; i < m_uniforms.size(); ++i)
+    {
+        if (m_uniforms[i].id == m_uniforms[i - 1].id)
+        {
+            LOG_WARN("Uniform name hash collision in program {} (locations {} and {})",
+                     m_id,
+                     m_uniforms[i - 1].location,
+                     m_uniforms[i].location);
+        }
+    }
+
+    m_cache.resize(cacheSize);
+    LOG_DEBUG("Program {} reflected: {} active uniforms", m_id, m_uniforms.size());
+}
+
+void ShaderProgram::RestoreUniforms(const ShaderProgram& previous)
+{
+    for (const UniformSlot& old : previous.m_uniforms)
+    {
+        if (!old.uploaded) { continue; }
+
+        const UniformSlot* target = FindSlot(old.id);
+        if (!target || target->type != old.type) { continue; }
+
+        const uint8_t* value = previous.m_cache.data() + old.cacheOffset;
+        UniformSlot*   slot  = PrepareUpload(old.id, value, old.cacheSize);
+        if (!slot) { continue; }
+
+        const auto* floats = reinterpret_cast<const GLfloat*>(value);
+        switch (slot->type)
+        {
+        case GL_FLOAT: glProgramUniform1fv(m_id, slot->location, 1, floats); break;
+        case GL_FLOAT_VEC2: glProgramUniform2fv(m_id, slot->location, 1, floats); break;
+        case GL_FLOAT_VEC3: glProgramUniform3fv(m_id, slot->location, 1, floats); break;
+        case GL_FLOAT_VEC4: glProgramUniform4fv(m_id, slot->location, 1, floats); break;
+        case GL_FLOAT_MAT4: glProgramUniformMatrix4fv(m_id, slot->location, 1, GL_FALSE, floats); break;
+        case GL_UNSIGNED_INT:
+            glProgramUniform1uiv(m_id, slot->location, 1, reinterpret_cast<const GLuint*>(value));
+            break;
+        default:
+            // int, bool и сэмплеры - остальные типы движок через сеттеры не загружает
+            if (slot->cacheSize == sizeof(GLint))
+            {
+                glProgramUniform1iv(m_id, slot->location, 1, reinterpret_cast<const GLint*>(value));
+            }
+            break;
+        }
+    }
+}
+
+GLint ShaderProgram::GetUniformLocation(UniformId id) const
+{
+    const UniformSlot* slot = FindSlot(id);
+    return slot ? slot->location : -1;
+}
+
+const ShaderProgram::UniformSlot* ShaderProgram::FindSlot(UniformId id) const
+{
+    auto it = std::lower_bound(m_uniforms.begin(), m_uniforms.end(), id, [](const UniformSlot& slot, UniformId value) {
+        return slot.id < value;
+    });
+    return (it != m_uniforms.end() && it->id == id) ? &*it : nullptr;
+}
+
+ShaderProgram::UniformSlot* ShaderProgram::PrepareUpload(UniformId id, const void* data, uint32_t size)
+{
+    auto* slot = const_cast<UniformSlot*>(FindSlot(id));
+    if (!slot) { return nullptr; }
+
+    if (slot->cacheSize != size)
+    {
+        LOG_ERROR("Uniform type mismatch in program {} (location {}): expected {} bytes, got {}",
+                  m_id,
+                  slot->location,
+                  slot->cacheSize,
+                  size);
+        return nullptr;
+    }
+
+    // Значение не изменилось - загрузка не нужна
+    uint8_t* cached = m_cache.data() + slot->cacheOffset;
+    if (slot->uploaded && std::memcmp(cached, data, size) == 0) { return nullptr; }
+
+    std::memcpy(cached, data, size);
+    slot->uploaded = true;
+    return slot;
+}
+
+void ShaderProgram::SetInt(UniformId id, GLint value)
+{
+    if (UniformSlot* slot = PrepareUpload(id, &value, sizeof(value)))
+    {
+        glProgramUniform1i(m_id, slot->location, value);
+    }
+}
+
+void ShaderProgram::SetFloat(UniformId id, GLfloat value)
+{
+    if (UniformSlot* slot = PrepareUpload(id, &value, sizeof(value)))
+    {
+        glProgramUniform1f(m_id, slot->location, value);
+    }
+}
+
+void ShaderProgram::SetVec2(UniformId id, const glm::vec2& value)
+{
+    if (UniformSlot* slot = PrepareUpload(id, glm::value_ptr(value), sizeof(GLfloat) * 2))
+    {
+        glProgramUniform2fv(m_id, slot->location, 1, glm::value_ptr(value));
+    }
+}
+
+void ShaderProgram::SetVec3(UniformId id, const glm::vec3& value)
+{
+    if (UniformSlot* slot = PrepareUpload(id, glm::value_ptr(value), sizeof(GLfloat) * 3))
+    {
+        glProgramUniform3fv(m_id, slot->location, 1, glm::value_ptr(value));
+    }
+}
+
+void ShaderProgram::SetVec4(UniformId id, const glm::vec4& value)
+{
+    if (UniformSlot* slot = PrepareUpload(id, glm::value_ptr(value), sizeof(GLfloat) * 4))
+    {
+        glProgramUniform4fv(m_id, slot->location, 1, glm::value_ptr(value));
+    }
+}
+
+void ShaderProgram::SetMat4(UniformId id, const glm::mat4& value)
+{
+    if (UniformSlot* slot = PrepareUpload(id, glm::value_ptr(value), sizeof(GLfloat) * 16))
+    {
+        glProgramUniformMatrix4fv(m_id, slot->location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef SHADERPROGRAM_H
+#define SHADERPROGRAM_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Идентификатор uniform переменной - FNV-1a хэш имени, вычисляемый на этапе компиляции
+using UniformId = uint32_t;
+
+constexpr UniformId HashUniformName(std::string_view name)
+{
+    UniformId hash = 2166136261u;
+    for (char c : name)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Имена uniform переменных, которые использует сам движок
+namespace UniformNames
+{
+    constexpr UniformId Model       = HashUniformName("model");
+    constexpr UniformId View        = HashUniformName("view");
+    constexpr UniformId Projection  = HashUniformName("projection");
+    constexpr UniformId Time        = HashUniformName("time");
+    constexpr UniformId ColorStart  = HashUniformName("colorStart");
+    constexpr UniformId ColorEnd    = HashUniformName("colorEnd");
+    constexpr UniformId OurColor    = HashUniformName("ourColor");
+    constexpr UniformId OurTexture1 = HashUniformName("ourTexture1");
+    constexpr UniformId OurTexture2 = HashUniformName("ourTexture2");
+    constexpr UniformId OurTextures = HashUniformName("ourTextures");
+} // namespace UniformNames
+
+/**
+ * Обертка над слинкованной шейдерной программой
+ * Один раз после линковки собирает таблицу активных uniform переменных (location, тип, размер),
+ * а типизированные сеттеры работают по заранее вычисленным локациям без glGetUniformLocation.
+ * Последнее загруженное значение кэшируется, повторная загрузка того же значения пропускается.
+ */
+class ShaderProgram
+{
+public:
+    ShaderProgram() = default;
+    explicit ShaderProgram(GLuint program);
+
+    // Повторное чтение активных uniform переменных из слинкованной программы
+    void Reflect();
+    // Перенос загруженных значений из предыдущей версии программы (горячая перезагрузка).
+    // Переносятся только uniform с тем же именем и типом
+    void RestoreUniforms(const ShaderProgram& previous);
+
+    GLuint GetID() const { return m_id; }
+    bool   IsValid() const { return m_id != 0; }
+    // Читает ли программа данные отрисовки из SSBO DrawDataBuffer по gl_BaseInstance (indirect путь)
+    bool UsesDrawData() const { return m_usesDrawData; }
+    // Читает ли программа текстуры отрисовки из SSBO MaterialBuffer - такие отрисовки сливаются в один indirect
+    // вызов и с разными текстурами (bindless) или слоями одного массива
+    bool UsesMaterials() const { return m_usesMaterials; }
+    // Читает ли программа общие данные кадра из uniform блока FrameData
+    bool UsesFrameData() const { return m_usesFrameData; }
+    // Читает ли программа атрибуты экземпляра (раскладка InstanceData) - такие отрисовки идут через SubmitInstanced
+    bool UsesInstanceData() const { return m_usesInstanceData; }
+
+    // Доступ к таблице uniform переменных
+    bool   HasUniform(UniformId id) const { return FindSlot(id) != nullptr; }
+    GLint  GetUniformLocation(UniformId id) const;
+    size_t GetUniformCount() const { return m_uniforms.size(); }
+
+    // Типизированные сеттеры - используют glProgramUniform*, поэтому не требуют glUseProgram
+    void SetInt(UniformId id, GLint value);
+    void SetFloat(UniformId id, GLfloat value);
+    void SetVec2(UniformId id, const glm::vec2& value);
+    void SetVec3(UniformId id, const glm::vec3& value);
+    void SetVec4(UniformId id, const glm::vec4& value);
+    void SetMat4(UniformId id, const glm::mat4& value);
+
+private:
+    struct UniformSlot
+    {
+        UniformId id;
+        GLint     location;
+        GLenum    type;
+        uint32_t  cacheOffset; // Смещение последнего значения в m_cache
+        uint32_t  cacheSize;   // Размер одного значения в байтах
+        bool      uploaded;    // Было ли значение загружено хотя бы раз
+    };
+
+    const UniformSlot* FindSlot(UniformId id) const;
+    // Возвращает слот, если значение отличается от закэшированного и его нужно загрузить
+    UniformSlot* PrepareUpload(UniformId id, const void* data, uint32_t size);
+
+    GLuint                   m_id               = 0;
+    bool                     m_usesDrawData     = false;
+    bool                     m_usesMaterials    = false;
+    bool                     m_usesFrameData    = false;
+    bool                     m_usesInstanceData = false;
+    std::vector<UniformSlot> m_uniforms; // Отсортирован по id для бинарного поиска
+    std::vector<uint8_t>     m_cache;    // Последние загруженные значения
+};
+#endif // SHADERPROGRAM_H
@@ -0,0 +1,123 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "ShaderVariants.h"
+#include "../utils/Logger.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    constexpr std::string_view FEATURES_PRAGMA = "#pragma features";
+} // namespace
+
+bool ShaderVariantSet::Initialize(const std::string& vertexSource, const std::string& fragmentSource)
+{
+    m_vertexSource   = vertexSource;
+    m_fragmentSource = fragmentSource;
+    m_features.clear();
+    m_variants.clear();
+
+    ParseFeatures(m_vertexSource);
+    ParseFeatures(m_fragmentSource);
+
+    if (m_features.size() > MAX_FEATURES)
+    {
+        LOG_ERROR("Shader declares {} feature keywords, at most {} are supported", m_features.size(), MAX_FEATURES);
+        m_features.clear();
+        m_validMask = 0;
+        return false;
+    }
+
+    m_validMask = m_features.size() == MAX_FEATURES ? ~0u : (1u << m_features.size()) - 1;
+    return true;
+}
+
+void ShaderVariantSet::ParseFeatures(const std::string& source)
+{
+    std::istringstream stream(source);
+    std::string        line;
+    while (std::getline(stream, line))
+    {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, FEATURES_PRAGMA.size(), FEATURES_PRAGMA) != 0)
+        {
+            continue;
+        }
+
+        // Одно слово, объявленное в обеих стадиях, получает один бит
+        std::istringstream keywords(line.substr(start + FEATURES_PRAGMA.size()));
+        std::string        keyword;
+        while (keywords >> keyword)
+        {
+            if (std::find(m_features.begin(), m_features.end(), keyword) == m_features.end())
+            {
+                m_features.push_back(keyword);
+            }
+        }
+    }
+}
+
+uint32_t ShaderVariantSet::GetFeatureBit(std::string_view feature) const
+{
+    for (size_t i = 0; i < m_features.size(); ++i)
+    {
+        if (m_features[i] == feature) { return 1u << i; }
+    }
+    return 0;
+}
+
+uint32_t ShaderVariantSet::MakeMask(std::initializer_list<std::string_view> features) const
+{
+    uint32_t mask = 0;
+    for (std::string_view feature : features)
+    {
+        uint32_t bit = GetFeatureBit(feature);
+        if (bit == 0) { LOG_WARN("Shader does not declare feature {}", feature); }
+        mask |= bit;
+    }
+    return mask;
+}
+
+std::string ShaderVariantSet::MakeVariantName(const std::string& baseName, uint32_t mask) const
+{
+    std::string name = baseName + "[";
+    for (size_t i = 0; i < m_features.size(); ++i)
+    {
+        if (!(mask & (1u << i))) { continue; }
+        if (name.back() != '[') { name += '+'; }
+        name += m_features[i];
+    }
+    return name + "]";
+}
+
+std::string ShaderVariantSet::InjectDefines(const std::string& source, uint32_t mask) const
+{
+    std::string defines;
+    for (size_t i = 0; i < m_features.size(); ++i)
+    {
+        if (mask & (1u << i)) { defines += "#define " + m_features[i] + " 1\n"; }
+    }
+    if (defines.empty()) { return source; }
+
+    // #version обязан быть первой директивой - определения идут сразу за его строкой
+    size_t version = source.find("#version");
+    if (version == std::string::npos) { return defines + source; }
+
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == std::string::npos) { return source + "\n" + defines; }
+
+    std::string result = source;
+    result.insert(lineEnd + 1, defines);
+    return result;
+}
+
+bool ShaderVariantSet::FindVariant(uint32_t mask, ShaderHandle& program) const
+{
+    auto it = m_variants.find(mask);
+    if (it == m_variants.end()) { return false; }
+    program = it->second;
+    return true;
+}
@@ -0,0 +1,60 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef SHADERVARIANTS_H
+#define SHADERVARIANTS_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/ResourceHandles.h"
+
+/**
+ * Набор вариантов одного шейдера
+ * Базовый исходник объявляет ключевые слова строкой "#pragma features TEXTURED VERTEX_COLOR" (в любой стадии),
+ * каждое слово получает свой бит. Вариант - исходник с "#define <слово> 1" сразу после #version
+ * для каждого установленного бита, поэтому ветвление решается препроцессором, а не в шейдере.
+ * Собранные программы кэшируются по маске как дескрипторы ResourceManager - набор держит по одной ссылке на каждую.
+ */
+class ShaderVariantSet
+{
+public:
+    static constexpr uint32_t MAX_FEATURES = 32;
+
+    // false - в исходниках больше MAX_FEATURES ключевых слов
+    bool Initialize(const std::string& vertexSource, const std::string& fragmentSource);
+
+    const std::vector<std::string>& GetFeatures() const { return m_features; }
+    // Бит ключевого слова или 0, если шейдер его не объявляет
+    uint32_t GetFeatureBit(std::string_view feature) const;
+    uint32_t MakeMask(std::initializer_list<std::string_view> features) const;
+    uint32_t GetValidMask() const { return m_validMask; }
+
+    std::string BuildVertexSource(uint32_t mask) const { return InjectDefines(m_vertexSource, mask); }
+    std::string BuildFragmentSource(uint32_t mask) const { return InjectDefines(m_fragmentSource, mask); }
+    // Имя программы варианта: base[TEXTURED+VERTEX_COLOR]
+    std::string MakeVariantName(const std::string& baseName, uint32_t mask) const;
+
+    // Кэш собранных вариантов. Пустой дескриптор в кэше - вариант не собрался, повторно не пробуем
+    bool FindVariant(uint32_t mask, ShaderHandle& program) const;
+    void StoreVariant(uint32_t mask, ShaderHandle program) { m_variants[mask] = program; }
+    const std::unordered_map<uint32_t, ShaderHandle>& GetVariants() const { return m_variants; }
+
+private:
+    void        ParseFeatures(const std::string& source);
+    std::string InjectDefines(const std::string& source, uint32_t mask) const;
+
+    std::string                                m_vertexSource;
+    std::string                                m_fragmentSource;
+    std::vector<std::string>                   m_features;
+    uint32_t                                   m_validMask = 0;
+    std::unordered_map<uint32_t, ShaderHandle> m_variants;
+};
+#endif // SHADERVARIANTS_H
@@ -0,0 +1,224 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "StaticBatcher.h"
+#include "Renderer.h"
+#include "ShaderProgram.h"
+#include "TransformManager.h"
+#include "../utils/Logger.h"
+#include "../utils/ResourceManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Применение матрицы к vec3 атрибуту внутри вершины
+    void TransformAttribute(uint8_t* vertex, GLuint offset, const glm::mat4& matrix, float w)
+    {
+        glm::vec3 value;
+        std::memcpy(&value, vertex + offset, sizeof(value));
+
+        glm::vec4 transformed = matrix * glm::vec4(value, w);
+        value                 = glm::vec3(transformed.x, transformed.y, transformed.z);
+        // Нормали после неравномерного масштаба нужно перенормировать
+        if (w == 0.0f && glm::dot(value, value) > 0.0f) { value = glm::normalize(value); }
+
+        std::memcpy(vertex + offset, &value, sizeof(value));
+    }
+} // namespace
+
+StaticMeshId StaticBatcher::Add(const StaticMeshDesc& desc)
+{
+    if (!desc.program || !desc.vertices || desc.vertexCount == 0 || !desc.indices || desc.indexCount == 0)
+    {
+        LOG_ERROR("Static mesh is missing program or geometry");
+        return 0;
+    }
+
+    // MaterialBuffer читается по индексу данных отрисовки - без DrawDataBuffer его слоям неоткуда взяться
+    if (desc.program->UsesMaterials() && !desc.program->UsesDrawData())
+    {
+        LOG_ERROR("Static mesh program reads MaterialBuffer without DrawDataBuffer");
+        return 0;
+    }
+
+    const VertexAttribute* position = desc.layout.Find(desc.positionAttribute);
+    if (!position || position->type != GL_FLOAT || position->components < 3)
+    {
+        LOG_ERROR("Static mesh layout has no float3 position at location {}", desc.positionAttribute);
+        return 0;
+    }
+
+    const VertexAttribute* normal = desc.normalAttribute >= 0 ? desc.layout.Find(desc.normalAttribute) : nullptr;
+
+    StaticMeshId id   = m_nextId++;
+    StoredMesh&  mesh = m_meshes[id];
+    mesh.batch        = FindOrCreateBatch(desc);
+
+    // Запекаем трансформацию в вершины один раз при добавлении
+    size_t stride = static_cast<size_t>(desc.layout.stride);
+    mesh.vertices.resize(stride * desc.vertexCount);
+    std::memcpy(mesh.vertices.data(), desc.vertices, mesh.vertices.size());
+
+    glm::mat4 model = TransformManager::CreateModelMatrix(desc.position, desc.rotation, desc.scale);
+    // Для нормалей нужна обратная транспонированная матрица
+    glm::mat4 normalMatrix = glm::transpose(glm::inverse(model));
+
+    for (size_t i = 0; i < desc.vertexCount; ++i)
+    {
+        uint8_t* vertex = mesh.vertices.data() + i * stride;
+        TransformAttribute(vertex, position->offset, model, 1.0f);
+        if (normal) { TransformAttribute(vertex, normal->offset, normalMatrix, 0.0f); }
+    }
+
+    mesh.indices.assign(desc.indices, desc.indices + desc.indexCount);
+
+    Batch& batch = m_batches[mesh.batch];
+    batch.members.push_back(id);
+    batch.dirty = true;
+    return id;
+}
+
+void StaticBatcher::Remove(StaticMeshId id)
+{
+    auto it = m_meshes.find(id);
+    if (it == m_meshes.end())
+    {
+        LOG_WARN("Static mesh {} not found for removal", id);
+        return;
+    }
+
+    Batch& batch  = m_batches[it->second.batch];
+    auto   member = std::find(batch.members.begin(), batch.members.end(), id);
+    if (member != batch.members.end())
+    {
+        batch.members.erase(member);
+        batch.dirty = true;
+    }
+
+    m_meshes.erase(it);
+}
+
+uint32_t StaticBatcher::FindOrCreateBatch(const StaticMeshDesc& desc)
+{
+    for (uint32_t i = 0; i < m_batches.size(); ++i)
+    {
+        const Batch& batch = m_batches[i];
+        if (batch.program == desc.program && batch.textures == desc.textures && batch.layout == desc.layout)
+        {
+            return i;
+        }
+    }
+
+    Batch& batch   = m_batches.emplace_back();
+    batch.program  = desc.program;
+    batch.textures = desc.textures;
+    batch.layout   = desc.layout;
+    return static_cast<uint32_t>(m_batches.size() - 1);
+}
+
+void StaticBatcher::Rebuild(Renderer& renderer)
+{
+    for (Batch& batch : m_batches)
+    {
+        if (!batch.dirty) { continue; }
+
+        ReleaseBatch(renderer, batch);
+        if (!batch.members.empty()) { BuildBatch(renderer, batch); }
+        batch.dirty = false;
+    }
+}
+
+void StaticBatcher::BuildBatch(Renderer& renderer, Batch& batch)
+{
+    size_t vertexBytes = 0;
+    size_t indexCount  = 0;
+    for (StaticMeshId id : batch.members)
+    {
+        const StoredMesh& mesh = m_meshes.at(id);
+        vertexBytes += mesh.vertices.size();
+        indexCount += mesh.indices.size();
+    }
+
+    std::vector<uint8_t> vertices;
+    std::vector<GLuint>  indices;
+    vertices.reserve(vertexBytes);
+    indices.reserve(indexCount);
+
+    // Индексы каждого меша сдвигаются на количество вершин перед ним
+    const size_t stride = static_cast<size_t>(batch.layout.stride);
+    for (StaticMeshId id : batch.members)
+    {
+        const StoredMesh& mesh       = m_meshes.at(id);
+        auto              baseVertex = static_cast<GLuint>(vertices.size() / stride);
+
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        for (GLuint index : mesh.indices) { indices.push_back(index + baseVertex); }
+    }
+
+    batch.vbo        = renderer.CreateVBO(vertices.data(), vertices.size());
+    batch.ebo        = renderer.CreateEBO(indices.data(), indices.size());
+    batch.vao        = renderer.CreateVAO(batch.vbo, batch.ebo, batch.layout);
+    batch.indexCount = static_cast<GLsizei>(indices.size());
+
+    LOG_DEBUG("Static batch rebuilt: {} meshes, {} vertices, {} indices",
+              batch.members.size(),
+              vertices.size() / stride,
+              indices.size());
+}
+
+void StaticBatcher::ReleaseBatch(Renderer& renderer, Batch& batch)
+{
+    if (batch.vao != 0) { renderer.DeleteVAO(batch.vao); }
+    if (batch.vbo != 0) { renderer.DeleteVBO(batch.vbo); }
+    if (batch.ebo != 0) { renderer.DeleteEBO(batch.ebo); }
+
+    batch.vao        = 0;
+    batch.vbo        = 0;
+    batch.ebo        = 0;
+    batch.indexCount = 0;
+}
+
+void StaticBatcher::Submit(RenderQueue& queue) const
+{
+    for (const Batch& batch : m_batches)
+    {
+        if (batch.indexCount == 0) { continue; }
+
+        DrawPacket packet;
+        packet.program    = batch.program;
+        packet.vao        = batch.vao;
+        packet.indexCount = batch.indexCount;
+        for (uint32_t unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+        {
+            TextureHandle texture = batch.textures[unit];
+            if (!texture) { continue; }
+
+            if (batch.program->UsesMaterials())
+            {
+                ResourceManager::TextureLayer resolved = RESOURCE_MANAGER.GetMaterialTexture(texture);
+                packet.textures[unit]                  = resolved.texture;
+                packet.layers[unit]                    = resolved.layer;
+            }
+            else { packet.textures[unit] = RESOURCE_MANAGER.GetTexture(texture); }
+        }
+
+        // Трансформация уже запечена в вершины. Программы с DrawDataBuffer идут indirect путем -
+        // только так слои текстур попадают в MaterialBuffer
+        if (batch.program->UsesDrawData()) { queue.Submit(packet, DrawData{}); }
+        else
+        {
+            queue.AddUniform(UniformNames::Model, glm::mat4(1.0f));
+            queue.Submit(packet);
+        }
+    }
+}
+
+void StaticBatcher::Clear(Renderer& renderer)
+{
+    for (Batch& batch : m_batches) { ReleaseBatch(renderer, batch); }
+    m_batches.clear();
+    m_meshes.clear();
+}
@@ -0,0 +1,107 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef STATICBATCHER_H
+#define STATICBATCHER_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "RenderQueue.h"
+#include "VertexLayout.h"
+#include "../utils/ResourceHandles.h"
+
+class Renderer;
+class ShaderProgram;
+
+// Описание статического меша для объединения в батч
+struct StaticMeshDesc
+{
+    const void*   vertices    = nullptr; // Interleaved вершины в раскладке layout
+    size_t        vertexCount = 0;
+    const GLuint* indices     = nullptr;
+    size_t        indexCount  = 0;
+
+    VertexLayout layout;
+    GLuint       positionAttribute = 0;  // location атрибута позиции (vec3, float)
+    GLint        normalAttribute   = -1; // location нормали (vec3, float), -1 если нормалей нет
+
+    // Текстуры разрешаются в объекты GL при каждой отправке - потоковые и перезагруженные подменяются сами.
+    // Программа с MaterialBuffer должна читать и DrawDataBuffer
+    ShaderProgram*                                      program = nullptr;
+    std::array<TextureHandle, DrawPacket::MAX_TEXTURES> textures{};
+
+    // Трансформация, которая запекается в вершины
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 rotation = glm::vec3(0.0f);
+    glm::vec3 scale    = glm::vec3(1.0f);
+};
+
+using StaticMeshId = uint32_t;
+
+/**
+ * Статический батчинг геометрии
+ * Меши с одинаковой программой, набором текстур и раскладкой вершин сливаются в общие VBO/EBO
+ * с уже примененной model матрицей и рисуются одним glDrawElements на батч.
+ * Батч пересобирается только при изменении состава (Add/Remove).
+ * Экземпляр принадлежит Renderer: пересборка и отправка батчей идут в FlushRenderQueue.
+ */
+class StaticBatcher
+{
+public:
+    StaticMeshId Add(const StaticMeshDesc& desc);
+
+    // Меш, не найденный по id, пропускается с предупреждением
+    void         Remove(StaticMeshId id);
+
+    // Пересборка измененных батчей - вызывается до Submit
+    void Rebuild(Renderer& renderer);
+    // Отправка всех батчей в очередь, model матрица пакета - единичная. Батчи программ с DrawDataBuffer
+    // отправляются с данными отрисовки (indirect путь), остальные - с uniform матрицей
+    void Submit(RenderQueue& queue) const;
+    // Освобождение всех GL ресурсов - должно быть вызвано до уничтожения рендера
+    void Clear(Renderer& renderer);
+
+    size_t GetBatchCount() const { return m_batches.size(); }
+    size_t GetMeshCount() const { return m_meshes.size(); }
+
+private:
+    struct StoredMesh
+    {
+        uint32_t             batch;    // Индекс батча в m_batches
+        std::vector<uint8_t> vertices; // Вершины с уже запеченной трансформацией
+        std::vector<GLuint>  indices;
+    };
+
+    struct Batch
+    {
+        ShaderProgram*                                      program = nullptr;
+        std::array<TextureHandle, DrawPacket::MAX_TEXTURES> textures{};
+        VertexLayout                                        layout;
+
+        std::vector<StaticMeshId> members;
+        bool                      dirty = true;
+
+        GLuint  vao        = 0;
+        GLuint  vbo        = 0;
+        GLuint  ebo        = 0;
+        GLsizei indexCount = 0;
+    };
+
+    uint32_t FindOrCreateBatch(const StaticMeshDesc& desc);
+    void     BuildBatch(Renderer& renderer, Batch& batch);
+    void     ReleaseBatch(Renderer& renderer, Batch& batch);
+
+    std::unordered_map<StaticMeshId, StoredMesh> m_meshes;
+    std::vector<Batch>                           m_batches;
+    StaticMeshId                                 m_nextId = 1;
+};
+#endif // STATICBATCHER_H
@@ -14,6 +14,7 @@
 class TransformManager
 {
 public:
+    // T * Rx * Ry * Rz * S, углы в градусах. Сцена считает те же матрицы пакетно (TransformKernels::ComposeLocal)
     static glm::mat4 CreateModelMatrix(const glm::vec3& position = glm::vec3(0.0f),
                                        const glm::vec3& rotation = glm::vec3(0.0f),
                                        const glm::vec3& scale = glm::vec3(1.0f));
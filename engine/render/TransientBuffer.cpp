@@ -0,0 +1,102 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "TransientBuffer.h"
+#include "../utils/Logger.h"
+
+bool TransientBuffer::Initialize(GLsizeiptr bytesPerFrame)
+{
+    m_regionSize = bytesPerFrame;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_buffer);
+    glNamedBufferStorage(m_buffer, m_regionSize * FRAME_COUNT, nullptr, flags);
+    m_mapped = static_cast<uint8_t*>(glMapNamedBufferRange(m_buffer, 0, m_regionSize * FRAME_COUNT, flags));
+
+    if (!m_mapped)
+    {
+        LOG_ERROR("Failed to map transient buffer");
+        Shutdown();
+        return false;
+    }
+
+    LOG_INFO("Transient buffer created: {} KB per frame, {} frames", m_regionSize / 1024, FRAME_COUNT);
+    return true;
+}
+
+void TransientBuffer::Shutdown()
+{
+    for (GLsync& fence : m_fences)
+    {
+        if (fence) { glDeleteSync(fence); }
+        fence = nullptr;
+    }
+
+    if (m_buffer != 0)
+    {
+        if (m_mapped) { glUnmapNamedBuffer(m_buffer); }
+        glDeleteBuffers(1, &m_buffer);
+    }
+
+    m_buffer = 0;
+    m_mapped = nullptr;
+}
+
+void TransientBuffer::BeginFrame()
+{
+    m_cursor = 0;
+
+    // GPU еще может читать эту область, записанную FRAME_COUNT кадров назад
+    GLsync& fence = m_fences[m_frame];
+    if (!fence) { return; }
+
+    // Таймаут не повод писать поверх данных, которые GPU еще читает - ожидание продолжается
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+    while (result == GL_TIMEOUT_EXPIRED)
+    {
+        LOG_WARN("Transient buffer region {} is still in use by the GPU after 1 s, waiting", m_frame);
+        result = glClientWaitSync(fence, 0, FENCE_TIMEOUT_NS);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    // Состояние области неизвестно - кадр обходится без нее: выделения вернут пустой результат,
+    // и вызывающие пойдут по обычному пути (загрузка без буфера или пропуск отрисовки)
+    if (result == GL_WAIT_FAILED)
+    {
+        LOG_ERROR("Transient buffer fence wait failed, region {} is skipped this frame", m_frame);
+        m_cursor = m_regionSize;
+    }
+}
+
+void TransientBuffer::EndFrame()
+{
+    if (!m_mapped) { return; }
+
+    // Fence нужен только если область реально использовалась
+    if (m_cursor > 0) { m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); }
+    m_frame = (m_frame + 1) % FRAME_COUNT;
+}
+
+TransientAllocation TransientBuffer::Allocate(GLsizeiptr size, GLintptr alignment)
+{
+    TransientAllocation allocation;
+    if (!m_mapped || size <= 0) { return allocation; }
+
+    GLintptr   region = m_regionSize * m_frame;
+    GLsizeiptr start  = (m_cursor + alignment - 1) / alignment * alignment;
+    if (start + size > m_regionSize)
+    {
+        LOG_WARN("Transient buffer exhausted: {} bytes requested, {} of {} used", size, m_cursor, m_regionSize);
+        return allocation;
+    }
+
+    allocation.data   = m_mapped + region + start;
+    allocation.buffer = m_buffer;
+    allocation.offset = region + start;
+    allocation.size   = size;
+
+    m_cursor = start + size;
+    return allocation;
+}
@@ -0,0 +1,62 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef TRANSIENTBUFFER_H
+#define TRANSIENTBUFFER_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+// Кусок потокового буфера, действительный до конца текущего кадра
+struct TransientAllocation
+{
+    void*      data   = nullptr; // Указатель для записи с CPU, nullptr если места не хватило
+    GLuint     buffer = 0;       // Буфер для привязки (VBO/UBO/SSBO/indirect)
+    GLintptr   offset = 0;       // Смещение внутри буфера
+    GLsizeiptr size   = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * Кольцевой буфер для потоковых данных кадра
+ * Один постоянно отображенный буфер (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT), разбитый на FRAME_COUNT областей.
+ * Выделение - сдвиг курсора внутри области текущего кадра, без вызовов OpenGL.
+ * В начале кадра ожидается fence области, поставленный FRAME_COUNT кадров назад.
+ */
+class TransientBuffer
+{
+public:
+    static constexpr uint32_t FRAME_COUNT = 3;
+
+    bool Initialize(GLsizeiptr bytesPerFrame);
+    void Shutdown();
+
+    // Ожидание освобождения области кадра GPU и сброс курсора
+    void BeginFrame();
+    // Fence на область кадра и переход к следующей
+    void EndFrame();
+
+    TransientAllocation Allocate(GLsizeiptr size, GLintptr alignment);
+
+    GLuint     GetBuffer() const { return m_buffer; }
+    GLsizeiptr GetUsedBytes() const { return m_cursor; }
+    GLsizeiptr GetFrameCapacity() const { return m_regionSize; }
+
+private:
+    static constexpr GLuint64 FENCE_TIMEOUT_NS = 1'000'000'000;
+
+    GLuint     m_buffer     = 0;
+    uint8_t*   m_mapped     = nullptr;
+    GLsizeiptr m_regionSize = 0;
+    GLsizeiptr m_cursor     = 0; // Занято байт в области текущего кадра
+    uint32_t   m_frame      = 0;
+
+    std::array<GLsync, FRAME_COUNT> m_fences{};
+};
+#endif // TRANSIENTBUFFER_H
@@ -0,0 +1,80 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Описание одного вершинного атрибута внутри interleaved буфера
+struct VertexAttribute
+{
+    GLuint    index;                   // layout (location = index) в шейдере
+    GLint     components;              // Количество компонент (1-4)
+    GLuint    offset;                  // Смещение от начала вершины в байтах
+    GLenum    type       = GL_FLOAT;
+    GLboolean normalized = GL_FALSE;
+
+    bool operator==(const VertexAttribute&) const = default;
+};
+
+/**
+ * Раскладка вершины в буфере - используется при создании VAO
+ */
+struct VertexLayout
+{
+    GLsizei                      stride  = 0; // Размер вершины в байтах
+    GLuint                       divisor = 0; // 0 - атрибуты на вершину, N - на каждые N экземпляров
+    std::vector<VertexAttribute> attributes;
+
+    bool operator==(const VertexLayout&) const = default;
+
+    // Поиск атрибута по location, nullptr если его нет
+    const VertexAttribute* Find(GLuint index) const
+    {
+        for (const VertexAttribute& attribute : attributes)
+        {
+            if (attribute.index == index) { return &attribute; }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * Данные одного экземпляра для инстансинга
+ * Занимают locations 3-8: model (3-6), цвет (7), слой текстуры (8)
+ */
+struct InstanceData
+{
+    static constexpr GLuint FIRST_LOCATION = 3;
+
+    glm::mat4 model        = glm::mat4(1.0f);
+    glm::vec4 color        = glm::vec4(1.0f);
+    float     textureLayer = 0.0f; // Слой массива текстур (ResourceManager::AcquireTextureLayer)
+    float     padding[3]   = {};   // Выравнивание до 16 байт
+
+    // Раскладка экземпляра для второго binding'а VAO (divisor = 1)
+    static VertexLayout Layout()
+    {
+        VertexLayout layout;
+        layout.stride  = sizeof(InstanceData);
+        layout.divisor = 1;
+        // mat4 занимает четыре подряд идущих location по столбцу на каждый
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            auto offset = static_cast<GLuint>(offsetof(InstanceData, model) + column * sizeof(glm::vec4));
+            layout.attributes.push_back({FIRST_LOCATION + column, 4, offset});
+        }
+        layout.attributes.push_back({FIRST_LOCATION + 4, 4, static_cast<GLuint>(offsetof(InstanceData, color))});
+        layout.attributes.push_back({FIRST_LOCATION + 5, 1, static_cast<GLuint>(offsetof(InstanceData, textureLayer))});
+        return layout;
+    }
+};
+#endif // VERTEXLAYOUT_H
@@ -0,0 +1,463 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "Bvh.h"
+#include "../utils/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace
+{
+    constexpr uint32_t MIN_LEAF_SIZE  = 2;    // Не больше - всегда лист
+    constexpr uint32_t MAX_LEAF_SIZE  = 8;    // Больше - всегда делится, даже если SAH против
+    constexpr uint32_t BIN_COUNT      = 16;
+    constexpr float    TRAVERSAL_COST = 1.0f; // Обход узла относительно проверки одного бокса
+
+    // Меньше этого числа объектов узел считается одним потоком
+    constexpr uint32_t PARALLEL_MIN_COUNT = 16384;
+    constexpr uint32_t CHUNK_MIN_SIZE     = 4096;
+    // Поддеревья не больше этого размера уходят пулу целиком
+    constexpr uint32_t SUBTREE_TASK_SIZE  = 8192;
+    // Глубже SAH уступает делению пополам: сущностей не больше 2^20, поэтому глубина дерева
+    // не превышает MAX_SAH_DEPTH + 20 и помещается в стек обхода
+    constexpr uint32_t MAX_SAH_DEPTH      = 32;
+
+    struct Bin
+    {
+        Aabb     bounds;
+        uint32_t count = 0;
+    };
+
+    using AxisBins = std::array<std::array<Bin, BIN_COUNT>, 3>;
+
+    struct BuildInput
+    {
+        const Aabb*      boxes;
+        const glm::vec3* centroids;
+        uint32_t*        order; // Перестановка объектов, узлы делят ее на диапазоны
+        ThreadPool*      pool;
+    };
+
+    struct RangeInfo
+    {
+        Aabb bounds;
+        Aabb centroidBounds;
+    };
+
+    // Поддерево, отданное пулу: строится в свои массивы с корнем 0, затем вклеивается на место узла
+    struct Subtree
+    {
+        uint32_t               node;
+        uint32_t               depth;
+        std::vector<Bvh::Node> nodes;
+        std::vector<uint32_t>  parents;
+    };
+
+    size_t ChunkCount(ThreadPool* pool, uint32_t count)
+    {
+        if (!pool || pool->GetThreadCount() == 0 || count < PARALLEL_MIN_COUNT) { return 1; }
+        return std::min<size_t>(pool->GetThreadCount() + 1, count / CHUNK_MIN_SIZE);
+    }
+
+    // f(begin, end, chunk) по кускам диапазона. Куски разбирают пул и главный поток (ThreadPool::ParallelFor)
+    template <typename F>
+    void RunChunks(ThreadPool* pool, uint32_t first, uint32_t count, size_t chunkCount, F&& f)
+    {
+        if (chunkCount <= 1)
+        {
+            f(first, first + count, size_t(0));
+            return;
+        }
+
+        auto chunkSize = static_cast<uint32_t>((count + chunkCount - 1) / chunkCount);
+        pool->ParallelFor(chunkCount, [&](size_t chunk) {
+            auto begin = static_cast<uint32_t>(first + chunk * chunkSize);
+            auto end   = static_cast<uint32_t>(first + std::min<size_t>(count, (chunk + 1) * chunkSize));
+            f(begin, end, chunk);
+        });
+    }
+
+    RangeInfo ComputeRange(const BuildInput& input, uint32_t first, uint32_t count)
+    {
+        size_t                 chunkCount = ChunkCount(input.pool, count);
+        std::vector<RangeInfo> chunks(chunkCount);
+        RunChunks(input.pool, first, count, chunkCount, [&](uint32_t begin, uint32_t end, size_t chunk) {
+            RangeInfo& info = chunks[chunk];
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                uint32_t object = input.order[i];
+                info.bounds.Grow(input.boxes[object]);
+                info.centroidBounds.Grow(input.centroids[object]);
+            }
+        });
+
+        RangeInfo info;
+        for (const RangeInfo& chunk : chunks)
+        {
+            info.bounds.Grow(chunk.bounds);
+            info.centroidBounds.Grow(chunk.centroidBounds);
+        }
+        return info;
+    }
+
+    struct BinMapping
+    {
+        glm::vec3 origin;
+        glm::vec3 scale; // 0 по оси без разброса центров - такая ось не делится
+
+        uint32_t BinOf(float value, int axis) const
+        {
+            auto bin = static_cast<int32_t>((value - origin[axis]) * scale[axis]);
+            return static_cast<uint32_t>(std::clamp(bin, 0, static_cast<int32_t>(BIN_COUNT - 1)));
+        }
+    };
+
+    /**
+     * Деление диапазона по SAH, возвращает начало правой половины
+     * first, если выгоднее оставить лист. Без разброса центров и на большой глубине - пополам по медиане
+     */
+    uint32_t Partition(const BuildInput& input, uint32_t first, uint32_t count, const RangeInfo& info, uint32_t depth)
+    {
+        glm::vec3 spread = info.centroidBounds.max - info.centroidBounds.min;
+        int       widest = spread.x >= spread.y && spread.x >= spread.z ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+        uint32_t* begin  = input.order + first;
+        uint32_t* end    = begin + count;
+        auto      median = [&] {
+            std::nth_element(begin, begin + count / 2, end, [&](uint32_t a, uint32_t b) {
+                return input.centroids[a][widest] < input.centroids[b][widest];
+            });
+            return first + count / 2;
+        };
+
+        if (spread[widest] <= 0.0f || depth >= MAX_SAH_DEPTH) { return median(); }
+
+        BinMapping mapping{info.centroidBounds.min, glm::vec3(0.0f)};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (spread[axis] > 0.0f) { mapping.scale[axis] = static_cast<float>(BIN_COUNT) / spread[axis]; }
+        }
+
+        // Корзины по всем трем осям за один проход, большие диапазоны - кусками на пуле
+        size_t                chunkCount = ChunkCount(input.pool, count);
+        std::vector<AxisBins> chunks(chunkCount);
+        RunChunks(input.pool, first, count, chunkCount, [&](uint32_t chunkBegin, uint32_t chunkEnd, size_t chunk) {
+            AxisBins& bins = chunks[chunk];
+            for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                uint32_t         object   = input.order[i];
+                const glm::vec3& centroid = input.centroids[object];
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    Bin& bin = bins[axis][mapping.BinOf(centroid[axis], axis)];
+                    bin.bounds.Grow(input.boxes[object]);
+                    ++bin.count;
+                }
+            }
+        });
+        AxisBins& bins = chunks[0];
+        for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (uint32_t i = 0; i < BIN_COUNT; ++i)
+                {
+                    bins[axis][i].bounds.Grow(chunks[chunk][axis][i].bounds);
+                    bins[axis][i].count += chunks[chunk][axis][i].count;
+                }
+            }
+        }
+
+        // Стоимость разреза после корзины i: площади и числа объектов слева и справа
+        float    bestCost = 0.0f;
+        int      bestAxis = -1;
+        uint32_t bestBin  = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (mapping.scale[axis] == 0.0f) { continue; }
+
+            std::array<float, BIN_COUNT>    rightArea{};
+            std::array<uint32_t, BIN_COUNT> rightCount{};
+            Aabb                            right;
+            uint32_t                        rightTotal = 0;
+            for (uint32_t i = BIN_COUNT - 1; i > 0; --i)
+            {
+                right.Grow(bins[axis][i].bounds);
+                rightTotal += bins[axis][i].count;
+                rightArea[i - 1]  = right.HalfArea();
+                rightCount[i - 1] = rightTotal;
+            }
+
+            Aabb     left;
+            uint32_t leftTotal = 0;
+            for (uint32_t i = 0; i + 1 < BIN_COUNT; ++i)
+            {
+                left.Grow(bins[axis][i].bounds);
+                leftTotal += bins[axis][i].count;
+                if (leftTotal == 0 || rightCount[i] == 0) { continue; }
+
+                float cost = left.HalfArea() * static_cast<float>(leftTotal)
+                           + rightArea[i] * static_cast<float>(rightCount[i]);
+                if (bestAxis < 0 || cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin  = i;
+                }
+            }
+        }
+        if (bestAxis < 0) { return median(); }
+
+        float area = info.bounds.HalfArea();
+        if (area > 0.0f)
+        {
+            float splitCost = TRAVERSAL_COST + bestCost / area;
+            if (splitCost >= static_cast<float>(count) && count <= MAX_LEAF_SIZE) { return first; }
+        }
+
+        uint32_t* middle = std::partition(begin, end, [&](uint32_t object) {
+            return mapping.BinOf(input.centroids[object][bestAxis], bestAxis) <= bestBin;
+        });
+        return first + static_cast<uint32_t>(middle - begin);
+    }
+
+    // Узлы диапазона [first, first + count) с корнем в конце nodes. С deferred небольшие поддеревья
+    // не строятся, а откладываются для пула - их узлы остаются листьями с посчитанными боксами
+    void BuildNodes(const BuildInput& input, uint32_t first, uint32_t count, uint32_t depth,
+                    std::vector<Bvh::Node>& nodes, std::vector<uint32_t>& parents, std::vector<Subtree>* deferred)
+    {
+        struct Task
+        {
+            uint32_t node;
+            uint32_t depth;
+        };
+
+        std::vector<Task> stack{{static_cast<uint32_t>(nodes.size()), depth}};
+        nodes.push_back({{}, first, count});
+        parents.push_back(Bvh::NO_NODE);
+
+        while (!stack.empty())
+        {
+            Task task = stack.back();
+            stack.pop_back();
+
+            uint32_t  begin         = nodes[task.node].first;
+            uint32_t  size          = nodes[task.node].count;
+            RangeInfo info          = ComputeRange(input, begin, size);
+            nodes[task.node].bounds = info.bounds;
+            if (size <= MIN_LEAF_SIZE) { continue; }
+            if (deferred && size <= SUBTREE_TASK_SIZE)
+            {
+                deferred->push_back({task.node, task.depth, {}, {}});
+                continue;
+            }
+
+            uint32_t middle = Partition(input, begin, size, info, task.depth);
+            if (middle == begin) { continue; }
+
+            auto left = static_cast<uint32_t>(nodes.size());
+            nodes.push_back({{}, begin, middle - begin});
+            nodes.push_back({{}, middle, begin + size - middle});
+            parents.push_back(task.node);
+            parents.push_back(task.node);
+            nodes[task.node].first = left;
+            nodes[task.node].count = 0;
+
+            stack.push_back({left + 1, task.depth + 1});
+            stack.push_back({left, task.depth + 1});
+        }
+    }
+} // namespace
+
+void Bvh::Build(const std::vector<Item>& items, ThreadPool* pool)
+{
+    Clear();
+    if (items.empty()) { return; }
+
+    const auto count = static_cast<uint32_t>(items.size());
+    std::vector<Aabb>      boxes(count);
+    std::vector<glm::vec3> centroids(count);
+    std::vector<uint32_t>  order(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        boxes[i]     = items[i].bounds;
+        centroids[i] = items[i].bounds.Center();
+    }
+    std::iota(order.begin(), order.end(), 0u);
+
+    // Верх дерева строится здесь с корзинами на пуле, поддеревья - целиком отдельными задачами
+    bool                 parallel = pool && pool->GetThreadCount() > 0 && count > SUBTREE_TASK_SIZE;
+    BuildInput           input{boxes.data(), centroids.data(), order.data(), parallel ? pool : nullptr};
+    std::vector<Subtree> subtrees;
+    m_nodes.reserve(count * 2 / MIN_LEAF_SIZE);
+    m_parents.reserve(m_nodes.capacity());
+    BuildNodes(input, 0, count, 0, m_nodes, m_parents, parallel ? &subtrees : nullptr);
+
+    if (!subtrees.empty())
+    {
+        // Задачи не трогают пул сами: поддеревья и так разбираются всеми потоками сразу
+        BuildInput local = input;
+        local.pool       = nullptr;
+        pool->ParallelFor(subtrees.size(), [this, &local, &subtrees](size_t i) {
+            Subtree&    subtree = subtrees[i];
+            const Node& root    = m_nodes[subtree.node];
+            BuildNodes(local, root.first, root.count, subtree.depth, subtree.nodes, subtree.parents, nullptr);
+        });
+
+        // Корень поддерева встает на место отложенного узла, остальные узлы дописываются в конец
+        for (Subtree& subtree : subtrees)
+        {
+            auto base  = static_cast<uint32_t>(m_nodes.size());
+            auto remap = [&](uint32_t node) { return node == 0 ? subtree.node : base + node - 1; };
+
+            for (size_t i = 0; i < subtree.nodes.size(); ++i)
+            {
+                Node node = subtree.nodes[i];
+                if (node.count == 0) { node.first = remap(node.first); }
+
+                if (i == 0) { m_nodes[subtree.node] = node; }
+                else
+                {
+                    m_nodes.push_back(node);
+                    m_parents.push_back(remap(subtree.parents[i]));
+                }
+            }
+        }
+    }
+
+    m_objects.resize(count);
+    m_bounds.resize(count);
+    m_leafOfObject.resize(count);
+    uint32_t maxIndex = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        m_objects[i] = items[order[i]].entity;
+        m_bounds[i]  = boxes[order[i]];
+        maxIndex     = std::max(maxIndex, m_objects[i].GetIndex());
+    }
+    for (uint32_t node = 0; node < m_nodes.size(); ++node)
+    {
+        const Node& leaf = m_nodes[node];
+        if (leaf.count == 0) { continue; }
+        std::fill_n(m_leafOfObject.begin() + leaf.first, leaf.count, node);
+    }
+
+    m_objectOfEntity.assign(maxIndex + 1, NO_NODE);
+    for (uint32_t i = 0; i < count; ++i) { m_objectOfEntity[m_objects[i].GetIndex()] = i; }
+}
+
+void Bvh::Clear()
+{
+    m_nodes.clear();
+    m_parents.clear();
+    m_objects.clear();
+    m_bounds.clear();
+    m_leafOfObject.clear();
+    m_objectOfEntity.clear();
+    m_dirtyLeaves.clear();
+    m_removedCount = 0;
+}
+
+uint32_t Bvh::ObjectOf(Entity entity) const
+{
+    uint32_t index = entity.GetIndex();
+    if (!entity || index >= m_objectOfEntity.size()) { return NO_NODE; }
+
+    uint32_t object = m_objectOfEntity[index];
+    return object != NO_NODE && m_objects[object] == entity ? object : NO_NODE;
+}
+
+bool Bvh::Remove(Entity entity)
+{
+    uint32_t object = ObjectOf(entity);
+    if (object == NO_NODE) { return false; }
+
+    m_objectOfEntity[entity.GetIndex()] = NO_NODE;
+    m_objects[object]                   = {};
+    m_bounds[object]                    = {};
+    m_dirtyLeaves.push_back(m_leafOfObject[object]);
+    ++m_removedCount;
+    return true;
+}
+
+bool Bvh::UpdateBounds(Entity entity, const Aabb& bounds)
+{
+    uint32_t object = ObjectOf(entity);
+    if (object == NO_NODE) { return false; }
+
+    m_bounds[object] = bounds;
+    m_dirtyLeaves.push_back(m_leafOfObject[object]);
+    return true;
+}
+
+void Bvh::Refit()
+{
+    for (uint32_t leaf : m_dirtyLeaves)
+    {
+        Aabb bounds;
+        for (uint32_t i = m_nodes[leaf].first; i < m_nodes[leaf].first + m_nodes[leaf].count; ++i)
+        {
+            bounds.Grow(m_bounds[i]);
+        }
+        m_nodes[leaf].bounds = bounds;
+
+        // Вверх, пока бокс узла меняется: выше неизменившегося узла пересчитывать нечего
+        for (uint32_t node = m_parents[leaf]; node != NO_NODE; node = m_parents[node])
+        {
+            Aabb merged = m_nodes[m_nodes[node].first].bounds;
+            merged.Grow(m_nodes[m_nodes[node].first + 1].bounds);
+            if (merged == m_nodes[node].bounds) { break; }
+            m_nodes[node].bounds = merged;
+        }
+    }
+    m_dirtyLeaves.clear();
+}
+
+bool Bvh::Raycast(const Ray& ray, float maxDistance, Entity& entity, float& distance) const
+{
+    if (m_nodes.empty()) { return false; }
+
+    bool     hit     = false;
+    float    nearest = maxDistance;
+    uint32_t stack[STACK_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const Node& node = m_nodes[stack[--top]];
+        float       enter;
+        // Повторная проверка: ближайшее попадание могло найтись после того, как узел попал в стек
+        if (!IntersectRay(ray, node.bounds, nearest, enter)) { continue; }
+
+        if (node.count > 0)
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                if (!IntersectRay(ray, m_bounds[i], nearest, enter)) { continue; }
+                nearest = enter;
+                entity  = m_objects[i];
+                hit     = true;
+            }
+            continue;
+        }
+
+        // Ближний ребенок кладется последним и обходится первым - дальний чаще отбрасывается
+        float leftEnter, rightEnter;
+        bool  left  = IntersectRay(ray, m_nodes[node.first].bounds, nearest, leftEnter);
+        bool  right = IntersectRay(ray, m_nodes[node.first + 1].bounds, nearest, rightEnter);
+        if (left && right)
+        {
+            bool leftFirst = leftEnter <= rightEnter;
+            stack[top++]   = leftFirst ? node.first + 1 : node.first;
+            stack[top++]   = leftFirst ? node.first : node.first + 1;
+        }
+        else if (left) { stack[top++] = node.first; }
+        else if (right) { stack[top++] = node.first + 1; }
+    }
+
+    if (hit) { distance = nearest; }
+    return hit;
+}
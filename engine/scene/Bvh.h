@@ -0,0 +1,132 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef BVH_H
+#define BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Entity.h"
+#include "Geometry.h"
+
+class ThreadPool;
+
+/**
+ * Иерархия ограничивающих объемов для статических объектов
+ * Строится по SAH (surface area heuristic) с разбиением центров по корзинам: на каждом узле выбирается
+ * ось и плоскость с наименьшей ожидаемой стоимостью обхода. Большие узлы считают корзины на пуле потоков,
+ * небольшие поддеревья строятся отдельными задачами. Узлы лежат плоским массивом, дети узла - соседняя пара,
+ * объекты листа - непрерывный диапазон. Сдвинутые объекты не перестраивают дерево: UpdateBounds помечает
+ * лист, Refit расширяет или сжимает боксы только на пути от помеченных листьев к корню.
+ */
+class Bvh
+{
+public:
+    static constexpr uint32_t NO_NODE = ~0u;
+
+    struct Item
+    {
+        Entity entity;
+        Aabb   bounds;
+    };
+
+    // count == 0 - внутренний узел, дети first и first + 1. Иначе лист с объектами [first, first + count)
+    struct Node
+    {
+        Aabb     bounds;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    // Полная перестройка. Сущности вне items перестают находиться
+    void Build(const std::vector<Item>& items, ThreadPool* pool = nullptr);
+    void Clear();
+
+    bool Contains(Entity entity) const { return ObjectOf(entity) != NO_NODE; }
+    // Объект остается в листе с пустым боксом до следующего Build
+    bool Remove(Entity entity);
+    // Новый бокс учитывается в запросах сразу, боксы узлов - после Refit
+    bool UpdateBounds(Entity entity, const Aabb& bounds);
+    void Refit();
+
+    // f(Entity, const Aabb&) для объектов, чей бокс пересекает пирамиду или бокс
+    template <typename F>
+    void QueryFrustum(const Frustum& frustum, F&& f) const
+    {
+        auto test = [&](const Aabb& box) { return Intersects(frustum, box); };
+        Traverse(test, test, f);
+    }
+
+    template <typename F>
+    void QueryAabb(const Aabb& bounds, F&& f) const
+    {
+        auto test = [&](const Aabb& box) { return box.Intersects(bounds); };
+        Traverse(test, test, f);
+    }
+
+    // Все объекты узлов, пересекающих пирамиду, без проверки самих объектов - для пакетной проверки
+    // в FrustumCuller: дерево отбрасывает невидимые ветки, а отдельные боксы проверяются векторно
+    template <typename F>
+    void CollectFrustumCandidates(const Frustum& frustum, F&& f) const
+    {
+        Traverse([&](const Aabb& box) { return Intersects(frustum, box); },
+                 [](const Aabb& box) { return !box.IsEmpty(); },
+                 f);
+    }
+
+    // Ближайший бокс на луче в пределах maxDistance: дети обходятся от ближнего, дальние узлы отбрасываются
+    bool Raycast(const Ray& ray, float maxDistance, Entity& entity, float& distance) const;
+
+    size_t GetObjectCount() const { return m_objects.size() - m_removedCount; }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+
+    const std::vector<Node>& GetNodes() const { return m_nodes; }
+
+private:
+    // Глубина дерева ограничена построением (см. Bvh.cpp) - стек обхода фиксированный
+    static constexpr uint32_t STACK_SIZE         = 64;
+
+    uint32_t ObjectOf(Entity entity) const;
+
+    template <typename NodeTest, typename ObjectTest, typename F>
+    void Traverse(NodeTest&& nodeTest, ObjectTest&& objectTest, F& f) const
+    {
+        if (m_nodes.empty()) { return; }
+
+        uint32_t stack[STACK_SIZE];
+        uint32_t top   = 0;
+        stack[top++]   = 0;
+        while (top > 0)
+        {
+            const Node& node = m_nodes[stack[--top]];
+            if (!nodeTest(node.bounds)) { continue; }
+
+            if (node.count == 0)
+            {
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+                continue;
+            }
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                if (objectTest(m_bounds[i])) { f(m_objects[i], m_bounds[i]); }
+            }
+        }
+    }
+
+    std::vector<Node>     m_nodes;
+    std::vector<uint32_t> m_parents;
+    std::vector<Entity>   m_objects; // Объекты в порядке листьев, пустая сущность - удален
+    std::vector<Aabb>     m_bounds;
+    std::vector<uint32_t> m_leafOfObject;
+
+    std::vector<uint32_t> m_objectOfEntity; // Индекс сущности -> позиция объекта
+    std::vector<uint32_t> m_dirtyLeaves;
+    size_t                m_removedCount = 0;
+};
+#endif // BVH_H
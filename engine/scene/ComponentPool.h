@@ -0,0 +1,146 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef COMPONENTPOOL_H
+#define COMPONENTPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Entity.h"
+
+// Порядковый номер типа компонента - бит в ComponentMask и индекс пула в сцене
+constexpr uint32_t MAX_COMPONENT_TYPES = 64;
+
+inline uint32_t NextComponentTypeId()
+{
+    static uint32_t next = 0;
+    return next++;
+}
+
+template <typename T>
+uint32_t ComponentTypeId()
+{
+    static const uint32_t id = NextComponentTypeId();
+    return id;
+}
+
+/**
+ * Разреженное множество сущностей: sparse переводит индекс сущности в позицию в плотных массивах,
+ * плотные массивы хранят сущности и их компоненты подряд без дыр.
+ * Общая часть не зависит от типа компонента - через нее сцена удаляет компоненты уничтожаемой сущности
+ */
+class ComponentPoolBase
+{
+public:
+    static constexpr uint32_t INVALID = ~0u;
+
+    virtual ~ComponentPoolBase() = default;
+
+    // Позиция компонента сущности в плотном массиве, INVALID если его нет
+    uint32_t IndexOf(Entity entity) const
+    {
+        uint32_t index = entity.GetIndex();
+        if (index >= m_sparse.size()) { return INVALID; }
+
+        uint32_t dense = m_sparse[index];
+        return dense != INVALID && m_entities[dense] == entity ? dense : INVALID;
+    }
+
+    bool          Contains(Entity entity) const { return IndexOf(entity) != INVALID; }
+    size_t        Size() const { return m_entities.size(); }
+    const Entity* Entities() const { return m_entities.data(); }
+
+    virtual bool Remove(Entity entity) = 0;
+    virtual void Clear()               = 0;
+
+protected:
+    // Новая позиция в плотных массивах, компонент кладет наследник
+    uint32_t Append(Entity entity)
+    {
+        uint32_t index = entity.GetIndex();
+        if (index >= m_sparse.size()) { m_sparse.resize(index + 1, INVALID); }
+
+        auto dense      = static_cast<uint32_t>(m_entities.size());
+        m_sparse[index] = dense;
+        m_entities.push_back(entity);
+        return dense;
+    }
+
+    // Последняя сущность переносится на место удаленной - массивы остаются плотными
+    void SwapRemove(uint32_t dense)
+    {
+        uint32_t last = static_cast<uint32_t>(m_entities.size() - 1);
+
+        m_sparse[m_entities[dense].GetIndex()] = INVALID;
+        if (dense != last)
+        {
+            m_entities[dense]                      = m_entities[last];
+            m_sparse[m_entities[dense].GetIndex()] = dense;
+        }
+        m_entities.pop_back();
+    }
+
+    std::vector<uint32_t> m_sparse;   // Индекс сущности -> позиция, INVALID - компонента нет
+    std::vector<Entity>   m_entities; // Владелец компонента на каждой позиции
+};
+
+/**
+ * Компоненты одного типа подряд в памяти - система, обходящая пул, читает непрерывный массив
+ * Адреса компонентов меняются при добавлении и удалении, хранить нужно сущность
+ */
+template <typename T>
+class ComponentPool final : public ComponentPoolBase
+{
+public:
+    // Существующий компонент перезаписывается
+    T& Add(Entity entity, T component)
+    {
+        uint32_t dense = IndexOf(entity);
+        if (dense != INVALID)
+        {
+            m_components[dense] = std::move(component);
+            return m_components[dense];
+        }
+
+        Append(entity);
+        return m_components.emplace_back(std::move(component));
+    }
+
+    T* Get(Entity entity)
+    {
+        uint32_t dense = IndexOf(entity);
+        return dense != INVALID ? &m_components[dense] : nullptr;
+    }
+
+    bool Remove(Entity entity) override
+    {
+        uint32_t dense = IndexOf(entity);
+        if (dense == INVALID) { return false; }
+
+        if (dense != m_components.size() - 1) { m_components[dense] = std::move(m_components.back()); }
+        m_components.pop_back();
+        SwapRemove(dense);
+        return true;
+    }
+
+    void Clear() override
+    {
+        m_sparse.clear();
+        m_entities.clear();
+        m_components.clear();
+    }
+
+    T*       Data() { return m_components.data(); }
+    const T* Data() const { return m_components.data(); }
+    T&       At(size_t dense) { return m_components[dense]; }
+
+private:
+    std::vector<T> m_components;
+};
+#endif // COMPONENTPOOL_H
@@ -0,0 +1,65 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "../render/RenderQueue.h"
+#include "../utils/ResourceHandles.h"
+
+// Локальное преобразование, углы Эйлера в градусах (как в TransformManager::CreateModelMatrix)
+struct Transform
+{
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 rotation = glm::vec3(0.0f);
+    glm::vec3 scale    = glm::vec3(1.0f);
+};
+
+// Матрица модели с учетом родителей, пересчитывается Scene::UpdateTransforms из Transform
+struct WorldTransform
+{
+    glm::mat4 matrix = glm::mat4(1.0f);
+};
+
+// Диапазон индексов внутри VAO - то, что попадает в DrawPacket
+struct MeshComponent
+{
+    GLuint    vao         = 0;
+    GLsizei   indexCount  = 0;
+    GLenum    mode        = GL_TRIANGLES;
+    GLenum    indexType   = GL_UNSIGNED_INT;
+    uintptr_t indexOffset = 0; // Смещение в байтах внутри EBO
+    GLint     baseVertex  = 0;
+};
+
+// Дескрипторы не владеющие - ссылки на программу и текстуры держит тот, кто их загрузил
+struct MaterialComponent
+{
+    ShaderHandle                                        shader;
+    std::array<TextureHandle, DrawPacket::MAX_TEXTURES> textures{}; // Текстура юнита i, пустая - не используется
+    glm::vec4                                           color       = glm::vec4(1.0f);
+    bool                                                transparent = false;
+    uint8_t                                             layer       = 0; // Слой отрисовки (DrawPacket::layer)
+};
+
+// Локальный AABB: центр и половины размеров. По нему оценивается размер на экране для потоковых текстур
+struct Bounds
+{
+    glm::vec3 center  = glm::vec3(0.0f);
+    glm::vec3 extents = glm::vec3(0.0f);
+};
+
+// Сущность не двигается: Scene::RebuildStaticIndex переносит ее из октодерева в BVH
+struct StaticObject
+{
+};
+#endif // COMPONENTS_H
@@ -0,0 +1,23 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include <cstdint>
+
+#include "../utils/SlotMap.h"
+
+/**
+ * Сущность сцены - только дескриптор, все данные лежат в пулах компонентов
+ * Индекс дескриптора адресует разреженные массивы пулов, поколение отсекает уничтоженные сущности
+ */
+struct EntityTag;
+using Entity = Handle<EntityTag>;
+
+// Набор типов компонентов сущности, бит на тип (см. ComponentTypeId)
+using ComponentMask = uint64_t;
+#endif // ENTITY_H
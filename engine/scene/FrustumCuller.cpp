@@ -0,0 +1,193 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "FrustumCuller.h"
+#include "../utils/SimdMath.h"
+#include "../utils/ThreadPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    // Плоскость вместе с модулями нормали - модули дают проекцию половин размеров бокса на нормаль
+    struct CullPlane
+    {
+        float nx, ny, nz, d;
+        float ax, ay, az;
+    };
+
+    void PreparePlanes(const Frustum& frustum, CullPlane (&planes)[6])
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            const glm::vec4& p = frustum.planes[i];
+            planes[i]          = {p.x, p.y, p.z, p.w, std::fabs(p.x), std::fabs(p.y), std::fabs(p.z)};
+        }
+    }
+
+    // Бокс снаружи, если целиком за какой-то плоскостью: dot(n, c) + d < -(|n| . e)
+    bool IsVisible(const CullPlane (&planes)[6], float cx, float cy, float cz, float ex, float ey, float ez)
+    {
+        for (const CullPlane& plane : planes)
+        {
+            float distance = plane.nx * cx + plane.ny * cy + plane.nz * cz + plane.d;
+            float radius   = plane.ax * ex + plane.ay * ey + plane.az * ez;
+            if (distance + radius < 0.0f) { return false; }
+        }
+        return true;
+    }
+} // namespace
+
+void FrustumCuller::Clear()
+{
+    m_entities.clear();
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+    m_visible.clear();
+}
+
+void FrustumCuller::Reserve(size_t count)
+{
+    m_entities.reserve(count);
+    m_centerX.reserve(count);
+    m_centerY.reserve(count);
+    m_centerZ.reserve(count);
+    m_extentX.reserve(count);
+    m_extentY.reserve(count);
+    m_extentZ.reserve(count);
+}
+
+void FrustumCuller::Add(Entity entity, const Aabb& box)
+{
+    glm::vec3 center  = box.Center();
+    glm::vec3 extents = box.Extents();
+
+    m_entities.push_back(entity);
+    m_centerX.push_back(center.x);
+    m_centerY.push_back(center.y);
+    m_centerZ.push_back(center.z);
+    m_extentX.push_back(extents.x);
+    m_extentY.push_back(extents.y);
+    m_extentZ.push_back(extents.z);
+}
+
+float FrustumCuller::GetRadius(uint32_t index) const
+{
+    return glm::length(glm::vec3(m_extentX[index], m_extentY[index], m_extentZ[index]));
+}
+
+void FrustumCuller::CullRange(const Frustum& frustum, size_t first, size_t last, std::vector<uint32_t>& visible) const
+{
+    CullPlane planes[6];
+    PreparePlanes(frustum, planes);
+
+    const float* cx = m_centerX.data();
+    const float* cy = m_centerY.data();
+    const float* cz = m_centerZ.data();
+    const float* ex = m_extentX.data();
+    const float* ey = m_extentY.data();
+    const float* ez = m_extentZ.data();
+
+    size_t i = first;
+#if defined(YAGL_SIMD_AVX)
+    const __m256 zero8 = _mm256_setzero_ps();
+    for (; i + 8 <= last; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(cx + i), y = _mm256_loadu_ps(cy + i), z = _mm256_loadu_ps(cz + i);
+        __m256 w = _mm256_loadu_ps(ex + i), h = _mm256_loadu_ps(ey + i), d = _mm256_loadu_ps(ez + i);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const CullPlane& plane : planes)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.nx)),
+                                                          _mm256_mul_ps(y, _mm256_set1_ps(plane.ny))),
+                                            _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.nz)),
+                                                          _mm256_set1_ps(plane.d)));
+            __m256 radius   = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w, _mm256_set1_ps(plane.ax)),
+                                                        _mm256_mul_ps(h, _mm256_set1_ps(plane.ay))),
+                                          _mm256_mul_ps(d, _mm256_set1_ps(plane.az)));
+            inside          = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero8, _CMP_GE_OQ));
+        }
+
+        for (int mask = _mm256_movemask_ps(inside); mask != 0; mask &= mask - 1)
+        {
+            visible.push_back(static_cast<uint32_t>(i + std::countr_zero(static_cast<unsigned>(mask))));
+        }
+    }
+#endif
+#if defined(YAGL_SIMD_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= last; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(cx + i), y = _mm_loadu_ps(cy + i), z = _mm_loadu_ps(cz + i);
+        __m128 w = _mm_loadu_ps(ex + i), h = _mm_loadu_ps(ey + i), d = _mm_loadu_ps(ez + i);
+
+        // Все дорожки внутри, пока какая-то плоскость не отбросит бокс
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const CullPlane& plane : planes)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.nx)),
+                                                    _mm_mul_ps(y, _mm_set1_ps(plane.ny))),
+                                         _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.nz)), _mm_set1_ps(plane.d)));
+            __m128 radius   = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w, _mm_set1_ps(plane.ax)),
+                                                  _mm_mul_ps(h, _mm_set1_ps(plane.ay))),
+                                       _mm_mul_ps(d, _mm_set1_ps(plane.az)));
+            inside          = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        for (int mask = _mm_movemask_ps(inside); mask != 0; mask &= mask - 1)
+        {
+            visible.push_back(static_cast<uint32_t>(i + std::countr_zero(static_cast<unsigned>(mask))));
+        }
+    }
+#endif
+    for (; i < last; ++i)
+    {
+        if (IsVisible(planes, cx[i], cy[i], cz[i], ex[i], ey[i], ez[i]))
+        {
+            visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+const std::vector<uint32_t>& FrustumCuller::Cull(const Frustum& frustum, ThreadPool* pool)
+{
+    const size_t count = m_entities.size();
+    m_visible.clear();
+
+    if (!pool || count < PARALLEL_MIN_COUNT || pool->GetThreadCount() == 0)
+    {
+        CullRange(frustum, 0, count, m_visible);
+    }
+    else
+    {
+        // Куски кратны 8, чтобы векторный путь не уходил в скалярный хвост посередине массива.
+        // Главный поток разбирает куски вместе с пулом и не ждет задач, стоящих в очереди за чужими
+        size_t chunkCount = std::min<size_t>(pool->GetThreadCount() + 1, count / CHUNK_MIN_SIZE);
+        size_t chunkSize  = ((count + chunkCount - 1) / chunkCount + 7) & ~size_t(7);
+        chunkCount        = (count + chunkSize - 1) / chunkSize;
+
+        m_chunkVisible.resize(chunkCount);
+        pool->ParallelFor(chunkCount, [&](size_t chunk) {
+            std::vector<uint32_t>& visible = m_chunkVisible[chunk];
+            visible.clear();
+            CullRange(frustum, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize), visible);
+        });
+
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            m_visible.insert(m_visible.end(), m_chunkVisible[chunk].begin(), m_chunkVisible[chunk].end());
+        }
+    }
+
+    m_stats.tested  = static_cast<uint32_t>(count);
+    m_stats.visible = static_cast<uint32_t>(m_visible.size());
+    return m_visible;
+}
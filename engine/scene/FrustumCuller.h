@@ -0,0 +1,71 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef FRUSTUMCULLER_H
+#define FRUSTUMCULLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Components.h"
+#include "Entity.h"
+#include "Geometry.h"
+
+class ThreadPool;
+
+/**
+ * Отсечение по пирамиде видимости на CPU
+ * Мировые AABB хранятся упакованными SoA массивами (центры и половины размеров по осям), проверка идет
+ * по 4 (SSE2) или 8 (AVX) боксов за раз. Большие наборы делятся на куски и проверяются на пуле потоков.
+ * Результат - плотный список индексов видимых боксов в порядке добавления.
+ */
+class FrustumCuller
+{
+public:
+    struct Stats
+    {
+        uint32_t tested  = 0;
+        uint32_t visible = 0;
+    };
+
+    void Clear();
+    void Reserve(size_t count);
+    void Add(Entity entity, const Aabb& box);
+
+    // Индексы видимых боксов (см. GetEntity), действительны до следующего Clear
+    const std::vector<uint32_t>& Cull(const Frustum& frustum, ThreadPool* pool = nullptr);
+
+    size_t    GetCount() const { return m_entities.size(); }
+    Entity    GetEntity(uint32_t index) const { return m_entities[index]; }
+    glm::vec3 GetCenter(uint32_t index) const { return {m_centerX[index], m_centerY[index], m_centerZ[index]}; }
+    // Радиус описанной вокруг бокса сферы
+    float     GetRadius(uint32_t index) const;
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    // Меньше этого числа боксов раздача задач пулу дороже самой проверки
+    static constexpr size_t PARALLEL_MIN_COUNT = 16384;
+    static constexpr size_t CHUNK_MIN_SIZE     = 4096;
+
+    void CullRange(const Frustum& frustum, size_t first, size_t last, std::vector<uint32_t>& visible) const;
+
+    std::vector<Entity> m_entities;
+    std::vector<float>  m_centerX;
+    std::vector<float>  m_centerY;
+    std::vector<float>  m_centerZ;
+    std::vector<float>  m_extentX;
+    std::vector<float>  m_extentY;
+    std::vector<float>  m_extentZ;
+
+    std::vector<uint32_t>              m_visible;
+    std::vector<std::vector<uint32_t>> m_chunkVisible; // Результаты кусков, склеиваются по порядку
+    Stats                              m_stats;
+};
+#endif // FRUSTUMCULLER_H
@@ -0,0 +1,69 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "Geometry.h"
+
+#include <algorithm>
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+{
+    // Строки матрицы (glm хранит столбцы): плоскость отсечения - сумма или разность строки w с x, y, z
+    auto row = [&](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+    glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+
+    Frustum frustum{{w + x, w - x, w + y, w - y, w + z, w - z}};
+    for (glm::vec4& plane : frustum.planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) { plane /= length; }
+    }
+    return frustum;
+}
+
+Aabb TransformBounds(const glm::mat4& world, const Bounds& bounds)
+{
+    glm::vec3 center = glm::vec3(world * glm::vec4(bounds.center, 1.0f));
+    glm::vec3 extents(0.0f);
+    for (int column = 0; column < 3; ++column)
+    {
+        extents += glm::abs(glm::vec3(world[column])) * bounds.extents[column];
+    }
+    return Aabb::FromCenterExtents(center, extents);
+}
+
+bool Intersects(const Frustum& frustum, const Aabb& box)
+{
+    if (box.IsEmpty()) { return false; }
+
+    glm::vec3 center  = box.Center();
+    glm::vec3 extents = box.Extents();
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        float radius   = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+        if (distance + radius < 0.0f) { return false; }
+    }
+    return true;
+}
+
+bool IntersectRay(const Ray& ray, const Aabb& box, float maxDistance, float& distance)
+{
+    if (box.IsEmpty()) { return false; }
+
+    // Нулевая компонента направления дает бесконечности - сравнения с ними остаются корректными
+    glm::vec3 t0 = (box.min - ray.origin) * ray.inverseDirection;
+    glm::vec3 t1 = (box.max - ray.origin) * ray.inverseDirection;
+
+    glm::vec3 nearT = glm::min(t0, t1);
+    glm::vec3 farT  = glm::max(t0, t1);
+
+    float enter = std::max(std::max(nearT.x, nearT.y), std::max(nearT.z, 0.0f));
+    float exit  = std::min(std::min(farT.x, farT.y), std::min(farT.z, maxDistance));
+    if (enter > exit) { return false; }
+
+    distance = enter;
+    return true;
+}
@@ -0,0 +1,94 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <glm/glm.hpp>
+
+#include "Components.h"
+
+// Шесть плоскостей пирамиды видимости: точка внутри, если dot(plane.xyz, p) + plane.w >= 0 для всех
+struct Frustum
+{
+    glm::vec4 planes[6];
+
+    // Плоскости из матрицы view * projection (метод Gribb/Hartmann), нормали нормализованы
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+};
+
+// Мировой бокс по осям. Пустой бокс (min > max) ни с чем не пересекается
+struct Aabb
+{
+    glm::vec3 min = glm::vec3(1e30f);
+    glm::vec3 max = glm::vec3(-1e30f);
+
+    static Aabb FromCenterExtents(const glm::vec3& center, const glm::vec3& extents)
+    {
+        return {center - extents, center + extents};
+    }
+
+    bool operator==(const Aabb&) const = default;
+
+    bool      IsEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+    glm::vec3 Center() const { return (min + max) * 0.5f; }
+    glm::vec3 Extents() const { return (max - min) * 0.5f; }
+
+    void Grow(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void Grow(const Aabb& box)
+    {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+
+    // Половина площади поверхности - для SAH важны только отношения
+    float HalfArea() const
+    {
+        if (IsEmpty()) { return 0.0f; }
+        glm::vec3 size = max - min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    bool Intersects(const Aabb& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y
+            && min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    bool Contains(const Aabb& other) const
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && max.x >= other.max.x
+            && max.y >= other.max.y && max.z >= other.max.z;
+    }
+};
+
+// Локальный AABB сущности в мировых координатах: половины размеров через модули элементов матрицы
+Aabb TransformBounds(const glm::mat4& world, const Bounds& bounds);
+
+// Бокс не лежит целиком за одной из плоскостей (консервативно: бокс у ребра пирамиды может пройти)
+bool Intersects(const Frustum& frustum, const Aabb& box);
+
+// Луч для выбора объектов. inverseDirection заранее, чтобы не делить в каждом тесте
+struct Ray
+{
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 inverseDirection;
+
+    Ray(const glm::vec3& rayOrigin, const glm::vec3& rayDirection)
+        : origin(rayOrigin), direction(rayDirection), inverseDirection(1.0f / rayDirection)
+    {
+    }
+};
+
+// Пересечение луча с боксом (slab тест): расстояние входа в [0, maxDistance], иначе false
+bool IntersectRay(const Ray& ray, const Aabb& box, float maxDistance, float& distance);
+#endif // GEOMETRY_H
@@ -0,0 +1,221 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "LooseOctree.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LooseOctree::Reset(const glm::vec3& center, float halfSize, uint32_t maxDepth)
+{
+    m_center   = center;
+    m_halfSize = halfSize;
+    m_maxDepth = std::min(maxDepth, MAX_DEPTH);
+
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_objects.clear();
+    m_objectOfEntity.clear();
+    AllocateNode(NO_NODE, center, halfSize, 0);
+}
+
+uint32_t LooseOctree::ObjectOf(Entity entity) const
+{
+    uint32_t index = entity.GetIndex();
+    if (!entity || index >= m_objectOfEntity.size()) { return NO_NODE; }
+
+    uint32_t object = m_objectOfEntity[index];
+    return object != NO_NODE && m_objects[object].entity == entity ? object : NO_NODE;
+}
+
+void LooseOctree::Update(Entity entity, const Aabb& bounds)
+{
+    if (!entity || bounds.IsEmpty()) { return; }
+
+    uint32_t object = ObjectOf(entity);
+    if (object == NO_NODE)
+    {
+        object = static_cast<uint32_t>(m_objects.size());
+        m_objects.push_back({entity, bounds, NO_NODE, 0});
+
+        uint32_t index = entity.GetIndex();
+        if (index >= m_objectOfEntity.size()) { m_objectOfEntity.resize(index + 1, NO_NODE); }
+        m_objectOfEntity[index] = object;
+
+        Attach(object, PlaceNode(bounds));
+        return;
+    }
+
+    m_objects[object].bounds = bounds;
+
+    // Чаще всего объект сдвигается в пределах своей ячейки - тогда списки не меняются
+    const Node& node    = m_nodes[m_objects[object].node];
+    glm::vec3   center  = bounds.Center();
+    glm::vec3   offset  = glm::abs(center - node.center);
+    glm::vec3   extents = bounds.Extents();
+    float       radius  = std::max(std::max(extents.x, extents.y), extents.z);
+    bool        inside  = offset.x <= node.halfSize && offset.y <= node.halfSize && offset.z <= node.halfSize;
+    bool        deepest = node.depth == m_maxDepth || radius > node.halfSize * 0.5f;
+    bool        fits    = node.parent == NO_NODE ? !inside || deepest : inside && radius <= node.halfSize && deepest;
+    if (fits) { return; }
+
+    // Сначала убираем: опустевшие ветки освобождаются и не мешают размещению
+    Detach(object);
+    Attach(object, PlaceNode(bounds));
+}
+
+bool LooseOctree::Remove(Entity entity)
+{
+    uint32_t object = ObjectOf(entity);
+    if (object == NO_NODE) { return false; }
+
+    Detach(object);
+    m_objectOfEntity[entity.GetIndex()] = NO_NODE;
+
+    // Последний объект занимает место удаленного - его позицию нужно поправить в узле и в таблице сущностей
+    auto last = static_cast<uint32_t>(m_objects.size() - 1);
+    if (object != last)
+    {
+        Object& moved                             = m_objects[object];
+        moved                                     = m_objects[last];
+        m_nodes[moved.node].objects[moved.slot]   = object;
+        m_objectOfEntity[moved.entity.GetIndex()] = object;
+    }
+    m_objects.pop_back();
+    return true;
+}
+
+uint32_t LooseOctree::PlaceNode(const Aabb& bounds)
+{
+    glm::vec3 center  = bounds.Center();
+    glm::vec3 extents = bounds.Extents();
+    float     radius  = std::max(std::max(extents.x, extents.y), extents.z);
+
+    glm::vec3 offset = glm::abs(center - m_center);
+    if (offset.x > m_halfSize || offset.y > m_halfSize || offset.z > m_halfSize) { return 0; }
+
+    // Вниз, пока объект помещается в расширенные границы ребенка: его половина ячейки не меньше радиуса
+    uint32_t node = 0;
+    while (m_nodes[node].depth < m_maxDepth)
+    {
+        float childHalf = m_nodes[node].halfSize * 0.5f;
+        if (radius > childHalf) { break; }
+
+        glm::vec3 nodeCenter = m_nodes[node].center;
+        uint32_t  octant     = (center.x >= nodeCenter.x ? 1u : 0u) | (center.y >= nodeCenter.y ? 2u : 0u);
+        octant |= center.z >= nodeCenter.z ? 4u : 0u;
+
+        uint32_t child = m_nodes[node].children[octant];
+        if (child == NO_NODE)
+        {
+            glm::vec3 direction((octant & 1) ? 1.0f : -1.0f, (octant & 2) ? 1.0f : -1.0f, (octant & 4) ? 1.0f : -1.0f);
+            child = AllocateNode(node, nodeCenter + direction * childHalf, childHalf, m_nodes[node].depth + 1);
+            m_nodes[node].children[octant] = child;
+        }
+        node = child;
+    }
+    return node;
+}
+
+uint32_t LooseOctree::AllocateNode(uint32_t parent, const glm::vec3& center, float halfSize, uint32_t depth)
+{
+    uint32_t index;
+    if (!m_freeNodes.empty())
+    {
+        index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& node        = m_nodes[index];
+    node.looseBounds  = Aabb::FromCenterExtents(center, glm::vec3(halfSize * 2.0f));
+    node.center       = center;
+    node.halfSize     = halfSize;
+    node.parent       = parent;
+    node.depth        = depth;
+    node.subtreeCount = 0;
+    node.children.fill(NO_NODE);
+    node.objects.clear(); // Емкость списка освобожденного узла сохраняется
+    return index;
+}
+
+void LooseOctree::Attach(uint32_t object, uint32_t node)
+{
+    m_objects[object].node = node;
+    m_objects[object].slot = static_cast<uint32_t>(m_nodes[node].objects.size());
+    m_nodes[node].objects.push_back(object);
+
+    for (uint32_t i = node; i != NO_NODE; i = m_nodes[i].parent) { ++m_nodes[i].subtreeCount; }
+}
+
+void LooseOctree::Detach(uint32_t object)
+{
+    uint32_t               node    = m_objects[object].node;
+    uint32_t               slot    = m_objects[object].slot;
+    std::vector<uint32_t>& objects = m_nodes[node].objects;
+    if (slot + 1 != objects.size())
+    {
+        objects[slot]                 = objects.back();
+        m_objects[objects[slot]].slot = slot;
+    }
+    objects.pop_back();
+
+    // Самая верхняя опустевшая ветка (кроме корня) освобождается целиком
+    uint32_t empty = NO_NODE;
+    for (uint32_t i = node; i != NO_NODE; i = m_nodes[i].parent)
+    {
+        if (--m_nodes[i].subtreeCount == 0 && m_nodes[i].parent != NO_NODE) { empty = i; }
+    }
+    if (empty == NO_NODE) { return; }
+
+    std::array<uint32_t, 8>& siblings = m_nodes[m_nodes[empty].parent].children;
+    std::replace(siblings.begin(), siblings.end(), empty, NO_NODE);
+    FreeSubtree(empty);
+}
+
+void LooseOctree::FreeSubtree(uint32_t node)
+{
+    for (uint32_t child : m_nodes[node].children)
+    {
+        if (child != NO_NODE) { FreeSubtree(child); }
+    }
+    m_nodes[node].children.fill(NO_NODE);
+    m_freeNodes.push_back(node);
+}
+
+bool LooseOctree::Raycast(const Ray& ray, float maxDistance, Entity& entity, float& distance) const
+{
+    bool     hit     = false;
+    float    nearest = maxDistance;
+    float    enter;
+    uint32_t stack[STACK_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const Node& node = m_nodes[stack[--top]];
+        if (node.subtreeCount == 0) { continue; }
+        if (node.parent != NO_NODE && !IntersectRay(ray, node.looseBounds, nearest, enter)) { continue; }
+
+        for (uint32_t object : node.objects)
+        {
+            const Object& item = m_objects[object];
+            if (!IntersectRay(ray, item.bounds, nearest, enter)) { continue; }
+            nearest = enter;
+            entity  = item.entity;
+            hit     = true;
+        }
+        for (uint32_t child : node.children)
+        {
+            if (child != NO_NODE) { stack[top++] = child; }
+        }
+    }
+
+    if (hit) { distance = nearest; }
+    return hit;
+}
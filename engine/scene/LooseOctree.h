@@ -0,0 +1,141 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef LOOSEOCTREE_H
+#define LOOSEOCTREE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Entity.h"
+#include "Geometry.h"
+
+/**
+ * Свободное (loose) октодерево для движущихся объектов
+ * Границы узла вдвое больше его ячейки, поэтому объект хранится в узле, чья ячейка содержит центр объекта,
+ * на глубине, где половина ячейки не меньше наибольшей половины размера объекта. Место объекта зависит только
+ * от его центра и размера: перемещение - это проверка нового узла и, если он другой, перенос между двумя списками,
+ * без перестройки. Объекты с центром вне корневой ячейки живут в корне.
+ */
+class LooseOctree
+{
+public:
+    static constexpr uint32_t NO_NODE   = ~0u;
+    static constexpr uint32_t MAX_DEPTH = 16;
+
+    explicit LooseOctree(float halfSize = 1024.0f, uint32_t maxDepth = 8)
+    {
+        Reset(glm::vec3(0.0f), halfSize, maxDepth);
+    }
+
+    // Новая корневая ячейка, объекты удаляются. Глубина не больше MAX_DEPTH
+    void Reset(const glm::vec3& center, float halfSize, uint32_t maxDepth);
+    void Clear() { Reset(m_center, m_halfSize, m_maxDepth); }
+
+    bool Contains(Entity entity) const { return ObjectOf(entity) != NO_NODE; }
+    // Вставка или перемещение уже добавленного объекта
+    void Update(Entity entity, const Aabb& bounds);
+    bool Remove(Entity entity);
+
+    // f(Entity, const Aabb&) для объектов, чей бокс пересекает пирамиду или бокс
+    template <typename F>
+    void QueryFrustum(const Frustum& frustum, F&& f) const
+    {
+        auto test = [&](const Aabb& box) { return Intersects(frustum, box); };
+        Traverse(test, test, f);
+    }
+
+    template <typename F>
+    void QueryAabb(const Aabb& bounds, F&& f) const
+    {
+        auto test = [&](const Aabb& box) { return box.Intersects(bounds); };
+        Traverse(test, test, f);
+    }
+
+    // Кандидаты для FrustumCuller, как в Bvh::CollectFrustumCandidates. Пустые боксы не отбрасываются:
+    // в ячейках лежат только объекты с боксом
+    template <typename F>
+    void CollectFrustumCandidates(const Frustum& frustum, F&& f) const
+    {
+        Traverse([&](const Aabb& box) { return Intersects(frustum, box); },
+                 [](const Aabb&) { return true; },
+                 f);
+    }
+
+    // Ближайший бокс на луче в пределах maxDistance
+    bool Raycast(const Ray& ray, float maxDistance, Entity& entity, float& distance) const;
+
+    size_t GetObjectCount() const { return m_objects.size(); }
+    size_t GetNodeCount() const { return m_nodes.size() - m_freeNodes.size(); }
+
+private:
+    // Узел снимается со стека раньше, чем кладутся его дети: на каждом уровне остается не больше 7 узлов
+    static constexpr uint32_t STACK_SIZE = 8 * (MAX_DEPTH + 1);
+
+    struct Node
+    {
+        Aabb                    looseBounds; // Ячейка, расширенная вдвое
+        glm::vec3               center;
+        float                   halfSize;
+        uint32_t                parent;
+        uint32_t                depth;
+        std::array<uint32_t, 8> children; // NO_NODE - ребенка нет
+        std::vector<uint32_t>   objects;  // Позиции в m_objects
+        uint32_t                subtreeCount = 0; // Объектов в поддереве - пустые ветки не обходятся
+    };
+
+    struct Object
+    {
+        Entity   entity;
+        Aabb     bounds;
+        uint32_t node;
+        uint32_t slot; // Позиция в Node::objects
+    };
+
+    uint32_t ObjectOf(Entity entity) const;
+    // Узел для бокса, недостающие узлы по пути создаются
+    uint32_t PlaceNode(const Aabb& bounds);
+    uint32_t AllocateNode(uint32_t parent, const glm::vec3& center, float halfSize, uint32_t depth);
+    void     Attach(uint32_t object, uint32_t node);
+    void     Detach(uint32_t object);
+    void     FreeSubtree(uint32_t node);
+
+    template <typename NodeTest, typename ObjectTest, typename F>
+    void Traverse(NodeTest&& nodeTest, ObjectTest&& objectTest, F& f) const
+    {
+        // Корень проверяется всегда: в нем лежат объекты вне его границ
+        uint32_t stack[STACK_SIZE];
+        uint32_t top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node& node = m_nodes[stack[--top]];
+            if (node.subtreeCount == 0 || (node.parent != NO_NODE && !nodeTest(node.looseBounds))) { continue; }
+
+            for (uint32_t object : node.objects)
+            {
+                const Object& item = m_objects[object];
+                if (objectTest(item.bounds)) { f(item.entity, item.bounds); }
+            }
+            for (uint32_t child : node.children)
+            {
+                if (child != NO_NODE) { stack[top++] = child; }
+            }
+        }
+    }
+
+    glm::vec3 m_center{0.0f};
+    float     m_halfSize = 0.0f;
+    uint32_t  m_maxDepth = 0;
+
+    std::vector<Node>     m_nodes; // 0 - корень
+    std::vector<uint32_t> m_freeNodes;
+    std::vector<Object>   m_objects;        // Плотно, удаление переносит последний объект на место удаленного
+    std::vector<uint32_t> m_objectOfEntity; // Индекс сущности -> позиция объекта
+};
+#endif // LOOSEOCTREE_H
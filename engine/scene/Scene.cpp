@@ -0,0 +1,369 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "Scene.h"
+#include "Components.h"
+#include "../render/Renderer.h"
+#include "../render/ShaderProgram.h"
+#include "../utils/Logger.h"
+#include "../utils/ResourceManager.h"
+
+#include <bit>
+#include <tuple>
+
+namespace
+{
+    // Отрисовка программы с атрибутами экземпляра - копится до конца кадра и сливается с такими же
+    struct InstancedDraw
+    {
+        DrawPacket   packet;
+        InstanceData instance;
+    };
+
+    // Состояние отправки пакетов одного кадра
+    struct DrawContext
+    {
+        Renderer&    renderer;
+        RenderQueue& queue;
+        glm::vec4    depthRow;           // Третья строка матрицы вида - глубина по оси взгляда
+        bool         gpuCulling = false; // Видимость DrawData отрисовок с Bounds проверяет cull.comp
+
+        // Подряд идущие сущности обычно делят материал - программа разрешается один раз на серию
+        ShaderHandle   lastShader;
+        ShaderProgram* program = nullptr;
+
+        std::vector<InstancedDraw> instanced;
+    };
+
+    // Экземпляры сливаются в один вызов, если их пакеты совпадают во всем, кроме глубины
+    auto BatchKey(const DrawPacket& packet)
+    {
+        return std::tie(packet.program,
+                        packet.vao,
+                        packet.textures,
+                        packet.mode,
+                        packet.indexCount,
+                        packet.indexType,
+                        packet.indexOffset,
+                        packet.baseVertex,
+                        packet.transparent,
+                        packet.layer);
+    }
+
+    ShaderProgram* ResolveProgram(DrawContext& context, const MaterialComponent& material)
+    {
+        if (material.shader != context.lastShader)
+        {
+            context.lastShader = material.shader;
+            context.program    = RESOURCE_MANAGER.GetShaderProgram(material.shader);
+        }
+        return context.program;
+    }
+
+    // bounds - локальный бокс для cull.comp, только у отрисовок, которые отсекает GPU
+    void SubmitEntity(DrawContext& context, const glm::mat4& world, const MeshComponent& mesh,
+                      const MaterialComponent& material, float screenSize, const Bounds* bounds = nullptr)
+    {
+        ShaderProgram* program = ResolveProgram(context, material);
+        if (!program || mesh.vao == 0) { return; }
+
+        DrawPacket packet;
+        packet.program     = program;
+        packet.vao         = mesh.vao;
+        packet.mode        = mesh.mode;
+        packet.indexCount  = mesh.indexCount;
+        packet.indexType   = mesh.indexType;
+        packet.indexOffset = mesh.indexOffset;
+        packet.baseVertex  = mesh.baseVertex;
+        packet.depth       = -glm::dot(context.depthRow, world[3]);
+        packet.transparent = material.transparent;
+        packet.layer       = material.layer;
+
+        for (uint32_t unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+        {
+            TextureHandle texture = material.textures[unit];
+            if (!texture) { continue; }
+
+            if (screenSize > 0.0f) { RESOURCE_MANAGER.RequestTextureResolution(texture, screenSize); }
+            if (program->UsesMaterials() || program->UsesInstanceData())
+            {
+                // Экземпляры различаются слоем, поэтому текстуры им нужны в массивах даже при bindless
+                ResourceManager::TextureLayer resolved = program->UsesInstanceData()
+                                                             ? RESOURCE_MANAGER.AcquireTextureLayer(texture)
+                                                             : RESOURCE_MANAGER.GetMaterialTexture(texture);
+                packet.textures[unit] = resolved.texture;
+                packet.layers[unit]   = resolved.layer;
+            }
+            else { packet.textures[unit] = RESOURCE_MANAGER.GetTexture(texture); }
+        }
+
+        // Шейдер экземпляров читает один массив на юните 0, слой приходит атрибутом instanceLayer
+        if (program->UsesInstanceData())
+        {
+            InstancedDraw& draw        = context.instanced.emplace_back();
+            draw.packet                = packet;
+            draw.instance.model        = world;
+            draw.instance.color        = material.color;
+            draw.instance.textureLayer = packet.layers[0];
+            return;
+        }
+
+        // Программы с DrawDataBuffer сливаются в indirect вызовы, остальные получают матрицу uniform'ом
+        if (program->UsesDrawData())
+        {
+            DrawData drawData;
+            drawData.model = world;
+            drawData.color = material.color;
+            if (bounds)
+            {
+                context.queue.Submit(packet, drawData, DrawBounds::FromLocal(bounds->center, bounds->extents));
+            }
+            else { context.queue.Submit(packet, drawData); }
+        }
+        else
+        {
+            context.queue.AddUniform(UniformNames::Model, world);
+            context.queue.Submit(packet);
+        }
+    }
+
+    void SubmitInstancedDraws(DrawContext& context)
+    {
+        std::vector<InstancedDraw>& draws = context.instanced;
+        std::sort(draws.begin(), draws.end(), [](const InstancedDraw& a, const InstancedDraw& b) {
+            return BatchKey(a.packet) < BatchKey(b.packet);
+        });
+
+        std::vector<InstanceData> instances;
+        for (size_t first = 0, last = 0; first < draws.size(); first = last)
+        {
+            // Серия сортируется очередью по глубине ближайшего экземпляра, прозрачная - дальнего
+            DrawPacket packet = draws[first].packet;
+            instances.clear();
+            for (last = first; last < draws.size() && BatchKey(draws[last].packet) == BatchKey(packet); ++last)
+            {
+                float depth  = draws[last].packet.depth;
+                packet.depth = packet.transparent ? std::max(packet.depth, depth) : std::min(packet.depth, depth);
+                instances.push_back(draws[last].instance);
+            }
+            context.queue.SubmitInstanced(packet, instances.data(), static_cast<uint32_t>(instances.size()));
+        }
+        draws.clear();
+    }
+} // namespace
+
+Entity Scene::CreateEntity()
+{
+    Entity entity = m_entities.Insert(0);
+    if (!entity) { LOG_ERROR("Scene entity limit reached"); }
+    return entity;
+}
+
+void Scene::DestroyEntity(Entity entity)
+{
+    const ComponentMask* mask = m_entities.Get(entity);
+    if (!mask) { return; }
+
+    // Трогаем только пулы, в которых у сущности есть компоненты
+    for (ComponentMask bits = *mask; bits != 0; bits &= bits - 1)
+    {
+        auto id = static_cast<uint32_t>(std::countr_zero(bits));
+        OnComponentRemoved(entity, id);
+        m_pools[id]->Remove(entity);
+    }
+    m_entities.Remove(entity);
+}
+
+void Scene::Clear()
+{
+    for (auto& pool : m_pools)
+    {
+        if (pool) { pool->Clear(); }
+    }
+    m_entities.Clear();
+    m_commands.clear();
+    m_destroyed.clear();
+    m_hierarchy.Clear();
+    m_staticIndex.Clear();
+    m_dynamicIndex.Clear();
+}
+
+void Scene::OnComponentAdded(Entity entity, uint32_t typeId)
+{
+    // Новому или перезаписанному Transform, как и новому WorldTransform, нужна свежая матрица.
+    // Новые Bounds попадают в индекс при пересчете матрицы - ради него узел тоже помечается
+    if (typeId == ComponentTypeId<Transform>()) { m_hierarchy.Insert(entity); }
+    else if (typeId == ComponentTypeId<WorldTransform>() || typeId == ComponentTypeId<Bounds>())
+    {
+        m_hierarchy.MarkDirty(entity);
+    }
+}
+
+void Scene::OnComponentRemoved(Entity entity, uint32_t typeId)
+{
+    // Без Transform матрица больше не меняется - прежний бокс в индексе остается верным
+    if (typeId == ComponentTypeId<Transform>()) { m_hierarchy.Remove(entity); }
+    else if (typeId == ComponentTypeId<WorldTransform>() || typeId == ComponentTypeId<Bounds>())
+    {
+        m_staticIndex.Remove(entity);
+        m_dynamicIndex.Remove(entity);
+    }
+    else if (typeId == ComponentTypeId<StaticObject>() && m_staticIndex.Remove(entity))
+    {
+        m_dynamicIndex.Update(entity, WorldBounds(entity));
+    }
+}
+
+Aabb Scene::WorldBounds(Entity entity)
+{
+    const WorldTransform* world  = Get<WorldTransform>(entity);
+    const Bounds*         bounds = Get<Bounds>(entity);
+    return world && bounds ? TransformBounds(world->matrix, *bounds) : Aabb{};
+}
+
+Transform* Scene::EditTransform(Entity entity)
+{
+    Transform* transform = Get<Transform>(entity);
+    if (transform) { m_hierarchy.MarkDirty(entity); }
+    return transform;
+}
+
+void Scene::FlushCommands()
+{
+    // Команды могут добавлять новые - обходим по индексу, а не итератором
+    for (size_t i = 0; i < m_commands.size(); ++i) { m_commands[i](*this); }
+    m_commands.clear();
+
+    for (Entity entity : m_destroyed) { DestroyEntity(entity); }
+    m_destroyed.clear();
+}
+
+void Scene::UpdateTransforms()
+{
+    m_hierarchy.Update(Pool<Transform>(), Pool<WorldTransform>());
+
+    // Сдвинутые статические объекты расширяют боксы BVH, движущиеся переносятся между ячейками октодерева
+    for (size_t i = 0; i < m_hierarchy.GetUpdatedCount(); ++i)
+    {
+        Entity entity = m_hierarchy.GetUpdatedEntity(i);
+        Aabb   bounds = WorldBounds(entity);
+        if (bounds.IsEmpty()) { continue; }
+
+        if (!m_staticIndex.UpdateBounds(entity, bounds)) { m_dynamicIndex.Update(entity, bounds); }
+    }
+    m_staticIndex.Refit();
+}
+
+void Scene::RebuildStaticIndex(ThreadPool* pool)
+{
+    // Потерявшие StaticObject удаляются из BVH в OnComponentRemoved - здесь переносятся только новые
+    std::vector<Bvh::Item> items;
+    View<WorldTransform, Bounds, StaticObject>().Each(
+        [&](Entity entity, const WorldTransform& world, const Bounds& bounds, const StaticObject&) {
+            items.push_back({entity, TransformBounds(world.matrix, bounds)});
+            m_dynamicIndex.Remove(entity);
+        });
+    m_staticIndex.Build(items, pool);
+
+    LOG_INFO("Static scene index: {} objects, {} nodes, {} dynamic objects",
+             m_staticIndex.GetObjectCount(),
+             m_staticIndex.GetNodeCount(),
+             m_dynamicIndex.GetObjectCount());
+}
+
+void Scene::SetDynamicIndexBounds(const glm::vec3& center, float halfSize, uint32_t maxDepth)
+{
+    std::vector<Entity> indexed;
+    View<WorldTransform, Bounds>().Each([&](Entity entity, const WorldTransform&, const Bounds&) {
+        if (m_dynamicIndex.Contains(entity)) { indexed.push_back(entity); }
+    });
+
+    m_dynamicIndex.Reset(center, halfSize, maxDepth);
+    for (Entity entity : indexed) { m_dynamicIndex.Update(entity, WorldBounds(entity)); }
+}
+
+bool Scene::Raycast(const Ray& ray, float maxDistance, Entity& entity, float& distance) const
+{
+    bool hit = m_staticIndex.Raycast(ray, maxDistance, entity, distance);
+    // Второй индекс ищет только ближе уже найденного
+    if (m_dynamicIndex.Raycast(ray, hit ? distance : maxDistance, entity, distance)) { hit = true; }
+    return hit;
+}
+
+void Scene::QueryAabb(const Aabb& bounds, std::vector<Entity>& result) const
+{
+    auto collect = [&](Entity entity, const Aabb&) { result.push_back(entity); };
+    m_staticIndex.QueryAabb(bounds, collect);
+    m_dynamicIndex.QueryAabb(bounds, collect);
+}
+
+void Scene::SubmitDraws(Renderer& renderer, ThreadPool* pool)
+{
+    const FrameData& frame = renderer.GetFrameData();
+
+    glm::vec4   depthRow(frame.view[0][2], frame.view[1][2], frame.view[2][2], frame.view[3][2]);
+    Frustum     frustum = Frustum::FromMatrix(frame.viewProjection);
+    DrawContext context{renderer, renderer.GetRenderQueue(), depthRow, renderer.IsGpuCullingEnabled(), {}, nullptr,
+                        {}};
+
+    // При GPU отсечении DrawData отрисовки с Bounds уходят в cull.comp все, без обхода индексов.
+    // Остальные (uniform путь, экземпляры) отсекаются на CPU, как и без него
+    auto gpuCulled = [&](Entity entity, const MaterialComponent& material) {
+        if (!context.gpuCulling || !Has<Bounds>(entity)) { return false; }
+        ShaderProgram* program = ResolveProgram(context, material);
+        return program && program->UsesDrawData() && !program->UsesInstanceData();
+    };
+
+    m_culler.Clear();
+    if (context.gpuCulling)
+    {
+        View<WorldTransform, MeshComponent, MaterialComponent, Bounds>().Each(
+            [&](Entity entity, const WorldTransform& world, const MeshComponent& mesh,
+                const MaterialComponent& material, const Bounds& bounds) {
+                if (!gpuCulled(entity, material)) { return; }
+
+                // Видимость станет известна только на GPU - разрешение текстур запрашивается по размеру
+                // описанной сферы на экране, как будто объект виден
+                float screenSize = 0.0f;
+                bool  textured   = std::any_of(material.textures.begin(), material.textures.end(),
+                                               [](TextureHandle texture) { return static_cast<bool>(texture); });
+                if (textured)
+                {
+                    Aabb box   = TransformBounds(world.matrix, bounds);
+                    screenSize = renderer.EstimateScreenSize(box.Center(), glm::length(box.Extents()));
+                }
+                SubmitEntity(context, world.matrix, mesh, material, screenSize, &bounds);
+            });
+    }
+
+    // Индексы отбрасывают ветки вне пирамиды видимости, боксы из оставшихся узлов проверяются пакетно
+    auto collect = [&](Entity entity, const Aabb& bounds) {
+        const MaterialComponent* material = Get<MaterialComponent>(entity);
+        if (!material || !gpuCulled(entity, *material)) { m_culler.Add(entity, bounds); }
+    };
+    m_staticIndex.CollectFrustumCandidates(frustum, collect);
+    m_dynamicIndex.CollectFrustumCandidates(frustum, collect);
+
+    for (uint32_t index : m_culler.Cull(frustum, pool))
+    {
+        Entity                   entity   = m_culler.GetEntity(index);
+        const MeshComponent*     mesh     = Get<MeshComponent>(entity);
+        const MaterialComponent* material = Get<MaterialComponent>(entity);
+        if (!mesh || !material) { continue; }
+
+        // Размер на экране по описанной вокруг AABB сфере - для потоковой загрузки уровней mip
+        float screenSize = renderer.EstimateScreenSize(m_culler.GetCenter(index), m_culler.GetRadius(index));
+        SubmitEntity(context, Get<WorldTransform>(entity)->matrix, *mesh, *material, screenSize);
+    }
+
+    // Вне индексов (без Bounds или без Transform) видимость неизвестна - такие сущности рисуются всегда
+    View<WorldTransform, MeshComponent, MaterialComponent>().Each(
+        [&](Entity entity, const WorldTransform& world, const MeshComponent& mesh, const MaterialComponent& material) {
+            if (!IsIndexed(entity) && !gpuCulled(entity, material))
+            {
+                SubmitEntity(context, world.matrix, mesh, material, 0.0f);
+            }
+        });
+    SubmitInstancedDraws(context);
+}
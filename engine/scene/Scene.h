@@ -0,0 +1,236 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Bvh.h"
+#include "ComponentPool.h"
+#include "Entity.h"
+#include "FrustumCuller.h"
+#include "LooseOctree.h"
+#include "TransformHierarchy.h"
+
+class Renderer;
+class ThreadPool;
+
+/**
+ * Обход сущностей, у которых есть все компоненты Ts
+ * Ведущим выбирается самый маленький пул: его плотный массив проходится подряд,
+ * у остальных пулов компонент находится через разреженный массив без поиска.
+ */
+template <typename... Ts>
+class SceneView
+{
+public:
+    explicit SceneView(std::tuple<ComponentPool<Ts>*...> pools) : m_pools(pools) {}
+
+    // f(Entity, Ts&...). Структурные изменения внутри обхода - только через Scene::Defer*
+    template <typename F>
+    void Each(F&& f)
+    {
+        const ComponentPoolBase* lead = nullptr;
+        std::apply([&](auto*... pools) { ((lead = !lead || pools->Size() < lead->Size() ? pools : lead), ...); },
+                   m_pools);
+
+        const Entity* entities = lead->Entities();
+        for (size_t i = 0; i < lead->Size(); ++i)
+        {
+            Entity entity = entities[i];
+            std::array<uint32_t, sizeof...(Ts)> dense{std::get<ComponentPool<Ts>*>(m_pools)->IndexOf(entity)...};
+            if (std::find(dense.begin(), dense.end(), ComponentPoolBase::INVALID) != dense.end()) { continue; }
+
+            Invoke(f, entity, dense, std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    // Верхняя оценка числа сущностей обхода - размер самого маленького пула
+    size_t SizeHint() const
+    {
+        size_t size = ~size_t(0);
+        std::apply([&](auto*... pools) { ((size = std::min(size, pools->Size())), ...); }, m_pools);
+        return size;
+    }
+
+private:
+    template <typename F, size_t... I>
+    void Invoke(F& f, Entity entity, const std::array<uint32_t, sizeof...(Ts)>& dense, std::index_sequence<I...>)
+    {
+        f(entity, std::get<I>(m_pools)->At(dense[I])...);
+    }
+
+    std::tuple<ComponentPool<Ts>*...> m_pools;
+};
+
+/**
+ * Сцена на сущностях и компонентах
+ * Сущность - дескриптор, компоненты каждого типа лежат в своем плотном пуле (SoA по типам компонентов),
+ * поэтому системы обходят непрерывные массивы, а не граф объектов. Добавление, удаление компонентов и
+ * уничтожение сущностей меняют пулы, поэтому во время обхода они откладываются (Defer*) и применяются
+ * в FlushCommands - приложение вызывает его после Update.
+ */
+class Scene
+{
+public:
+    Scene() = default;
+    ~Scene() { Clear(); }
+
+    Scene(const Scene&)            = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // Создание не трогает пулы - безопасно и во время обхода. Пустая сущность, если исчерпаны индексы
+    Entity CreateEntity();
+    void   DestroyEntity(Entity entity);
+    bool   IsAlive(Entity entity) const { return m_entities.Contains(entity); }
+    size_t GetEntityCount() const { return m_entities.Size(); }
+    void   Clear();
+
+    // Компоненты. Существующий компонент того же типа перезаписывается
+    template <typename T>
+    T* Add(Entity entity, T component = {})
+    {
+        ComponentMask* mask = m_entities.Get(entity);
+        if (!mask || ComponentBit<T>() == 0) { return nullptr; }
+
+        *mask |= ComponentBit<T>();
+        T* added = &Pool<T>().Add(entity, std::move(component));
+        OnComponentAdded(entity, ComponentTypeId<T>());
+        return added;
+    }
+
+    template <typename T>
+    bool Remove(Entity entity)
+    {
+        ComponentMask* mask = m_entities.Get(entity);
+        if (!mask || !(*mask & ComponentBit<T>())) { return false; }
+
+        *mask &= ~ComponentBit<T>();
+        OnComponentRemoved(entity, ComponentTypeId<T>());
+        return Pool<T>().Remove(entity);
+    }
+
+    template <typename T>
+    T* Get(Entity entity)
+    {
+        const ComponentMask* mask = m_entities.Get(entity);
+        return mask && (*mask & ComponentBit<T>()) ? Pool<T>().Get(entity) : nullptr;
+    }
+
+    template <typename T>
+    bool Has(Entity entity) const
+    {
+        const ComponentMask* mask = m_entities.Get(entity);
+        return mask && (*mask & ComponentBit<T>());
+    }
+
+    template <typename... Ts>
+    SceneView<Ts...> View()
+    {
+        return SceneView<Ts...>(std::make_tuple(&Pool<Ts>()...));
+    }
+
+    template <typename T>
+    ComponentPool<T>& Pool()
+    {
+        uint32_t id = ComponentTypeId<T>();
+        if (id >= m_pools.size()) { m_pools.resize(id + 1); }
+        if (!m_pools[id]) { m_pools[id] = std::make_unique<ComponentPool<T>>(); }
+        return static_cast<ComponentPool<T>&>(*m_pools[id]);
+    }
+
+    // Отложенные структурные изменения, применяются по порядку в FlushCommands
+    template <typename T>
+    void DeferAdd(Entity entity, T component)
+    {
+        m_commands.push_back([entity, component = std::move(component)](Scene& scene) mutable {
+            scene.Add<T>(entity, std::move(component));
+        });
+    }
+
+    template <typename T>
+    void DeferRemove(Entity entity)
+    {
+        m_commands.push_back([entity](Scene& scene) { scene.Remove<T>(entity); });
+    }
+
+    void DeferDestroy(Entity entity) { m_destroyed.push_back(entity); }
+    // Уничтожение идет после остальных команд - Add к уже уничтоженной сущности ничего не сделает
+    void FlushCommands();
+
+    // Иерархия преобразований. Transform, измененный через Get, не пересчитывается - менять его нужно
+    // через EditTransform, который помечает поддерево сущности к пересчету
+    Transform* EditTransform(Entity entity);
+    // Локальное преобразование child становится относительным parent (пустой - корень)
+    bool       SetParent(Entity child, Entity parent) { return m_hierarchy.SetParent(child, parent); }
+    Entity     GetParent(Entity entity) const { return m_hierarchy.GetParent(entity); }
+
+    const TransformHierarchy& GetHierarchy() const { return m_hierarchy; }
+
+    // Матрицы WorldTransform помеченных поддеревьев и мировые боксы их сущностей в пространственных индексах
+    void UpdateTransforms();
+    // Пакеты отрисовки сущностей с WorldTransform, MeshComponent и MaterialComponent. Сущности в пространственных
+    // индексах отсекаются по пирамиде видимости камеры кадра: индексы отбрасывают невидимые ветки, оставшиеся
+    // боксы проверяет FrustumCuller (большие наборы - на пуле потоков). Остальные рисуются всегда.
+    // С включенным Renderer::EnableGpuCulling сущности с Bounds и программой на DrawDataBuffer отправляются все,
+    // а отсекает их cull.comp (разрешение их потоковых текстур оценивается без учета видимости).
+    // Сущности с программой на атрибутах экземпляра (instanced.vert) сливаются в SubmitInstanced по мешу и
+    // массиву текстур, слой каждой приходит из AcquireTextureLayer. VAO их меша создается с InstanceData::Layout().
+    // Вызывается после того, как приложение выставило камеру кадра (Renderer::SetCamera)
+    void SubmitDraws(Renderer& renderer, ThreadPool* pool = nullptr);
+    // Сколько боксов проверено и осталось видимыми в последнем SubmitDraws
+    const FrustumCuller::Stats& GetCullStats() const { return m_culler.GetStats(); }
+
+    // Пространственные индексы сущностей с Transform, WorldTransform и Bounds. Движущиеся живут в свободном
+    // октодереве и переносятся в нем при каждом пересчете матрицы, сущности со StaticObject попадают в BVH
+    // при RebuildStaticIndex - его вызывают после загрузки уровня или пакетного добавления статики
+    void RebuildStaticIndex(ThreadPool* pool = nullptr);
+    // Корневая ячейка октодерева, проиндексированные движущиеся сущности переносятся в новое дерево
+    void SetDynamicIndexBounds(const glm::vec3& center, float halfSize, uint32_t maxDepth);
+    bool IsIndexed(Entity entity) const { return m_staticIndex.Contains(entity) || m_dynamicIndex.Contains(entity); }
+
+    // Выбор лучом: ближайшая сущность, чей мировой AABB пересекает луч в пределах maxDistance
+    bool Raycast(const Ray& ray, float maxDistance, Entity& entity, float& distance) const;
+    // Сущности, чьи мировые AABB пересекают бокс (запросы близости)
+    void QueryAabb(const Aabb& bounds, std::vector<Entity>& result) const;
+
+    const Bvh&         GetStaticIndex() const { return m_staticIndex; }
+    const LooseOctree& GetDynamicIndex() const { return m_dynamicIndex; }
+
+private:
+    // Поддержка иерархии и пространственных индексов при добавлении и удалении компонентов
+    void OnComponentAdded(Entity entity, uint32_t typeId);
+    void OnComponentRemoved(Entity entity, uint32_t typeId);
+    // Мировой бокс сущности с WorldTransform и Bounds, пустой без них
+    Aabb WorldBounds(Entity entity);
+
+    // 0, если типов компонентов больше MAX_COMPONENT_TYPES - такой компонент не добавится
+    template <typename T>
+    static ComponentMask ComponentBit()
+    {
+        uint32_t id = ComponentTypeId<T>();
+        return id < MAX_COMPONENT_TYPES ? ComponentMask(1) << id : 0;
+    }
+
+    SlotMap<ComponentMask, Entity>                  m_entities; // Набор компонентов каждой живой сущности
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_pools;    // Пул по ComponentTypeId
+    std::vector<std::function<void(Scene&)>>        m_commands;
+    std::vector<Entity>                             m_destroyed;
+    TransformHierarchy                              m_hierarchy;
+    FrustumCuller                                   m_culler;
+    Bvh                                             m_staticIndex;
+    LooseOctree                                     m_dynamicIndex;
+};
+#endif // SCENE_H
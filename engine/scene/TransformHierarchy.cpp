@@ -0,0 +1,230 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "TransformHierarchy.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
+
+uint32_t TransformHierarchy::NodeOf(Entity entity) const
+{
+    uint32_t index = entity.GetIndex();
+    if (!entity || index >= m_nodeOfEntity.size()) { return NO_NODE; }
+
+    uint32_t node = m_nodeOfEntity[index];
+    return node != NO_NODE && m_entities[node] == entity ? node : NO_NODE;
+}
+
+void TransformHierarchy::Insert(Entity entity)
+{
+    if (NodeOf(entity) != NO_NODE)
+    {
+        MarkDirty(entity);
+        return;
+    }
+
+    // Корень в конце массивов не нарушает порядок обхода - перестройка не нужна
+    auto node = static_cast<uint32_t>(m_entities.size());
+    m_entities.push_back(entity);
+    m_parents.push_back(NO_NODE);
+    m_subtreeSizes.push_back(1);
+    m_dirty.push_back(1);
+    m_world.emplace_back(1.0f);
+    m_dirtyNodes.push_back(node);
+
+    uint32_t index = entity.GetIndex();
+    if (index >= m_nodeOfEntity.size()) { m_nodeOfEntity.resize(index + 1, NO_NODE); }
+    m_nodeOfEntity[index] = node;
+}
+
+void TransformHierarchy::Remove(Entity entity)
+{
+    uint32_t node = NodeOf(entity);
+    if (node == NO_NODE) { return; }
+
+    m_entities[node]                  = {};
+    m_nodeOfEntity[entity.GetIndex()] = NO_NODE;
+    m_orderDirty                      = true;
+    ++m_removedCount;
+}
+
+void TransformHierarchy::Clear()
+{
+    m_entities.clear();
+    m_parents.clear();
+    m_subtreeSizes.clear();
+    m_dirty.clear();
+    m_world.clear();
+    m_nodeOfEntity.clear();
+    m_dirtyNodes.clear();
+    m_orderDirty   = false;
+    m_removedCount = 0;
+    m_updatedCount = 0;
+}
+
+bool TransformHierarchy::SetParent(Entity child, Entity parent)
+{
+    uint32_t childNode  = NodeOf(child);
+    uint32_t parentNode = parent ? NodeOf(parent) : NO_NODE;
+    if (childNode == NO_NODE || (parent && parentNode == NO_NODE)) { return false; }
+
+    // Узел не может стать потомком собственного поддерева
+    for (uint32_t node = parentNode; node != NO_NODE; node = m_parents[node])
+    {
+        if (node == childNode) { return false; }
+    }
+
+    if (m_parents[childNode] == parentNode) { return true; }
+
+    m_parents[childNode] = parentNode;
+    m_orderDirty         = true;
+    MarkDirty(child);
+    return true;
+}
+
+Entity TransformHierarchy::GetParent(Entity entity) const
+{
+    uint32_t node = NodeOf(entity);
+    if (node == NO_NODE || m_parents[node] == NO_NODE) { return {}; }
+    return m_entities[m_parents[node]];
+}
+
+void TransformHierarchy::MarkDirty(Entity entity)
+{
+    uint32_t node = NodeOf(entity);
+    if (node == NO_NODE || m_dirty[node]) { return; }
+
+    m_dirty[node] = 1;
+    m_dirtyNodes.push_back(node);
+}
+
+void TransformHierarchy::Rebuild()
+{
+    const auto count = static_cast<uint32_t>(m_entities.size());
+
+    // Списки потомков. Узлы добавляются в голову списка по возрастанию, поэтому список идет по убыванию -
+    // при обходе стеком потомки достаются в исходном порядке
+    std::vector<uint32_t> firstChild(count, NO_NODE);
+    std::vector<uint32_t> nextSibling(count, NO_NODE);
+    std::vector<uint32_t> roots;
+    for (uint32_t node = 0; node < count; ++node)
+    {
+        if (!m_entities[node]) { continue; }
+
+        uint32_t parent = m_parents[node];
+        if (parent != NO_NODE && !m_entities[parent])
+        {
+            // Родитель удален - узел становится корнем, его мировая матрица меняется
+            parent          = NO_NODE;
+            m_parents[node] = NO_NODE;
+            m_dirty[node]   = 1;
+        }
+
+        if (parent == NO_NODE) { roots.push_back(node); }
+        else
+        {
+            nextSibling[node]  = firstChild[parent];
+            firstChild[parent] = node;
+        }
+    }
+
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> stack;
+    order.reserve(count - m_removedCount);
+    for (uint32_t root : roots)
+    {
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            uint32_t node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+            for (uint32_t child = firstChild[node]; child != NO_NODE; child = nextSibling[child])
+            {
+                stack.push_back(child);
+            }
+        }
+    }
+
+    std::vector<uint32_t> newIndex(count, NO_NODE);
+    for (uint32_t i = 0; i < order.size(); ++i) { newIndex[order[i]] = i; }
+
+    const auto             size = static_cast<uint32_t>(order.size());
+    std::vector<Entity>    entities(size);
+    std::vector<uint32_t>  parents(size);
+    std::vector<uint8_t>   dirty(size);
+    std::vector<glm::mat4> world(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        uint32_t old = order[i];
+        entities[i]  = m_entities[old];
+        parents[i]   = m_parents[old] != NO_NODE ? newIndex[m_parents[old]] : NO_NODE;
+        dirty[i]     = m_dirty[old];
+        world[i]     = m_world[old];
+
+        m_nodeOfEntity[entities[i].GetIndex()] = i;
+    }
+
+    // Размеры поддеревьев снизу вверх - родитель всегда левее потомка
+    std::vector<uint32_t> subtreeSizes(size, 1);
+    for (uint32_t i = size; i-- > 0;)
+    {
+        if (parents[i] != NO_NODE) { subtreeSizes[parents[i]] += subtreeSizes[i]; }
+    }
+
+    m_entities     = std::move(entities);
+    m_parents      = std::move(parents);
+    m_dirty        = std::move(dirty);
+    m_world        = std::move(world);
+    m_subtreeSizes = std::move(subtreeSizes);
+
+    m_dirtyNodes.clear();
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (m_dirty[i]) { m_dirtyNodes.push_back(i); }
+    }
+
+    m_orderDirty   = false;
+    m_removedCount = 0;
+}
+
+void TransformHierarchy::Update(ComponentPool<Transform>& locals, ComponentPool<WorldTransform>& worlds)
+{
+    m_updatedCount = 0;
+    if (m_orderDirty) { Rebuild(); }
+    if (m_dirtyNodes.empty()) { return; }
+
+    // Помеченный узел внутри уже взятого поддерева пересчитается вместе с ним
+    std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+    m_batch.clear();
+    uint32_t coveredEnd = 0;
+    for (uint32_t node : m_dirtyNodes)
+    {
+        if (node < coveredEnd) { continue; }
+
+        coveredEnd = node + m_subtreeSizes[node];
+        for (uint32_t i = node; i < coveredEnd; ++i) { m_batch.push_back(i); }
+    }
+    m_dirtyNodes.clear();
+
+    const size_t count = m_batch.size();
+    m_batchLocals.resize(count);
+    m_batchMatrices.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Transform* local = locals.Get(m_entities[m_batch[i]]);
+        m_batchLocals[i]       = local ? *local : Transform{};
+    }
+
+    // Локальные матрицы независимы и считаются пакетом, мировые - по порядку, родитель раньше потомков
+    TransformKernels::ComposeLocal(m_batchLocals.data(), m_batchMatrices.data(), count);
+    TransformKernels::ComposeWorld(m_batch.data(), count, m_parents.data(), m_batchMatrices.data(), m_world.data());
+
+    for (uint32_t node : m_batch)
+    {
+        m_dirty[node] = 0;
+        if (WorldTransform* world = worlds.Get(m_entities[node])) { world->matrix = m_world[node]; }
+    }
+    m_updatedCount = count;
+}
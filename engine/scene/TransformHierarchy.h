@@ -0,0 +1,76 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef TRANSFORMHIERARCHY_H
+#define TRANSFORMHIERARCHY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ComponentPool.h"
+#include "Components.h"
+#include "Entity.h"
+
+/**
+ * Иерархия преобразований сущностей с Transform
+ * Узлы лежат в плоских массивах в порядке обхода в глубину: родитель всегда раньше потомков,
+ * а поддерево узла i - непрерывный диапазон [i, i + subtreeSize[i]). Изменение Transform помечает узел,
+ * Update пересчитывает только поддеревья помеченных узлов - стоимость пропорциональна изменившемуся.
+ * Смена родителя и удаление узлов откладывают перестройку порядка до следующего Update.
+ */
+class TransformHierarchy
+{
+public:
+    static constexpr uint32_t NO_NODE = ~0u;
+
+    // Новый узел - корень, помеченный к пересчету
+    void Insert(Entity entity);
+    // Потомки удаленного узла становятся корнями с прежними локальными преобразованиями
+    void Remove(Entity entity);
+    void Clear();
+
+    // Пустой parent - сделать корнем. false, если узла нет или родитель - потомок child
+    bool   SetParent(Entity child, Entity parent);
+    Entity GetParent(Entity entity) const;
+
+    void MarkDirty(Entity entity);
+
+    // Пересчет мировых матриц помеченных поддеревьев, результат попадает в WorldTransform сущностей
+    void Update(ComponentPool<Transform>& locals, ComponentPool<WorldTransform>& worlds);
+
+    size_t GetNodeCount() const { return m_entities.size() - m_removedCount; }
+    // Число узлов, пересчитанных последним Update
+    size_t GetUpdatedCount() const { return m_updatedCount; }
+    // Сущность i-го пересчитанного узла, i < GetUpdatedCount()
+    Entity GetUpdatedEntity(size_t i) const { return m_entities[m_batch[i]]; }
+
+private:
+    uint32_t NodeOf(Entity entity) const;
+    // Порядок обхода в глубину без удаленных узлов
+    void     Rebuild();
+
+    // Узлы в порядке обхода
+    std::vector<Entity>    m_entities; // Пустая сущность - узел удален, ждет Rebuild
+    std::vector<uint32_t>  m_parents;
+    std::vector<uint32_t>  m_subtreeSizes;
+    std::vector<uint8_t>   m_dirty;
+    std::vector<glm::mat4> m_world; // Мировые матрицы - родители непомеченных поддеревьев берутся отсюда
+
+    std::vector<uint32_t> m_nodeOfEntity; // Индекс сущности -> узел
+    std::vector<uint32_t> m_dirtyNodes;   // Помеченные узлы, возможны повторы после Rebuild
+    bool                  m_orderDirty   = false;
+    size_t                m_removedCount = 0;
+    size_t                m_updatedCount = 0;
+
+    // Временные массивы пакета пересчета
+    std::vector<uint32_t>  m_batch;
+    std::vector<Transform> m_batchLocals;
+    std::vector<glm::mat4> m_batchMatrices;
+};
+#endif // TRANSFORMHIERARCHY_H
@@ -0,0 +1,174 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "TransformKernels.h"
+#include "../utils/SimdMath.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr uint32_t NO_PARENT   = ~0u;
+    constexpr float    HALF_RADIAN = 0.00872664626f; // pi / 360 - половина угла в радианах
+
+    // Кватернион поворота Rx * Ry * Rz из половин углов
+    struct Rotation
+    {
+        float x, y, z, w;
+    };
+
+    Rotation EulerToQuaternion(const glm::vec3& degrees)
+    {
+        float sx = std::sin(degrees.x * HALF_RADIAN), cx = std::cos(degrees.x * HALF_RADIAN);
+        float sy = std::sin(degrees.y * HALF_RADIAN), cy = std::cos(degrees.y * HALF_RADIAN);
+        float sz = std::sin(degrees.z * HALF_RADIAN), cz = std::cos(degrees.z * HALF_RADIAN);
+        return {sx * cy * cz + cx * sy * sz,
+                cx * sy * cz - sx * cy * sz,
+                cx * cy * sz + sx * sy * cz,
+                cx * cy * cz - sx * sy * sz};
+    }
+
+    void ComposeLocalScalar(const Transform& local, glm::mat4& out)
+    {
+        Rotation q = EulerToQuaternion(local.rotation);
+
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        out[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * local.scale.x;
+        out[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * local.scale.y;
+        out[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * local.scale.z;
+        out[3] = glm::vec4(local.position, 1.0f);
+    }
+
+#if defined(YAGL_SIMD_SSE2)
+    // Четыре узла за раз: в дорожке k регистра - величина узла k. Синусы считаются скалярно,
+    // кватернион, матрица поворота и масштаб - векторно, в конце 4x4 транспонирование в столбцы матриц
+    void ComposeLocal4(const Transform* locals, glm::mat4* out)
+    {
+        alignas(16) float qx[4], qy[4], qz[4], qw[4], sx[4], sy[4], sz[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            Rotation q = EulerToQuaternion(locals[k].rotation);
+            qx[k]      = q.x;
+            qy[k]      = q.y;
+            qz[k]      = q.z;
+            qw[k]      = q.w;
+            sx[k]      = locals[k].scale.x;
+            sy[k]      = locals[k].scale.y;
+            sz[k]      = locals[k].scale.z;
+        }
+
+        __m128 x = _mm_load_ps(qx), y = _mm_load_ps(qy), z = _mm_load_ps(qz), w = _mm_load_ps(qw);
+        __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        __m128 scaleX = _mm_load_ps(sx), scaleY = _mm_load_ps(sy), scaleZ = _mm_load_ps(sz);
+
+        // Элементы столбцов матрицы поворота, сразу умноженные на масштаб
+        __m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX);
+        __m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX);
+        __m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX);
+        __m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY);
+        __m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY);
+        __m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY);
+        __m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ);
+        __m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ);
+        __m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ);
+        __m128 m03 = _mm_setzero_ps();
+
+        _MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+        __m128 m13 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+        __m128 m23 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+
+        // После транспонирования m0k - первый столбец узла k (m00, m01, m02, m03 по порядку узлов)
+        const __m128 column0[4] = {m00, m01, m02, m03};
+        const __m128 column1[4] = {m10, m11, m12, m13};
+        const __m128 column2[4] = {m20, m21, m22, m23};
+        for (int k = 0; k < 4; ++k)
+        {
+            _mm_storeu_ps(&out[k][0][0], column0[k]);
+            _mm_storeu_ps(&out[k][1][0], column1[k]);
+            _mm_storeu_ps(&out[k][2][0], column2[k]);
+            out[k][3] = glm::vec4(locals[k].position, 1.0f);
+        }
+    }
+#endif
+} // namespace
+
+namespace TransformKernels
+{
+    void ComposeLocal(const Transform* locals, glm::mat4* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(YAGL_SIMD_SSE2)
+        for (; i + 4 <= count; i += 4) { ComposeLocal4(locals + i, out + i); }
+#endif
+        for (; i < count; ++i) { ComposeLocalScalar(locals[i], out[i]); }
+    }
+
+    void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+    {
+#if defined(YAGL_SIMD_AVX)
+        // Столбцы a продублированы в обе половины - каждая инструкция считает два столбца результата
+        __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[0][0]));
+        __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[1][0]));
+        __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[2][0]));
+        __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[3][0]));
+
+        glm::mat4 result;
+        for (int column = 0; column < 4; column += 2)
+        {
+            const float* b0 = &b[column][0];
+            const float* b1 = &b[column + 1][0];
+
+            __m256 r = _mm256_mul_ps(a0, _mm256_setr_m128(_mm_set1_ps(b0[0]), _mm_set1_ps(b1[0])));
+            r        = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_setr_m128(_mm_set1_ps(b0[1]), _mm_set1_ps(b1[1]))));
+            r        = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_setr_m128(_mm_set1_ps(b0[2]), _mm_set1_ps(b1[2]))));
+            r        = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_setr_m128(_mm_set1_ps(b0[3]), _mm_set1_ps(b1[3]))));
+            _mm256_storeu_ps(&result[column][0], r);
+        }
+        out = result;
+#elif defined(YAGL_SIMD_SSE2)
+        __m128 a0 = _mm_loadu_ps(&a[0][0]);
+        __m128 a1 = _mm_loadu_ps(&a[1][0]);
+        __m128 a2 = _mm_loadu_ps(&a[2][0]);
+        __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+        // Результат собирается во временной матрице - out может совпадать с a или b
+        glm::mat4 result;
+        for (int column = 0; column < 4; ++column)
+        {
+            const float* bc = &b[column][0];
+
+            __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+            r        = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+            r        = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+            r        = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+            _mm_storeu_ps(&result[column][0], r);
+        }
+        out = result;
+#else
+        out = a * b;
+#endif
+    }
+
+    void ComposeWorld(const uint32_t* nodes, size_t count, const uint32_t* parents, const glm::mat4* locals,
+                      glm::mat4* world)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t node   = nodes[i];
+            uint32_t parent = parents[node];
+            if (parent == NO_PARENT) { world[node] = locals[i]; }
+            else { Multiply(world[parent], locals[i], world[node]); }
+        }
+    }
+} // namespace TransformKernels
@@ -0,0 +1,35 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef TRANSFORMKERNELS_H
+#define TRANSFORMKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Components.h"
+
+/**
+ * Пакетные ядра пересчета матриц иерархии
+ * С SSE2 четыре узла обрабатываются одновременно (по узлу в каждой дорожке регистра),
+ * произведение матриц идет по столбцам (с AVX - по два столбца за инструкцию)
+ */
+namespace TransformKernels
+{
+    // Матрицы T * Rx * Ry * Rz * S, поворот через кватернион из углов Эйлера (градусы)
+    void ComposeLocal(const Transform* locals, glm::mat4* out, size_t count);
+
+    // out = a * b
+    void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out);
+
+    // world[nodes[i]] = world[parents[nodes[i]]] * locals[i]. Узлы идут по возрастанию, родитель раньше потомков;
+    // parents[node] == ~0u - корень, его мировая матрица равна локальной
+    void ComposeWorld(const uint32_t* nodes, size_t count, const uint32_t* parents, const glm::mat4* locals,
+                      glm::mat4* world);
+} // namespace TransformKernels
+#endif // TRANSFORMKERNELS_H
@@ -0,0 +1,120 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "AssetPack.h"
+#include "Logger.h"
+
+bool AssetPack::Open(const std::string& path)
+{
+    Close();
+    if (!m_file.Open(path)) { return false; }
+
+    const uint8_t* base = m_file.GetData();
+    size_t         size = m_file.GetSize();
+
+    const auto* header = reinterpret_cast<const YpakHeader*>(base);
+    if (size < sizeof(YpakHeader) || header->magic != YPAK_MAGIC || header->version != YPAK_VERSION)
+    {
+        LOG_ERROR("Asset pack {} is corrupted or has an unsupported version", path);
+        Close();
+        return false;
+    }
+
+    // Таблицы должны целиком лежать внутри файла, а число корзин - быть степенью двойки.
+    // Хотя бы одна корзина пуста - иначе поиск отсутствующего имени не остановится на пустой корзине
+    uint64_t entriesEnd = header->entriesOffset + static_cast<uint64_t>(header->entryCount) * sizeof(YpakEntry);
+    uint64_t bucketsEnd = header->bucketsOffset + static_cast<uint64_t>(header->bucketCount) * sizeof(uint32_t);
+    bool     powerOfTwo = header->bucketCount != 0 && (header->bucketCount & (header->bucketCount - 1)) == 0;
+    if (!powerOfTwo || header->bucketCount <= header->entryCount || entriesEnd > size || bucketsEnd > size ||
+        header->stringsOffset > size)
+    {
+        LOG_ERROR("Asset pack {} has an invalid table of contents", path);
+        Close();
+        return false;
+    }
+
+    // Имена записей тоже проверяются один раз здесь - поиск читает их без проверок границ
+    const auto* entries = reinterpret_cast<const YpakEntry*>(base + header->entriesOffset);
+    for (uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        uint64_t nameEnd = header->stringsOffset + static_cast<uint64_t>(entries[i].nameOffset) + entries[i].nameLength;
+        if (nameEnd > size)
+        {
+            LOG_ERROR("Asset pack {} has an entry name outside the file", path);
+            Close();
+            return false;
+        }
+    }
+
+    m_header  = header;
+    m_entries = entries;
+    m_buckets = reinterpret_cast<const uint32_t*>(base + header->bucketsOffset);
+    m_strings = reinterpret_cast<const char*>(base + header->stringsOffset);
+
+    LOG_INFO("Asset pack {} opened: {} entries, {} KB", path, header->entryCount, size / 1024);
+    return true;
+}
+
+void AssetPack::Close()
+{
+    m_file.Close();
+    m_header  = nullptr;
+    m_entries = nullptr;
+    m_buckets = nullptr;
+    m_strings = nullptr;
+}
+
+const YpakEntry* AssetPack::FindEntry(std::string_view name) const
+{
+    if (!m_header) { return nullptr; }
+
+    uint64_t hash = YpakHashName(name);
+    uint32_t mask = m_header->bucketCount - 1;
+
+    // Линейное пробирование до пустой корзины. Полное сравнение имени - только при совпадении хэша
+    for (uint32_t probe = 0; probe <= mask; ++probe)
+    {
+        uint32_t index = m_buckets[(static_cast<uint32_t>(hash) + probe) & mask];
+        if (index == YPAK_EMPTY_BUCKET || index >= m_header->entryCount) { return nullptr; }
+
+        const YpakEntry& entry = m_entries[index];
+        if (entry.nameHash != hash || entry.nameLength != name.size()) { continue; }
+
+        std::string_view stored = GetEntryName(index);
+        bool             equal  = stored.size() == name.size();
+        for (size_t i = 0; i < name.size() && equal; ++i) { equal = stored[i] == YpakToLower(name[i]); }
+        if (equal) { return &entry; }
+    }
+    return nullptr;
+}
+
+AssetPack::Blob AssetPack::Find(std::string_view name) const
+{
+    const YpakEntry* entry = FindEntry(name);
+    if (!entry) { return {}; }
+
+    if (entry->flags & YPAK_ENTRY_COMPRESSED)
+    {
+        LOG_ERROR("Asset {} is compressed, compressed pack entries are not supported", name);
+        return {};
+    }
+
+    if (entry->dataOffset > m_file.GetSize() || entry->size > m_file.GetSize() - entry->dataOffset)
+    {
+        LOG_ERROR("Asset {} points outside of the pack", name);
+        return {};
+    }
+
+    return {m_file.GetData() + entry->dataOffset, static_cast<size_t>(entry->size)};
+}
+
+std::string_view AssetPack::GetEntryName(uint32_t index) const
+{
+    if (!m_header || index >= m_header->entryCount) { return {}; }
+
+    const YpakEntry& entry = m_entries[index];
+    uint64_t         end   = m_header->stringsOffset + entry.nameOffset + entry.nameLength;
+    if (end > m_file.GetSize()) { return {}; }
+    return {m_strings + entry.nameOffset, entry.nameLength};
+}
@@ -0,0 +1,56 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AssetPackFormat.h"
+#include "MappedFile.h"
+
+/**
+ * Пакет ассетов .ypak, отображенный в память
+ * Поиск по имени - одна проба хэш-таблицы из файла, данные отдаются срезом отображения без копирования.
+ * Срезы действительны, пока пакет открыт.
+ */
+class AssetPack
+{
+public:
+    struct Blob
+    {
+        const uint8_t* data = nullptr;
+        size_t         size = 0;
+
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    // false - файла нет или он поврежден
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_header != nullptr; }
+
+    // Поиск без учета регистра
+    Blob Find(std::string_view name) const;
+    bool Contains(std::string_view name) const { return FindEntry(name) != nullptr; }
+
+    uint32_t         GetEntryCount() const { return m_header ? m_header->entryCount : 0; }
+    std::string_view GetEntryName(uint32_t index) const;
+
+private:
+    const YpakEntry* FindEntry(std::string_view name) const;
+
+    MappedFile        m_file;
+    const YpakHeader* m_header  = nullptr;
+    const YpakEntry*  m_entries = nullptr;
+    const uint32_t*   m_buckets = nullptr;
+    const char*       m_strings = nullptr;
+};
+#endif // ASSETPACK_H
@@ -0,0 +1,77 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef ASSETPACKFORMAT_H
+#define ASSETPACKFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Формат пакета ассетов .ypak - один файл вместо дерева assets
+ * Создается утилитой yagl_pack, читается AssetPack через отображение в память.
+ *
+ * Раскладка: YpakHeader | YpakEntry[entryCount] | uint32 buckets[bucketCount] | строки имен | данные
+ * Имена хранятся в нижнем регистре, поиск - хэш-таблица с линейным пробированием прямо в файле.
+ * Данные каждой записи выровнены на YPAK_DATA_ALIGNMENT, поэтому .ytex внутри пакета сохраняет свое выравнивание.
+ * Все числа little-endian.
+ */
+
+constexpr uint32_t YPAK_MAGIC          = 0x4B415059; // "YPAK"
+constexpr uint16_t YPAK_VERSION        = 1;
+constexpr uint32_t YPAK_DATA_ALIGNMENT = 64;
+constexpr uint32_t YPAK_EMPTY_BUCKET   = 0xFFFFFFFFu;
+
+enum YpakEntryFlags : uint32_t
+{
+    // Зарезервировано под сжатие записей (LZ4/zstd). Сейчас yagl_pack пишет данные без сжатия,
+    // а AssetPack отказывается отдавать записи с этим флагом
+    YPAK_ENTRY_COMPRESSED = 1 << 0,
+};
+
+struct YpakHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t entryCount;
+    uint32_t bucketCount; // Степень двойки, не меньше 2 * entryCount
+    uint64_t entriesOffset;
+    uint64_t bucketsOffset;
+    uint64_t stringsOffset;
+    uint64_t reserved;
+};
+
+struct YpakEntry
+{
+    uint64_t nameHash;   // YpakHashName(имя в нижнем регистре)
+    uint32_t nameOffset; // От stringsOffset
+    uint32_t nameLength;
+    uint64_t dataOffset; // От начала файла
+    uint64_t size;       // Размер исходных данных
+    uint64_t storedSize; // Размер в пакете (отличается только для сжатых записей)
+    uint32_t flags;      // YpakEntryFlags
+    uint32_t reserved;
+};
+
+static_assert(sizeof(YpakHeader) == 48, "YpakHeader layout is part of the file format");
+static_assert(sizeof(YpakEntry) == 48, "YpakEntry layout is part of the file format");
+
+inline char YpakToLower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+// FNV-1a 64 без учета регистра - тот же хэш считает утилита при сборке пакета
+inline uint64_t YpakHashName(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : name)
+    {
+        hash ^= static_cast<uint8_t>(YpakToLower(c));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+#endif // ASSETPACKFORMAT_H
@@ -0,0 +1,151 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "FileWatcher.h"
+#include "Logger.h"
+
+#include <filesystem>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+FileWatcher::~FileWatcher() { Shutdown(); }
+
+#ifdef __linux__
+
+namespace
+{
+    // Сохранение файла (запись или атомарная замена переименованием) и появление новых подпапок
+    constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+} // namespace
+
+bool FileWatcher::Initialize(std::chrono::milliseconds debounce)
+{
+    Shutdown();
+    m_debounce = debounce;
+    m_fd       = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd == -1)
+    {
+        LOG_WARN("inotify is unavailable, file watching disabled");
+        return false;
+    }
+    return true;
+}
+
+void FileWatcher::Shutdown()
+{
+    if (m_fd != -1)
+    {
+        close(m_fd); // Закрытие дескриптора снимает и все наблюдения
+        m_fd = -1;
+    }
+    m_watches.clear();
+    m_pending.clear();
+}
+
+void FileWatcher::AddWatch(const std::string& path)
+{
+    int watch = inotify_add_watch(m_fd, path.c_str(), WATCH_MASK);
+    if (watch == -1)
+    {
+        LOG_WARN("Failed to watch directory {}", path);
+        return;
+    }
+    m_watches[watch] = path;
+}
+
+bool FileWatcher::AddDirectory(const std::string& path)
+{
+    if (m_fd == -1 || !fs::is_directory(path)) { return false; }
+
+    AddWatch(path);
+    std::error_code error;
+    for (const auto& entry : fs::recursive_directory_iterator(path, error))
+    {
+        if (entry.is_directory()) { AddWatch(entry.path().string()); }
+    }
+    return true;
+}
+
+void FileWatcher::Poll(std::vector<std::string>& changed)
+{
+    if (m_fd == -1) { return; }
+
+    Clock::time_point now = Clock::now();
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (true)
+    {
+        ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) { break; } // EAGAIN - событий больше нет
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                LOG_WARN("File watcher queue overflowed, some changes were missed");
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                m_watches.erase(event->wd);
+                continue;
+            }
+
+            auto watch = m_watches.find(event->wd);
+            if (watch == m_watches.end() || event->len == 0) { continue; }
+
+            std::string path = watch->second + "/" + event->name;
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) { AddDirectory(path); }
+                continue;
+            }
+
+            // IN_CREATE без записи - пустой файл, содержимое придет следующим событием
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) { m_pending[path] = now; }
+        }
+    }
+
+    for (auto it = m_pending.begin(); it != m_pending.end();)
+    {
+        if (now - it->second >= m_debounce)
+        {
+            changed.push_back(it->first);
+            it = m_pending.erase(it);
+        }
+        else { ++it; }
+    }
+}
+
+#else
+
+bool FileWatcher::Initialize(std::chrono::milliseconds debounce)
+{
+    m_debounce = debounce;
+    LOG_WARN("File watching is only supported on Linux");
+    return false;
+}
+
+void FileWatcher::Shutdown()
+{
+    m_watches.clear();
+    m_pending.clear();
+}
+
+void FileWatcher::AddWatch(const std::string&) {}
+
+bool FileWatcher::AddDirectory(const std::string&) { return false; }
+
+void FileWatcher::Poll(std::vector<std::string>&) {}
+
+#endif
@@ -0,0 +1,52 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Наблюдение за изменениями файлов в папках (inotify на Linux, на остальных платформах - заглушка)
+ * События читаются без блокировки из Poll на главном потоке. Редакторы сохраняют файл серией записей
+ * и переименований, поэтому файл попадает в результат только после DEBOUNCE тишины по нему.
+ */
+class FileWatcher
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds DEFAULT_DEBOUNCE{200};
+
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&)            = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // false - платформа не поддерживается или inotify недоступен
+    bool Initialize(std::chrono::milliseconds debounce = DEFAULT_DEBOUNCE);
+    void Shutdown();
+    bool IsActive() const { return m_fd != -1; }
+
+    // Рекурсивно, новые подпапки добавляются автоматически
+    bool AddDirectory(const std::string& path);
+
+    // Полные пути файлов, изменения которых утихли
+    void Poll(std::vector<std::string>& changed);
+
+private:
+    void AddWatch(const std::string& path);
+
+    int                                                m_fd = -1;
+    std::chrono::milliseconds                          m_debounce{DEFAULT_DEBOUNCE};
+    std::unordered_map<int, std::string>               m_watches; // Дескриптор наблюдения -> папка
+    std::unordered_map<std::string, Clock::time_point> m_pending; // Путь -> время последнего события
+};
+#endif // FILEWATCHER_H
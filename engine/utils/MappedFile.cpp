@@ -0,0 +1,136 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "MappedFile.h"
+#include "Logger.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+#ifdef _WIN32
+        std::swap(m_file, other.m_file);
+        std::swap(m_mapping, other.m_mapping);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LOG_ERROR("Failed to open file {} for mapping", path);
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        LOG_ERROR("Failed to map file {}: empty or unreadable", path);
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void*  data    = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        LOG_ERROR("Failed to map file {}", path);
+        if (mapping) { CloseHandle(mapping); }
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<const uint8_t*>(data);
+    m_size    = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) { UnmapViewOfFile(m_data); }
+    if (m_mapping) { CloseHandle(m_mapping); }
+    if (m_file) { CloseHandle(m_file); }
+
+    m_data    = nullptr;
+    m_size    = 0;
+    m_file    = nullptr;
+    m_mapping = nullptr;
+}
+#else
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        LOG_ERROR("Failed to open file {} for mapping", path);
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        LOG_ERROR("Failed to map file {}: empty or unreadable", path);
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // Отображение держит файл само - дескриптор больше не нужен
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        LOG_ERROR("Failed to map file {}", path);
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) { munmap(const_cast<uint8_t*>(m_data), m_size); }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
@@ -0,0 +1,45 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Файл, отображенный в память только для чтения (mmap / MapViewOfFile)
+ * Данные подгружаются ОС постранично по мере обращения, без промежуточного буфера и копирования.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // false - файл не найден, пуст или не удалось отобразить
+    bool Open(const std::string& path);
+    void Close();
+
+    bool           IsOpen() const { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t         GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void* m_file    = nullptr; // HANDLE файла
+    void* m_mapping = nullptr; // HANDLE отображения
+#endif
+};
+#endif // MAPPEDFILE_H
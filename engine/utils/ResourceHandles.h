@@ -0,0 +1,18 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef RESOURCEHANDLES_H
+#define RESOURCEHANDLES_H
+
+#include "SlotMap.h"
+
+// Дескрипторы ресурсов ResourceManager. Имя разрешается в дескриптор один раз при загрузке,
+// дальше доступ к ресурсу - индекс в массиве с проверкой поколения
+using TextureHandle = Handle<struct TextureTag>;
+using ShaderHandle  = Handle<struct ShaderTag>;
+using BufferHandle  = Handle<struct BufferTag>;
+
+#endif // RESOURCEHANDLES_H
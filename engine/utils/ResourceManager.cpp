@@ -6,13 +6,121 @@
 #include "../../third_party/stb/stb_image.h"
 #include "ResourceManager.h"
 #include "Logger.h"
+#include "../render/GLExtensions.h"
+#include "../render/Renderer.h"
+#include "TextureContainer.h"
+#include "ThreadPool.h"
+
+#include <GLFW/glfw3.h>
 
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace fs = std::filesystem;
 
+// S3TC - расширение, а не ядро OpenGL, поэтому отсутствует в сгенерированном glad
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// GL_KHR_parallel_shader_compile - тоже расширение, функция загружается вручную
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace
+{
+    bool SupportsS3TC()
+    {
+        static const bool supported = HasGLExtension("GL_EXT_texture_compression_s3tc");
+        return supported;
+    }
+
+    // При первом вызове разрешает драйверу компилировать шейдеры на стольких потоках, сколько он сочтет нужным
+    bool SupportsParallelShaderCompile()
+    {
+        static const bool supported = [] {
+            using MaxShaderCompilerThreadsFn = void (*)(GLuint);
+
+            const char* function = nullptr;
+            if (HasGLExtension("GL_KHR_parallel_shader_compile")) { function = "glMaxShaderCompilerThreadsKHR"; }
+            else if (HasGLExtension("GL_ARB_parallel_shader_compile")) { function = "glMaxShaderCompilerThreadsARB"; }
+            if (!function) { return false; }
+
+            auto maxThreads = reinterpret_cast<MaxShaderCompilerThreadsFn>(glfwGetProcAddress(function));
+            if (!maxThreads) { return false; }
+
+            maxThreads(0xFFFFFFFFu);
+            LOG_INFO("Parallel shader compilation enabled");
+            return true;
+        }();
+        return supported;
+    }
+
+    // Занимаемая текстурой видеопамять по всем уровням. RGB8 считается как RGBA8 - драйверы выравнивают тексель
+    size_t QueryTextureMemory(GLuint texture)
+    {
+        GLint levels = 0;
+        glGetTextureParameteriv(texture, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+
+        size_t total = 0;
+        for (GLint level = 0; level < levels; ++level)
+        {
+            GLint compressed = GL_FALSE;
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_COMPRESSED, &compressed);
+            if (compressed)
+            {
+                GLint size = 0;
+                glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+                total += static_cast<size_t>(size);
+                continue;
+            }
+
+            // Глубина - число слоев у массива, у обычной текстуры 1
+            GLint width = 0, height = 0, depth = 0, format = 0;
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_WIDTH, &width);
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_HEIGHT, &height);
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_DEPTH, &depth);
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_INTERNAL_FORMAT, &format);
+
+            size_t texelSize = 4;
+            if (format == GL_R8) { texelSize = 1; }
+            else if (format == GL_RG8) { texelSize = 2; }
+            total += static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * texelSize;
+        }
+        return total;
+    }
+
+    // Имя запеченной версии текстуры (см. yagl_texcook)
+    std::string CookedTextureName(const std::string& filename) { return filename + ".ytex"; }
+
+    std::string ToLower(std::string value)
+    {
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        return value;
+    }
+
+    bool HasExtension(std::string_view filename, const std::vector<std::string>& extensions)
+    {
+        size_t dot = filename.find_last_of('.');
+        if (dot == std::string_view::npos) { return false; }
+        std::string extension = ToLower(std::string(filename.substr(dot)));
+        return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }
+
+    const std::vector<std::string> TEXTURE_EXTENSIONS = {".jpg", ".jpeg", ".png", ".bmp", ".tga", ".ytex"};
+    const std::vector<std::string> SHADER_EXTENSIONS  = {".vert", ".frag", ".geom", ".comp"};
+}
+
 ResourceManager& ResourceManager::GetInstance()
 {
     static ResourceManager instance;
@@ -22,8 +130,22 @@ ResourceManager& ResourceManager::GetInstance()
 void ResourceManager::Initialize(const std::string& assetsPath)
 {
     m_assetsPath = assetsPath;
+    m_shutdown   = false;
     LOG_INFO("Initializing ResourceManager with assets path: {}", m_assetsPath);
 
+    // Кэш бинарников программ живет рядом с исполняемым файлом, не внутри assets (или пакета)
+    m_programCache.Initialize(SHADER_CACHE_DIRECTORY);
+
+    // Пакет ассетов заменяет сканирование папок: поиск по имени - проба хэш-таблицы, данные - срезы отображения
+    for (const std::string& packPath : {m_assetsPath + ".ypak", "../" + m_assetsPath + ".ypak"})
+    {
+        if (fs::exists(packPath) && m_pack.Open(packPath))
+        {
+            LOG_INFO("ResourceManager initialized from pack {} ({} entries)", packPath, m_pack.GetEntryCount());
+            return;
+        }
+    }
+
     // Проверяем существование папки assets
     if (!fs::exists(m_assetsPath))
     {
@@ -45,11 +167,11 @@ void ResourceManager::ScanTextures()
 {
     std::vector<std::string> texturePaths = {
         m_assetsPath + "/textures",
-        "../" + m_assetsPath + "/textures"
+        "../" + m_assetsPath + "/textures",
+        m_assetsPath + "/cooked",
+        "../" + m_assetsPath + "/cooked"
     };
 
-    std::vector<std::string> supportedExtensions = {".jpg", ".jpeg", ".png", ".bmp", ".tga"};
-
     for (const auto& texturePath : texturePaths)
     {
         if (!fs::exists(texturePath)) continue;
@@ -60,19 +182,16 @@ void ResourceManager::ScanTextures()
             {
                 if (!entry.is_regular_file()) continue;
 
-                std::string extension = entry.path().extension().string();
-                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-
-                if (std::find(supportedExtensions.begin(), supportedExtensions.end(), extension) != supportedExtensions.
-                    end())
+                std::string filename = entry.path().filename().string();
+                if (HasExtension(filename, TEXTURE_EXTENSIONS))
                 {
-                    std::string filename = entry.path().filename().string();
                     std::string fullPath = entry.path().string();
 
                     // Нормализуем разделители путей
                     std::replace(fullPath.begin(), fullPath.end(), '\\', '/');
 
-                    m_textureFilenames[filename] = fullPath;
+                    // Ключ в нижнем регистре - поиск без учета регистра остается одной пробой хэш-таблицы
+                    m_textureFilenames[ToLower(filename)] = fullPath;
                     LOG_DEBUG("Found texture: {} -> {}", filename, fullPath);
                 }
             }
@@ -91,8 +210,6 @@ void ResourceManager::ScanShaders()
         "../" + m_assetsPath + "/shaders"
     };
 
-    std::vector<std::string> supportedExtensions = {".vert", ".frag", ".geom", ".comp"};
-
     for (const auto& shaderPath : shaderPaths)
     {
         if (!fs::exists(shaderPath)) continue;
@@ -103,19 +220,15 @@ void ResourceManager::ScanShaders()
             {
                 if (!entry.is_regular_file()) continue;
 
-                std::string extension = entry.path().extension().string();
-                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-
-                if (std::find(supportedExtensions.begin(), supportedExtensions.end(), extension) != supportedExtensions.
-                    end())
+                std::string filename = entry.path().filename().string();
+                if (HasExtension(filename, SHADER_EXTENSIONS))
                 {
-                    std::string filename = entry.path().filename().string();
                     std::string fullPath = entry.path().string();
 
                     // Нормализуем разделители путей
                     std::replace(fullPath.begin(), fullPath.end(), '\\', '/');
 
-                    m_shaderFilenames[filename] = fullPath;
+                    m_shaderFilenames[ToLower(filename)] = fullPath;
                     LOG_DEBUG("Found shader: {} -> {}", filename, fullPath);
                 }
             }
@@ -129,33 +242,85 @@ void ResourceManager::ScanShaders()
 
 std::string ResourceManager::FindTexturePath(const std::string& filename) const
 {
-    auto it = m_textureFilenames.find(filename);
-    if (it != m_textureFilenames.end())
+    auto it = m_textureFilenames.find(ToLower(filename));
+    return (it != m_textureFilenames.end()) ? it->second : "";
+}
+
+std::string ResourceManager::FindShaderPath(const std::string& filename) const
+{
+    auto it = m_shaderFilenames.find(ToLower(filename));
+    return (it != m_shaderFilenames.end()) ? it->second : "";
+}
+
+bool ResourceManager::HasTextureData(const std::string& filename) const
+{
+    return m_pack.IsOpen() ? m_pack.Contains(filename) : !FindTexturePath(filename).empty();
+}
+
+bool ResourceManager::HasCookedTexture(const std::string& filename) const
+{
+    std::string cookedName = CookedTextureName(filename);
+    if (m_pack.IsOpen()) { return m_pack.Contains(cookedName); }
+
+    std::string cookedPath = FindTexturePath(cookedName);
+    if (cookedPath.empty()) { return false; }
+
+    // Исходник, сохраненный после запекания, новее запеченной версии - она устарела до следующего запекания
+    std::string sourcePath = FindTexturePath(filename);
+    if (sourcePath.empty()) { return true; }
+
+    std::error_code sourceError;
+    std::error_code cookedError;
+    auto            sourceTime = fs::last_write_time(sourcePath, sourceError);
+    auto            cookedTime = fs::last_write_time(cookedPath, cookedError);
+    if (!sourceError && !cookedError && sourceTime > cookedTime)
+    {
+        LOG_DEBUG("Cooked texture {} is older than {}, using the source", cookedPath, sourcePath);
+        return false;
+    }
+    return true;
+}
+
+bool ResourceManager::OpenTextureData(const std::string& filename, AssetData& asset) const
+{
+    if (m_pack.IsOpen())
     {
-        return it->second;
+        AssetPack::Blob blob = m_pack.Find(filename);
+        asset.data   = blob.data;
+        asset.size   = blob.size;
+        asset.source = filename;
+        return static_cast<bool>(blob);
     }
 
-    // Если не найден, попробуем найти без учета регистра
-    std::string lowerFilename = filename;
-    std::transform(lowerFilename.begin(), lowerFilename.end(), lowerFilename.begin(), ::tolower);
+    std::string path = FindTexturePath(filename);
+    if (path.empty() || !asset.file.Open(path)) { return false; }
 
-    for (const auto& [file, path] : m_textureFilenames)
+    asset.data   = asset.file.GetData();
+    asset.size   = asset.file.GetSize();
+    asset.source = path;
+    return true;
+}
+
+std::string ResourceManager::ReadShaderSource(const std::string& filename) const
+{
+    if (m_pack.IsOpen())
     {
-        std::string lowerFile = file;
-        std::transform(lowerFile.begin(), lowerFile.end(), lowerFile.begin(), ::tolower);
-        if (lowerFile == lowerFilename)
+        AssetPack::Blob blob = m_pack.Find(filename);
+        if (!blob)
         {
-            return path;
+            LOG_ERROR("Shader {} not found in asset pack", filename);
+            return "";
         }
+        return std::string(reinterpret_cast<const char*>(blob.data), blob.size);
     }
 
-    return "";
-}
-
-std::string ResourceManager::FindShaderPath(const std::string& filename) const
-{
-    auto it = m_shaderFilenames.find(filename);
-    return (it != m_shaderFilenames.end()) ? it->second : "";
+    std::string path = FindShaderPath(filename);
+    if (path.empty())
+    {
+        LOG_ERROR("Shader file {} not found in assets directories", filename);
+        return "";
+    }
+    return ReadFile(path);
 }
 
 std::string ResourceManager::ExtractFilename(const std::string& path) const
@@ -164,266 +329,1853 @@ std::string ResourceManager::ExtractFilename(const std::string& path) const
     return (lastSlash != std::string::npos) ? path.substr(lastSlash + 1) : path;
 }
 
-GLuint ResourceManager::LoadShader(const std::string& name, const std::string& vertexSource,
-                                   const std::string& fragmentSource)
+ShaderHandle ResourceManager::AddShaderReference(const std::string& name)
 {
-    if (m_shaders.find(name) != m_shaders.end())
-    {
-        LOG_WARN("Shader {} already loaded", name);
-        return m_shaders[name];
-    }
+    auto it = m_shaderHandles.find(name);
+    if (it == m_shaderHandles.end()) { return {}; }
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const char* vSource = vertexSource.c_str();
-    glShaderSource(vertexShader, 1, &vSource, nullptr);
-    glCompileShader(vertexShader);
+    ShaderEntry* entry = m_shaders.Get(it->second);
+    ++entry->refCount;
+    return it->second;
+}
 
-    GLint success = 0;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+ShaderHandle ResourceManager::LoadShader(const std::string& name, const std::string& vertexSource,
+                                         const std::string& fragmentSource)
+{
+    if (ShaderHandle existing = AddShaderReference(name))
     {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        LOG_ERROR("Vertex shader compilation failed: {}", infoLog);
-        glDeleteShader(vertexShader);
-        return 0;
+        LOG_DEBUG("Shader {} already loaded", name);
+        return existing;
     }
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const char* fSource = fragmentSource.c_str();
-    glShaderSource(fragmentShader, 1, &fSource, nullptr);
-    glCompileShader(fragmentShader);
+    ShaderEntry entry;
+    entry.name     = name;
+    entry.pending  = SubmitProgram(vertexSource, fragmentSource);
+    entry.refCount = 1;
 
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    // Синхронная загрузка - проверка сразу, несобравшаяся программа не получает дескриптор
+    if (!FinalizeShader(entry)) { return {}; }
+
+    ShaderHandle handle   = m_shaders.Insert(std::move(entry));
+    m_shaderHandles[name] = handle;
+    return handle;
+}
+
+ShaderHandle ResourceManager::LoadComputeShader(const std::string& name, const std::string& computeSource)
+{
+    if (ShaderHandle existing = AddShaderReference(name))
     {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        LOG_ERROR("Fragment shader compilation failed: {}", infoLog);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return 0;
+        LOG_DEBUG("Shader {} already loaded", name);
+        return existing;
     }
 
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
+    ShaderEntry entry;
+    entry.name     = name;
+    entry.pending  = SubmitComputeProgram(computeSource);
+    entry.refCount = 1;
+    if (!FinalizeShader(entry)) { return {}; }
 
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success)
+    ShaderHandle handle   = m_shaders.Insert(std::move(entry));
+    m_shaderHandles[name] = handle;
+    return handle;
+}
+
+std::vector<ShaderHandle> ResourceManager::LoadShadersAsync(const std::vector<ShaderSource>& programs)
+{
+    // Компиляции и линковки уходят драйверу подряд, без чтения статусов между ними -
+    // с GL_KHR_parallel_shader_compile драйвер собирает их на своих потоках, пока мы грузим остальное
+    SupportsParallelShaderCompile();
+
+    std::vector<ShaderHandle> handles;
+    handles.reserve(programs.size());
+    size_t submitted = 0;
+    for (const ShaderSource& source : programs)
     {
-        GLchar infoLog[512];
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        LOG_ERROR("Program linking failed: {}", infoLog);
-        glDeleteProgram(program);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return 0;
+        if (ShaderHandle existing = AddShaderReference(source.name))
+        {
+            handles.push_back(existing);
+            continue;
+        }
+
+        ShaderEntry entry;
+        entry.name     = source.name;
+        entry.pending  = SubmitProgram(source.vertexSource, source.fragmentSource);
+        entry.refCount = 1;
+
+        ShaderHandle handle          = m_shaders.Insert(std::move(entry));
+        m_shaderHandles[source.name] = handle;
+        handles.push_back(handle);
+        ++submitted;
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    LOG_INFO("Submitted {} shader programs for {} compilation",
+             submitted,
+             SupportsParallelShaderCompile() ? "parallel" : "deferred");
+    return handles;
+}
+
+bool ResourceManager::IsShaderReady(ShaderHandle handle) const
+{
+    const ShaderEntry* entry = m_shaders.Get(handle);
+    if (!entry) { return false; }
+    if (entry->pending.program == 0) { return entry->program != nullptr; }
+
+    // Без расширения узнать готовность без ожидания нельзя - программа достроится при первом обращении
+    if (!SupportsParallelShaderCompile()) { return false; }
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(entry->pending.program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+void ResourceManager::ProcessPendingShaders()
+{
+    if (!SupportsParallelShaderCompile()) { return; }
 
-    m_shaders[name] = program;
-    LOG_INFO("Shader {} loaded and cached", name);
-    return program;
+    for (size_t i = 0; i < m_shaders.Size(); ++i)
+    {
+        ShaderEntry& entry = m_shaders.At(i);
+        if (entry.pending.program != 0 && IsShaderReady(m_shaders.GetHandle(i))) { FinalizeShader(entry); }
+    }
 }
 
-GLuint ResourceManager::GetShader(const std::string& name) const
+size_t ResourceManager::GetPendingShaderCount() const
 {
-    auto it = m_shaders.find(name);
-    if (it == m_shaders.end())
+    size_t count = 0;
+    for (const ShaderEntry& entry : m_shaders)
     {
-        LOG_ERROR("Shader {} not found", name);
-        return 0;
+        if (entry.pending.program != 0) { ++count; }
     }
-    return it->second;
+    return count;
 }
 
-void ResourceManager::UnloadShader(const std::string& name)
+ResourceManager::PendingProgram ResourceManager::SubmitProgram(const std::string& vertexSource,
+                                                               const std::string& fragmentSource)
 {
-    auto it = m_shaders.find(name);
-    if (it != m_shaders.end())
+    PendingProgram pending;
+
+    // Попадание в кэш бинарников пропускает компиляцию и линковку целиком
+    pending.cacheKey = m_programCache.MakeKey({vertexSource, fragmentSource});
+    pending.program  = m_programCache.Load(pending.cacheKey);
+    if (pending.program != 0) { return pending; }
+
+    const char* vSource  = vertexSource.c_str();
+    pending.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(pending.vertexShader, 1, &vSource, nullptr);
+    glCompileShader(pending.vertexShader);
+
+    const char* fSource    = fragmentSource.c_str();
+    pending.fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pending.fragmentShader, 1, &fSource, nullptr);
+    glCompileShader(pending.fragmentShader);
+
+    // Статусы компиляции не запрашиваются - это заставило бы драйвер дождаться каждой стадии
+    pending.program = glCreateProgram();
+    glAttachShader(pending.program, pending.vertexShader);
+    glAttachShader(pending.program, pending.fragmentShader);
+    if (m_programCache.IsEnabled())
     {
-        glDeleteProgram(it->second);
-        m_shaders.erase(it);
-        LOG_INFO("Shader {} unloaded", name);
+        glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     }
-    else
+    glLinkProgram(pending.program);
+    return pending;
+}
+
+ResourceManager::PendingProgram ResourceManager::SubmitComputeProgram(const std::string& computeSource)
+{
+    PendingProgram pending;
+
+    // Отдельный ключ кэша: исходник из одной стадии не совпадет с парой вершинный + фрагментный
+    pending.cacheKey = m_programCache.MakeKey({computeSource});
+    pending.program  = m_programCache.Load(pending.cacheKey);
+    if (pending.program != 0) { return pending; }
+
+    const char* source    = computeSource.c_str();
+    pending.computeShader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(pending.computeShader, 1, &source, nullptr);
+    glCompileShader(pending.computeShader);
+
+    pending.program = glCreateProgram();
+    glAttachShader(pending.program, pending.computeShader);
+    if (m_programCache.IsEnabled())
     {
-        LOG_WARN("Shader {} not found for unloading", name);
+        glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     }
+    glLinkProgram(pending.program);
+    return pending;
 }
 
-GLuint ResourceManager::LoadTexture(const std::string& filename)
+bool ResourceManager::ValidateProgram(const std::string& name, PendingProgram& pending)
 {
-    // Проверяем, не загружена ли уже текстура с таким именем
-    if (m_textures.find(filename) != m_textures.end())
+    bool fromCache = pending.FromCache();
+
+    GLint success = GL_TRUE;
+    if (!fromCache)
     {
-        LOG_WARN("Texture {} already loaded", filename);
-        return m_textures[filename];
+        // Ошибки стадий проверяем до линковки - сообщение компилятора полезнее сообщения линковщика
+        const std::pair<GLuint, const char*> stages[] = {{pending.vertexShader, "Vertex"},
+                                                         {pending.fragmentShader, "Fragment"},
+                                                         {pending.computeShader, "Compute"}};
+        for (const auto& [shader, stage] : stages)
+        {
+            if (shader == 0) { continue; }
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                GLchar infoLog[512];
+                glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+                LOG_ERROR("{} shader compilation failed ({}): {}", stage, name, infoLog);
+                break;
+            }
+        }
+
+        if (success)
+        {
+            glGetProgramiv(pending.program, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                GLchar infoLog[512];
+                glGetProgramInfoLog(pending.program, 512, nullptr, infoLog);
+                LOG_ERROR("Program linking failed ({}): {}", name, infoLog);
+            }
+        }
+
+        // glDeleteShader(0) ничего не делает - отсутствующие стадии можно не проверять
+        glDeleteShader(pending.vertexShader);
+        glDeleteShader(pending.fragmentShader);
+        glDeleteShader(pending.computeShader);
+        pending.vertexShader   = 0;
+        pending.fragmentShader = 0;
+        pending.computeShader  = 0;
     }
 
-    // Ищем полный путь к файлу
-    std::string fullPath = FindTexturePath(filename);
-    if (fullPath.empty())
+    if (!success)
     {
-        LOG_ERROR("Texture file {} not found in assets directories", filename);
-        return 0;
+        glDeleteProgram(pending.program);
+        pending.program = 0;
+        return false;
     }
 
-    LOG_INFO("Loading texture: {} from {}", filename, fullPath);
+    if (!fromCache) { m_programCache.Store(pending.cacheKey, pending.program); }
+    return true;
+}
 
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(fullPath.c_str(), &width, &height, &channels, 0);
-    if (!data)
+bool ResourceManager::FinalizeShader(ShaderEntry& entry)
+{
+    bool   fromCache = entry.pending.FromCache();
+    bool   valid     = ValidateProgram(entry.name, entry.pending);
+    GLuint program   = entry.pending.program;
+    entry.pending    = {};
+    if (!valid) { return false; }
+
+    // Один раз собираем активные uniform переменные, дальше доступ к ним идет без glGetUniformLocation
+    entry.program = std::make_unique<ShaderProgram>(program);
+    LOG_INFO("Shader {} loaded {} ({} uniforms)",
+             entry.name,
+             fromCache ? "from binary cache" : "and cached",
+             entry.program->GetUniformCount());
+    return true;
+}
+
+ShaderHandle ResourceManager::FindShader(const std::string& name) const
+{
+    auto it = m_shaderHandles.find(name);
+    return it != m_shaderHandles.end() ? it->second : ShaderHandle{};
+}
+
+GLuint ResourceManager::GetShader(ShaderHandle handle)
+{
+    ShaderProgram* program = GetShaderProgram(handle);
+    return program ? program->GetID() : 0;
+}
+
+ShaderProgram* ResourceManager::GetShaderProgram(ShaderHandle handle)
+{
+    ShaderEntry* entry = m_shaders.Get(handle);
+    if (!entry)
     {
-        LOG_ERROR("Failed to load texture {}: {}", fullPath, stbi_failure_reason());
-        return 0;
+        LOG_ERROR("Shader handle {:#x} is not valid", handle.value);
+        return nullptr;
     }
 
-    GLenum format;
-    switch (channels)
+    // Первое обращение к асинхронной программе - здесь драйвер при необходимости дожидается сборки
+    if (entry->pending.program != 0) { FinalizeShader(*entry); }
+    return entry->program.get();
+}
+
+void ResourceManager::ReleaseShader(ShaderHandle handle)
+{
+    ShaderEntry* entry = m_shaders.Get(handle);
+    if (!entry)
     {
-    case 1:
-        format = GL_RED;
-        break;
-    case 3:
-        format = GL_RGB;
-        break;
-    case 4:
-        format = GL_RGBA;
-        break;
-    default:
-        LOG_ERROR("Unsupported texture format: {} channels", channels);
-        stbi_image_free(data);
-        return 0;
+        LOG_WARN("Shader handle {:#x} released twice or never loaded", handle.value);
+        return;
     }
+    if (--entry->refCount > 0) { return; }
 
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    // Несобранные объекты в кадре не участвуют - удаляются сразу, готовая программа ждет CollectGarbage
+    DeletePendingProgram(entry->pending);
+    DeletePendingProgram(entry->reload);
+    if (entry->program) { m_releasedPrograms.push_back(entry->program->GetID()); }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    LOG_INFO("Shader {} unloaded", entry->name);
+    m_shaderHandles.erase(entry->name);
+    m_shaderSourceFiles.erase(entry->name);
+    m_shaders.Remove(handle);
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format,
-                 GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+bool ResourceManager::RegisterShaderVariants(const std::string& name, const std::string& vertexSource,
+                                             const std::string& fragmentSource)
+{
+    if (m_shaderVariants.find(name) != m_shaderVariants.end())
+    {
+        LOG_WARN("Shader variants {} already registered", name);
+        return true;
+    }
 
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    ShaderVariantSet variants;
+    if (!variants.Initialize(vertexSource, fragmentSource))
+    {
+        LOG_ERROR("Failed to register shader variants {}", name);
+        return false;
+    }
 
-    m_textures[filename] = texture;
-    LOG_INFO("Texture {} loaded successfully ({}x{}, {} channels)", filename, width, height, channels);
-    return texture;
+    LOG_INFO("Shader variants {} registered ({} features)", name, variants.GetFeatures().size());
+    m_shaderVariants[name] = std::move(variants);
+    return true;
 }
 
-GLuint ResourceManager::GetTexture(const std::string& filename) const
+uint32_t ResourceManager::GetShaderFeatureMask(const std::string&                      name,
+                                               std::initializer_list<std::string_view> features) const
 {
-    auto it = m_textures.find(filename);
-    if (it == m_textures.end())
+    auto it = m_shaderVariants.find(name);
+    if (it == m_shaderVariants.end())
     {
-        LOG_ERROR("Texture {} not found", filename);
+        LOG_ERROR("Shader variants {} not registered", name);
         return 0;
     }
-    return it->second;
+    return it->second.MakeMask(features);
 }
 
-void ResourceManager::UnloadTexture(const std::string& filename)
+ShaderHandle ResourceManager::GetShaderVariant(const std::string& name, uint32_t featureMask)
 {
-    auto it = m_textures.find(filename);
-    if (it != m_textures.end())
+    auto it = m_shaderVariants.find(name);
+    if (it == m_shaderVariants.end())
     {
-        glDeleteTextures(1, &it->second);
-        m_textures.erase(it);
-        LOG_INFO("Texture {} unloaded", filename);
+        LOG_ERROR("Shader variants {} not registered", name);
+        return {};
     }
-    else
+
+    // Горячий путь - одна проба по маске, без сборки строк
+    ShaderVariantSet& variants = it->second;
+    ShaderHandle      handle;
+
+    featureMask &= variants.GetValidMask();
+    if (variants.FindVariant(featureMask, handle)) { return handle; }
+
+    // Первый запрос без прогрева: вариант собирается здесь, ссылку на него держит набор
+    std::string variantName    = variants.MakeVariantName(name, featureMask);
+    std::string vertexSource   = variants.BuildVertexSource(featureMask);
+    std::string fragmentSource = variants.BuildFragmentSource(featureMask);
+    handle                     = LoadShader(variantName, vertexSource, fragmentSource);
+    if (!handle) { LOG_ERROR("Shader variant {} failed to build", variantName); }
+    variants.StoreVariant(featureMask, handle);
+    return handle;
+}
+
+void ResourceManager::WarmUpShaderVariants(const std::string& name, const std::vector<uint32_t>& featureMasks)
+{
+    auto it = m_shaderVariants.find(name);
+    if (it == m_shaderVariants.end())
+    {
+        LOG_ERROR("Shader variants {} not registered", name);
+        return;
+    }
+
+    ShaderVariantSet&         variants = it->second;
+    std::vector<uint32_t>     masks;
+    std::vector<ShaderSource> sources;
+    for (uint32_t mask : featureMasks)
     {
-        LOG_WARN("Texture {} not found for unloading", filename);
+        mask &= variants.GetValidMask();
+        ShaderHandle cached;
+        if (variants.FindVariant(mask, cached) || std::find(masks.begin(), masks.end(), mask) != masks.end())
+        {
+            continue;
+        }
+
+        masks.push_back(mask);
+        sources.push_back({variants.MakeVariantName(name, mask),
+                           variants.BuildVertexSource(mask),
+                           variants.BuildFragmentSource(mask)});
     }
+    if (sources.empty()) { return; }
+
+    // Ссылки, полученные при отправке, переходят набору
+    std::vector<ShaderHandle> handles = LoadShadersAsync(sources);
+    for (size_t i = 0; i < handles.size(); ++i) { variants.StoreVariant(masks[i], handles[i]); }
 }
 
-std::vector<std::string> ResourceManager::GetAvailableTextures() const
+void ResourceManager::UnloadShaderVariants(const std::string& name)
 {
-    std::vector<std::string> textures;
-    for (const auto& [filename, path] : m_textureFilenames)
+    auto it = m_shaderVariants.find(name);
+    if (it == m_shaderVariants.end())
     {
-        textures.push_back(filename);
+        LOG_WARN("Shader variants {} not registered", name);
+        return;
     }
-    return textures;
+
+    size_t count = 0;
+    for (const auto& [mask, handle] : it->second.GetVariants())
+    {
+        if (!handle) { continue; }
+        ReleaseShader(handle);
+        ++count;
+    }
+    m_shaderVariants.erase(it);
+    m_shaderSourceFiles.erase(name);
+    LOG_INFO("Shader variants {} unloaded ({} programs)", name, count);
 }
 
-void ResourceManager::PrintAvailableResources() const
+void ResourceManager::DeletePendingProgram(PendingProgram& pending)
 {
-    LOG_INFO("=== Available Resources ===");
+    if (pending.vertexShader != 0) { glDeleteShader(pending.vertexShader); }
+    if (pending.fragmentShader != 0) { glDeleteShader(pending.fragmentShader); }
+    if (pending.computeShader != 0) { glDeleteShader(pending.computeShader); }
+    if (pending.program != 0) { glDeleteProgram(pending.program); }
+    pending = {};
+}
 
-    LOG_INFO("Textures ({}):", m_textureFilenames.size());
-    for (const auto& [filename, path] : m_textureFilenames)
+TextureHandle ResourceManager::AddTextureReference(const std::string& name)
+{
+    auto it = m_textureHandles.find(name);
+    if (it == m_textureHandles.end()) { return {}; }
+
+    TextureEntry* entry = m_textures.Get(it->second);
+    ++entry->refCount;
+    entry->lastUsedFrame = m_frameIndex;
+    return it->second;
+}
+
+TextureHandle ResourceManager::InsertTexture(const std::string& name, GLuint texture)
+{
+    TextureEntry entry;
+    entry.name          = name;
+    entry.refCount      = 1;
+    entry.lastUsedFrame = m_frameIndex;
+
+    TextureHandle handle   = m_textures.Insert(std::move(entry));
+    m_textureHandles[name] = handle;
+    ReplaceTexture(*m_textures.Get(handle), texture);
+    return handle;
+}
+
+TextureHandle ResourceManager::LoadTexture(const std::string& filename)
+{
+    // Проверяем, не загружена ли уже текстура с таким именем
+    if (TextureHandle existing = AddTextureReference(filename))
     {
-        LOG_INFO("  - {}", filename);
+        LOG_DEBUG("Texture {} already loaded", filename);
+        if (m_textures.Get(existing)->evicted) { RestoreTexture(existing, false); }
+        return existing;
     }
 
-    LOG_INFO("Shaders ({}):", m_shaderFilenames.size());
-    for (const auto& [filename, path] : m_shaderFilenames)
+    GLuint texture = CreateTexture(filename);
+    if (texture == 0) { return {}; }
+    return InsertTexture(filename, texture);
+}
+
+GLuint ResourceManager::CreateTexture(const std::string& filename)
+{
+    // Запеченная версия загружается без декодирования и генерации mip
+    AssetData cooked;
+    if (HasCookedTexture(filename) && OpenTextureData(CookedTextureName(filename), cooked))
     {
-        LOG_INFO("  - {}", filename);
+        GLuint texture = LoadCookedTexture(cooked.data, cooked.size, cooked.source);
+        if (texture != 0)
+        {
+            LOG_INFO("Texture {} loaded from cooked {}", filename, cooked.source);
+            return texture;
+        }
+        LOG_WARN("Cooked texture {} is unusable, falling back to source", cooked.source);
     }
 
-    LOG_INFO("========================");
+    AssetData source;
+    if (!OpenTextureData(filename, source))
+    {
+        LOG_ERROR("Texture file {} not found in assets", filename);
+        return 0;
+    }
+
+    LOG_INFO("Loading texture: {} from {}", filename, source.source);
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char* data = stbi_load_from_memory(source.data,
+                                                static_cast<int>(source.size),
+                                                &width,
+                                                &height,
+                                                &channels,
+                                                0);
+    if (!data)
+    {
+        LOG_ERROR("Failed to load texture {}: {}", source.source, stbi_failure_reason());
+        return 0;
+    }
+
+    GLuint texture = CreateTextureFromData(data, width, height, channels);
+    stbi_image_free(data);
+    if (texture == 0) { return 0; }
+
+    LOG_INFO("Texture {} loaded successfully ({}x{}, {} channels)", filename, width, height, channels);
+    return texture;
 }
 
-std::string ResourceManager::ReadFile(const std::string& path)
+void ResourceManager::RestoreTexture(TextureHandle handle, bool async)
 {
-    std::ifstream file(path);
-    if (!file.is_open())
+    TextureEntry& entry = *m_textures.Get(handle);
+    entry.evicted       = false;
+
+    // Потоковая текстура снова начинает с мелких уровней, крупные подтянут запросы
+    if (entry.stream)
     {
-        LOG_ERROR("Failed to open file {}", path);
-        return "";
+        if (StartTextureStream(entry)) { return; }
+        entry.stream.reset();
     }
-    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Асинхронно - как горячая перезагрузка: до готовности дескриптор остается на заглушке
+    if (async && m_threadPool)
+    {
+        ReloadTexture(handle);
+        return;
+    }
+
+    if (GLuint texture = CreateTexture(entry.name)) { ReplaceTexture(entry, texture); }
+    LOG_DEBUG("Texture {} restored after eviction", entry.name);
 }
 
-void ResourceManager::Shutdown()
+void ResourceManager::EnforceTextureBudget()
 {
-    for (auto& [name, program] : m_shaders)
+    if (m_textureBudget == 0 || m_textureMemory <= m_textureBudget) { return; }
+
+    // Кандидаты - загруженные текстуры без ссылок, от давно не использованных к недавним
+    std::vector<TextureEntry*> candidates;
+    for (TextureEntry& entry : m_textures)
     {
-        glDeleteProgram(program);
+        if (entry.refCount == 0 && !entry.pending && !entry.evicted && entry.memorySize > 0)
+        {
+            candidates.push_back(&entry);
+        }
     }
-    m_shaders.clear();
+    std::sort(candidates.begin(), candidates.end(), [](const TextureEntry* a, const TextureEntry* b) {
+        return a->lastUsedFrame < b->lastUsedFrame;
+    });
 
-    for (auto& [filename, texture] : m_textures)
+    size_t evicted = 0;
+    size_t freed   = 0;
+    for (TextureEntry* entry : candidates)
     {
-        glDeleteTextures(1, &texture);
-    }
-    m_textures.clear();
+        if (m_textureMemory <= m_textureBudget) { break; }
 
-    m_textureFilenames.clear();
-    m_shaderFilenames.clear();
+        freed += entry->memorySize;
+        ReplaceTexture(*entry, GetPlaceholderTexture());
+        entry->evicted = true;
+        ++evicted;
+    }
 
-    LOG_INFO("ResourceManager shutdown completed");
+    if (evicted > 0)
+    {
+        LOG_INFO("Evicted {} textures ({:.1f} MB), {:.1f} / {:.1f} MB in use",
+                 evicted,
+                 freed / (1024.0 * 1024.0),
+                 m_textureMemory / (1024.0 * 1024.0),
+                 m_textureBudget / (1024.0 * 1024.0));
+    }
+    if (m_textureMemory > m_textureBudget)
+    {
+        LOG_INFO_THROTTLED("Referenced textures exceed the VRAM budget ({:.1f} / {:.1f} MB)",
+                           m_textureMemory / (1024.0 * 1024.0),
+                           m_textureBudget / (1024.0 * 1024.0));
+    }
 }
 
-void ResourceManager::BindTexture(const std::string& filename, GLenum textureUnit) const
+GLuint ResourceManager::CreateTextureFromData(const unsigned char* data, int width, int height, int channels,
+                                              bool staged)
 {
-    GLuint textureID = GetTexture(filename);
-    if (textureID != 0)
+    GLenum format;
+    GLenum internalFormat;
+    switch (channels)
     {
-        glActiveTexture(textureUnit);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-    }
-    else
+    case 1:
+        format         = GL_RED;
+        internalFormat = GL_R8;
+        break;
+    case 3:
+        format         = GL_RGB;
+        internalFormat = GL_RGB8;
+        break;
+    case 4:
+        format         = GL_RGBA;
+        internalFormat = GL_RGBA8;
+        break;
+    default:
+        LOG_ERROR("Unsupported texture format: {} channels", channels);
+        return 0;
+    }
+
+    // Текстура создается через DSA - привязки текстурных юнитов не меняются
+    GLsizei levels = 1;
+    while ((std::max(width, height) >> levels) > 0) { ++levels; }
+
+    GLuint texture;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTextureStorage2D(texture, levels, internalFormat, width, height);
+
+    // Через PBO драйвер копирует данные асинхронно, а не внутри glTextureSubImage2D.
+    // Если в потоковом буфере кадра нет места - обычная загрузка из памяти
+    Renderer*           renderer = staged ? m_renderer : nullptr;
+    auto                size     = static_cast<GLsizeiptr>(width) * height * channels;
+    TransientAllocation staging;
+    if (renderer && size + 4 <= renderer->GetTransientBytesAvailable()) { staging = renderer->AllocTransient(size, 4); }
+
+    if (staging)
+    {
+        std::memcpy(staging.data, data, size);
+        renderer->BindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+        glTextureSubImage2D(texture,
+                            0,
+                            0,
+                            0,
+                            width,
+                            height,
+                            format,
+                            GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(staging.offset));
+        renderer->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else { glTextureSubImage2D(texture, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data); }
+
+    glGenerateTextureMipmap(texture);
+    return texture;
+}
+
+GLuint ResourceManager::LoadCookedTexture(const uint8_t* data, size_t size, const std::string& path)
+{
+    TextureStream stream;
+    if (!ParseCookedTexture(data, size, path, stream)) { return 0; }
+    return BuildCookedTexture(stream, 0, 0, nullptr);
+}
+
+bool ResourceManager::ParseCookedTexture(const uint8_t* data, size_t size, const std::string& path,
+                                         TextureStream& stream)
+{
+    if (!ParseYtex(data, size, stream.view))
+    {
+        LOG_ERROR("Cooked texture {} is corrupted or has an unsupported version", path);
+        return false;
+    }
+
+    switch (stream.view.GetFormat())
+    {
+    case YtexFormat::R8:
+        stream.internalFormat = GL_R8;
+        stream.format         = GL_RED;
+        break;
+    case YtexFormat::RGB8:
+        stream.internalFormat = GL_RGB8;
+        stream.format         = GL_RGB;
+        break;
+    case YtexFormat::RGBA8:
+        stream.internalFormat = GL_RGBA8;
+        stream.format         = GL_RGBA;
+        break;
+    case YtexFormat::BC1: stream.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+    case YtexFormat::BC3: stream.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+    }
+
+    stream.compressed = IsYtexCompressed(stream.view.GetFormat());
+    if (stream.compressed && !SupportsS3TC())
+    {
+        LOG_WARN("Cooked texture {} is S3TC compressed, but the driver does not support it", path);
+        return false;
+    }
+    return true;
+}
+
+GLuint ResourceManager::BuildCookedTexture(const TextureStream& stream, uint32_t firstLevel, GLuint previous,
+                                           const uint8_t* firstLevelData)
+{
+    const YtexHeader& header = *stream.view.header;
+    const YtexMip&    top    = stream.view.mips[firstLevel];
+    auto              levels = static_cast<GLsizei>(header.mipCount - firstLevel);
+
+    GLuint texture;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Хранилище только под загружаемые уровни - память растет вместе с детализацией
+    glTextureStorage2D(texture,
+                       levels,
+                       stream.internalFormat,
+                       static_cast<GLsizei>(top.width),
+                       static_cast<GLsizei>(top.height));
+
+    // Строки уровней упакованы плотно, уровни грузятся прямо из отображенного файла
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (uint32_t level = firstLevel; level < header.mipCount; ++level)
+    {
+        const YtexMip& mip    = stream.view.mips[level];
+        auto           target = static_cast<GLint>(level - firstLevel);
+        auto           width  = static_cast<GLsizei>(mip.width);
+        auto           height = static_cast<GLsizei>(mip.height);
+
+        // Уже загруженные уровни переносятся копированием на GPU, без повторного чтения файла
+        if (previous != 0 && level >= stream.residentLevel)
+        {
+            auto source = static_cast<GLint>(level - stream.residentLevel);
+            glCopyImageSubData(previous,
+                               GL_TEXTURE_2D,
+                               source,
+                               0,
+                               0,
+                               0,
+                               texture,
+                               GL_TEXTURE_2D,
+                               target,
+                               0,
+                               0,
+                               0,
+                               width,
+                               height,
+                               1);
+            continue;
+        }
+
+        const uint8_t* data = level == firstLevel && firstLevelData ? firstLevelData : stream.view.GetLevelData(level);
+        if (stream.compressed)
+        {
+            glCompressedTextureSubImage2D(texture,
+                                          target,
+                                          0,
+                                          0,
+                                          width,
+                                          height,
+                                          stream.internalFormat,
+                                          static_cast<GLsizei>(mip.size),
+                                          data);
+        }
+        else { glTextureSubImage2D(texture, target, 0, 0, width, height, stream.format, GL_UNSIGNED_BYTE, data); }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    return texture;
+}
+
+TextureHandle ResourceManager::LoadTextureStreamed(const std::string& filename)
+{
+    if (TextureHandle existing = AddTextureReference(filename))
+    {
+        if (m_textures.Get(existing)->evicted) { RestoreTexture(existing, true); }
+        return existing;
+    }
+
+    TextureHandle handle = InsertTexture(filename, 0);
+    TextureEntry& entry  = *m_textures.Get(handle);
+    if (!StartTextureStream(entry))
+    {
+        LOG_DEBUG("Texture {} has no usable cooked version, streaming unavailable", filename);
+        m_textureHandles.erase(filename);
+        m_textures.Remove(handle);
+        return LoadTextureAsync(filename);
+    }
+
+    const YtexHeader& header = *entry.stream->view.header;
+    LOG_INFO("Texture {} streaming from {} ({}x{}, {} of {} levels resident)",
+             filename,
+             entry.stream->source->source,
+             header.width,
+             header.height,
+             header.mipCount - entry.stream->residentLevel,
+             header.mipCount);
+    return handle;
+}
+
+bool ResourceManager::StartTextureStream(TextureEntry& entry)
+{
+    std::string cookedName = CookedTextureName(entry.name);
+    auto        source     = std::make_shared<AssetData>();
+    if (!HasCookedTexture(entry.name) || !OpenTextureData(cookedName, *source)) { return false; }
+
+    auto stream = std::make_unique<TextureStream>();
+    if (!ParseCookedTexture(source->data, source->size, source->source, *stream)) { return false; }
+    stream->source = std::move(source);
+
+    // Первым грузится хвост цепочки не крупнее STREAMING_INITIAL_SIZE - текстура пригодна сразу и весит единицы КБ
+    const YtexHeader& header = *stream->view.header;
+    uint32_t          level  = 0;
+    while (level + 1 < header.mipCount &&
+           std::max(stream->view.mips[level].width, stream->view.mips[level].height) > STREAMING_INITIAL_SIZE)
+    {
+        ++level;
+    }
+    stream->initialLevel  = level;
+    stream->residentLevel = level;
+    stream->fineFrame     = m_frameIndex;
+
+    GLuint texture = BuildCookedTexture(*stream, level, 0, nullptr);
+    if (texture == 0) { return false; }
+
+    ReplaceTexture(entry, texture);
+    entry.stream = std::move(stream);
+    return true;
+}
+
+void ResourceManager::RequestTextureResolution(TextureHandle handle, float screenSize)
+{
+    TextureEntry* entry = m_textures.Get(handle);
+    if (!entry || !entry->stream) { return; }
+    entry->lastUsedFrame = m_frameIndex;
+
+    // Нужен самый мелкий уровень, который еще не меньше текстуры на экране
+    TextureStream& stream = *entry->stream;
+    uint32_t       level  = 0;
+    while (level + 1 < stream.view.header->mipCount &&
+           static_cast<float>(std::max(stream.view.mips[level + 1].width, stream.view.mips[level + 1].height)) >=
+               screenSize)
+    {
+        ++level;
+    }
+    stream.requestedLevel = std::min(stream.requestedLevel, level);
+}
+
+void ResourceManager::QueueMipRead(TextureHandle handle, TextureStream& stream, ThreadPool& pool)
+{
+    stream.reading = true;
+
+    // Чтение отображенного файла на рабочем потоке - страницы подгружаются с диска вне кадра
+    uint32_t       level = stream.residentLevel - 1;
+    const uint8_t* data  = stream.view.GetLevelData(level);
+    size_t         size  = stream.view.mips[level].size;
+    pool.Submit([this, handle, source = stream.source, level, data, size] {
+        StreamedMip mip{handle, source, level, std::vector<uint8_t>(data, data + size)};
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_streamedMips.push_back(std::move(mip));
+    });
+}
+
+void ResourceManager::ProcessTextureStreaming(double budgetMs)
+{
+    std::vector<StreamedMip> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        ready.swap(m_streamedMips);
+    }
+
+    auto   start    = std::chrono::steady_clock::now();
+    size_t uploaded = 0;
+    for (; uploaded < ready.size(); ++uploaded)
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (uploaded > 0 && elapsed.count() >= budgetMs) { break; }
+
+        // Текстуру выгрузили, вытеснили или перезапустили с новым файлом, пока уровень читался
+        StreamedMip&  mip   = ready[uploaded];
+        TextureEntry* entry = m_textures.Get(mip.handle);
+        if (!entry || !entry->stream || entry->stream->source != mip.source) { continue; }
+
+        TextureStream& stream = *entry->stream;
+        stream.reading        = false;
+        if (entry->evicted || mip.level + 1 != stream.residentLevel) { continue; }
+
+        if (GLuint texture = BuildCookedTexture(stream, mip.level, entry->id, mip.data.data()))
+        {
+            ReplaceTexture(*entry, texture);
+            stream.residentLevel = mip.level;
+        }
+    }
+
+    if (uploaded < ready.size())
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_streamedMips.insert(m_streamedMips.begin(),
+                              std::make_move_iterator(ready.begin() + static_cast<std::ptrdiff_t>(uploaded)),
+                              std::make_move_iterator(ready.end()));
+    }
+
+    // Запросы прошлого кадра: уточнение идет по одному уровню за раз, от мелких к крупным, чтобы каждый шаг
+    // сразу становился видимым. Ненужный уровень выгружается с задержкой, чтобы не грузить его снова при повороте
+    for (size_t i = 0; i < m_textures.Size(); ++i)
+    {
+        TextureEntry& entry = m_textures.At(i);
+        if (!entry.stream || entry.evicted) { continue; }
+
+        TextureStream& stream    = *entry.stream;
+        uint32_t       requested = stream.requestedLevel;
+        stream.requestedLevel    = TextureStream::NO_REQUEST;
+        if (requested <= stream.residentLevel) { stream.fineFrame = m_frameIndex; }
+        if (stream.reading) { continue; }
+
+        if (requested < stream.residentLevel)
+        {
+            if (m_threadPool)
+            {
+                QueueMipRead(m_textures.GetHandle(i), stream, *m_threadPool);
+                continue;
+            }
+            // Без пула уровень загружается прямо из отображенного файла
+            if (GLuint texture = BuildCookedTexture(stream, stream.residentLevel - 1, entry.id, nullptr))
+            {
+                ReplaceTexture(entry, texture);
+                --stream.residentLevel;
+            }
+        }
+        else if (stream.residentLevel < stream.initialLevel && m_frameIndex - stream.fineFrame > STREAMING_DROP_FRAMES)
+        {
+            if (GLuint texture = BuildCookedTexture(stream, stream.residentLevel + 1, entry.id, nullptr))
+            {
+                ReplaceTexture(entry, texture);
+                ++stream.residentLevel;
+                stream.fineFrame = m_frameIndex;
+            }
+        }
+    }
+}
+
+TextureHandle ResourceManager::LoadTextureAsync(const std::string& filename)
+{
+    // Уже загружена или в процессе - отдаем тот же дескриптор (возможно, пока на заглушке)
+    if (TextureHandle existing = AddTextureReference(filename))
+    {
+        if (m_textures.Get(existing)->evicted) { RestoreTexture(existing, true); }
+        return existing;
+    }
+
+    // Запеченной текстуре нечего декодировать - остается только загрузка уровней
+    if (HasCookedTexture(filename)) { return LoadTexture(filename); }
+
+    // Файл отображается в память сразу, рабочему потоку остается только декодирование
+    auto source = std::make_shared<AssetData>();
+    if (!OpenTextureData(filename, *source))
+    {
+        LOG_ERROR("Texture file {} not found in assets", filename);
+        return {};
+    }
+
+    if (!m_threadPool)
+    {
+        LOG_WARN("No thread pool available, loading texture {} synchronously", filename);
+        return LoadTexture(filename);
+    }
+
+    TextureHandle handle = InsertTexture(filename, GetPlaceholderTexture());
+    QueueTextureDecode(handle, std::move(source), *m_threadPool);
+
+    LOG_DEBUG("Texture {} queued for async loading", filename);
+    return handle;
+}
+
+void ResourceManager::QueueTextureDecode(TextureHandle handle, std::shared_ptr<AssetData> source, ThreadPool& pool)
+{
+    TextureEntry* entry = m_textures.Get(handle);
+    if (!entry->pending)
+    {
+        entry->pending = true;
+        ++m_pendingTextureCount;
+    }
+
+    // Рабочий поток только декодирует файл - OpenGL вызовы остаются на главном потоке
+    pool.Submit([this, handle, filename = entry->name, source] {
+        DecodedTexture decoded;
+        decoded.handle   = handle;
+        decoded.filename = filename;
+
+        stbi_set_flip_vertically_on_load_thread(true);
+        decoded.pixels = stbi_load_from_memory(source->data,
+                                               static_cast<int>(source->size),
+                                               &decoded.width,
+                                               &decoded.height,
+                                               &decoded.channels,
+                                               0);
+        if (!decoded.pixels) { LOG_ERROR("Failed to load texture {}: {}", source->source, stbi_failure_reason()); }
+
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_decodedTextures.push_back(std::move(decoded));
+    });
+}
+
+void ResourceManager::ReplaceTexture(TextureEntry& entry, GLuint texture)
+{
+    // Подмена за тем же дескриптором: пользователи берут ID через GetTexture каждый кадр,
+    // а старый объект еще может стоять в пакетах текущего кадра - удаляется в CollectGarbage
+    if (entry.id != 0 && entry.id != m_placeholderTexture && entry.id != texture)
+    {
+        m_releasedTextures.push_back(entry.id);
+    }
+
+    // Заглушка общая и в бюджет не входит
+    m_textureMemory  -= entry.memorySize;
+    entry.memorySize = texture != 0 && texture != m_placeholderTexture ? QueryTextureMemory(texture) : 0;
+    m_textureMemory  += entry.memorySize;
+    entry.id         = texture;
+
+    // Упакованная текстура обновляет свой слой. Заглушку не копируем - слой хранит последнюю настоящую версию
+    if (entry.arrayIndex < 0 || texture == 0 || texture == m_placeholderTexture) { return; }
+
+    const TextureArray& array = m_textureArrays[entry.arrayIndex];
+    if (QueryTextureShape(texture) == array.shape) { CopyToArrayLayer(texture, array, entry.arrayLayer); }
+    else
+    {
+        // Слой освобождается - AcquireTextureLayer переложит текстуру в массив новой формы
+        LOG_DEBUG("Texture {} no longer matches its texture array and was unpacked", entry.name);
+        FreeTextureLayer(entry);
+    }
+}
+
+ResourceManager::TextureShape ResourceManager::QueryTextureShape(GLuint texture)
+{
+    TextureShape shape;
+    glGetTextureParameteriv(texture, GL_TEXTURE_IMMUTABLE_LEVELS, &shape.levels);
+    glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_INTERNAL_FORMAT, &shape.internalFormat);
+    glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_WIDTH, &shape.width);
+    glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_HEIGHT, &shape.height);
+    return shape;
+}
+
+void ResourceManager::CopyToArrayLayer(GLuint texture, const TextureArray& array, uint32_t layer)
+{
+    // Копирование на GPU по всем уровням, без чтения пикселей в память процесса
+    for (GLint level = 0; level < array.shape.levels; ++level)
+    {
+        glCopyImageSubData(texture,
+                           GL_TEXTURE_2D,
+                           level,
+                           0,
+                           0,
+                           0,
+                           array.id,
+                           GL_TEXTURE_2D_ARRAY,
+                           level,
+                           0,
+                           0,
+                           static_cast<GLint>(layer),
+                           std::max(array.shape.width >> level, 1),
+                           std::max(array.shape.height >> level, 1),
+                           1);
+    }
+}
+
+size_t ResourceManager::PackTextureArrays(uint32_t maxSize)
+{
+    UnpackTextureArrays();
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+    // Слои массива обязаны совпадать форматом, размером и числом уровней - по ним текстуры и группируются.
+    // Потоковые текстуры берутся в резидентном размере: сменив уровни, они уходят из массива в ReplaceTexture
+    std::vector<std::pair<TextureShape, std::vector<TextureHandle>>> groups;
+    for (size_t i = 0; i < m_textures.Size(); ++i)
+    {
+        const TextureEntry& entry = m_textures.At(i);
+        if (entry.pending || entry.evicted || entry.memorySize == 0) { continue; }
+
+        TextureShape shape = QueryTextureShape(entry.id);
+        if (static_cast<uint32_t>(std::max(shape.width, shape.height)) > maxSize) { continue; }
+
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const auto& g) {
+            return g.first == shape && g.second.size() < static_cast<size_t>(maxLayers);
+        });
+        if (group == groups.end()) { group = groups.emplace(groups.end(), shape, std::vector<TextureHandle>{}); }
+        group->second.push_back(m_textures.GetHandle(i));
+    }
+
+    size_t packed = 0;
+    for (const auto& [shape, handles] : groups)
+    {
+        size_t        index = CreateTextureArray(shape, static_cast<uint32_t>(handles.size()));
+        TextureArray& array = m_textureArrays[index];
+        for (uint32_t layer = 0; layer < handles.size(); ++layer)
+        {
+            TextureEntry& entry = *m_textures.Get(handles[layer]);
+            CopyToArrayLayer(entry.id, array, layer);
+            array.layers[layer] = handles[layer];
+            entry.arrayIndex    = static_cast<int32_t>(index);
+            entry.arrayLayer    = layer;
+        }
+        packed += handles.size();
+    }
+
+    LOG_INFO("Packed {} textures into {} texture arrays", packed, m_textureArrays.size());
+    return packed;
+}
+
+void ResourceManager::UnpackTextureArrays()
+{
+    for (const TextureArray& array : m_textureArrays)
+    {
+        for (TextureHandle handle : array.layers)
+        {
+            if (TextureEntry* entry = m_textures.Get(handle)) { entry->arrayIndex = -1; }
+        }
+        m_textureMemory -= array.memorySize;
+        if (array.id != 0) { m_releasedTextures.push_back(array.id); }
+    }
+    m_textureArrays.clear();
+}
+
+size_t ResourceManager::CreateTextureArray(const TextureShape& shape, uint32_t capacity)
+{
+    // Записи освобожденных массивов используются повторно - индексы остальных хранятся в TextureEntry
+    auto free = std::find_if(m_textureArrays.begin(), m_textureArrays.end(), [](const TextureArray& a) {
+        return a.id == 0;
+    });
+    if (free == m_textureArrays.end()) { free = m_textureArrays.emplace(m_textureArrays.end()); }
+
+    TextureArray& array = *free;
+    array.shape         = shape;
+    array.layers.assign(capacity, TextureHandle{});
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array.id);
+    glTextureParameteri(array.id, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(array.id, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(array.id, GL_TEXTURE_MIN_FILTER, shape.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTextureParameteri(array.id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureStorage3D(array.id,
+                       shape.levels,
+                       static_cast<GLenum>(shape.internalFormat),
+                       shape.width,
+                       shape.height,
+                       static_cast<GLsizei>(capacity));
+
+    array.memorySize = QueryTextureMemory(array.id);
+    m_textureMemory += array.memorySize;
+    return static_cast<size_t>(free - m_textureArrays.begin());
+}
+
+void ResourceManager::GrowTextureArray(TextureArray& array, uint32_t capacity)
+{
+    GLuint previous = array.id;
+    auto   count    = static_cast<GLsizei>(array.layers.size());
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array.id);
+    glTextureParameteri(array.id, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(array.id, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(array.id,
+                        GL_TEXTURE_MIN_FILTER,
+                        array.shape.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTextureParameteri(array.id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureStorage3D(array.id,
+                       array.shape.levels,
+                       static_cast<GLenum>(array.shape.internalFormat),
+                       array.shape.width,
+                       array.shape.height,
+                       static_cast<GLsizei>(capacity));
+
+    // Все слои уровня копируются одним вызовом. Старый массив еще может стоять в пакетах кадра
+    for (GLint level = 0; level < array.shape.levels; ++level)
+    {
+        glCopyImageSubData(previous,
+                           GL_TEXTURE_2D_ARRAY,
+                           level,
+                           0,
+                           0,
+                           0,
+                           array.id,
+                           GL_TEXTURE_2D_ARRAY,
+                           level,
+                           0,
+                           0,
+                           0,
+                           std::max(array.shape.width >> level, 1),
+                           std::max(array.shape.height >> level, 1),
+                           count);
+    }
+    m_releasedTextures.push_back(previous);
+
+    m_textureMemory  -= array.memorySize;
+    array.memorySize = QueryTextureMemory(array.id);
+    m_textureMemory  += array.memorySize;
+    array.layers.resize(capacity);
+}
+
+void ResourceManager::AssignTextureLayer(TextureHandle handle, TextureEntry& entry)
+{
+    static constexpr uint32_t INITIAL_LAYERS = 4;
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+    // Свободный слой массива той же формы, иначе такой массив растет вдвое, иначе заводится новый
+    TextureShape shape = QueryTextureShape(entry.id);
+    size_t       index = m_textureArrays.size();
+    for (size_t i = 0; i < m_textureArrays.size() && index == m_textureArrays.size(); ++i)
+    {
+        const TextureArray& array = m_textureArrays[i];
+        if (array.id == 0 || !(array.shape == shape)) { continue; }
+        if (array.layers.size() < static_cast<size_t>(maxLayers) ||
+            std::find(array.layers.begin(), array.layers.end(), TextureHandle{}) != array.layers.end())
+        {
+            index = i;
+        }
+    }
+
+    if (index == m_textureArrays.size()) { index = CreateTextureArray(shape, INITIAL_LAYERS); }
+    TextureArray& array = m_textureArrays[index];
+
+    auto layer = std::find(array.layers.begin(), array.layers.end(), TextureHandle{});
+    if (layer == array.layers.end())
+    {
+        auto size = static_cast<uint32_t>(array.layers.size());
+        GrowTextureArray(array, std::min(size * 2, static_cast<uint32_t>(maxLayers)));
+        layer = array.layers.begin() + size;
+    }
+
+    *layer           = handle;
+    entry.arrayIndex = static_cast<int32_t>(index);
+    entry.arrayLayer = static_cast<uint32_t>(layer - array.layers.begin());
+    CopyToArrayLayer(entry.id, array, entry.arrayLayer);
+    LOG_DEBUG("Texture {} packed on demand into array layer {}", entry.name, entry.arrayLayer);
+}
+
+void ResourceManager::FreeTextureLayer(TextureEntry& entry)
+{
+    TextureArray& array = m_textureArrays[entry.arrayIndex];
+    array.layers[entry.arrayLayer] = {};
+    entry.arrayIndex               = -1;
+
+    bool empty = std::all_of(array.layers.begin(), array.layers.end(), [](TextureHandle h) { return !h; });
+    if (!empty) { return; }
+
+    m_releasedTextures.push_back(array.id);
+    m_textureMemory  -= array.memorySize;
+    array.id         = 0;
+    array.memorySize = 0;
+    array.layers.clear();
+}
+
+ResourceManager::TextureLayer ResourceManager::GetPlaceholderLayer()
+{
+    if (m_placeholderArray != 0) { return {m_placeholderArray, 0.0f}; }
+
+    GLuint placeholder = GetPlaceholderTexture();
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_placeholderArray);
+    glTextureParameteri(m_placeholderArray, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(m_placeholderArray, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(m_placeholderArray, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_placeholderArray, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureStorage3D(m_placeholderArray, 1, GL_RGBA8, 2, 2, 1);
+    glCopyImageSubData(placeholder,
+                       GL_TEXTURE_2D,
+                       0,
+                       0,
+                       0,
+                       0,
+                       m_placeholderArray,
+                       GL_TEXTURE_2D_ARRAY,
+                       0,
+                       0,
+                       0,
+                       0,
+                       2,
+                       2,
+                       1);
+    return {m_placeholderArray, 0.0f};
+}
+
+ResourceManager::TextureLayer ResourceManager::GetTextureLayer(TextureHandle handle) const
+{
+    const TextureEntry* entry = m_textures.Get(handle);
+    if (!entry || entry->arrayIndex < 0) { return {}; }
+
+    entry->lastUsedFrame = m_frameIndex;
+    return {m_textureArrays[entry->arrayIndex].id, static_cast<float>(entry->arrayLayer)};
+}
+
+ResourceManager::TextureLayer ResourceManager::AcquireTextureLayer(TextureHandle handle)
+{
+    TextureEntry* entry = m_textures.Get(handle);
+    if (!entry) { return {}; }
+
+    // Выгруженная или перезагружаемая текстура остается в своем слое с последней настоящей версией,
+    // а заглушку в общие массивы не пакуем
+    if (entry->arrayIndex < 0 && entry->memorySize != 0) { AssignTextureLayer(handle, *entry); }
+    if (entry->arrayIndex < 0) { return GetPlaceholderLayer(); }
+
+    entry->lastUsedFrame = m_frameIndex;
+    return {m_textureArrays[entry->arrayIndex].id, static_cast<float>(entry->arrayLayer)};
+}
+
+ResourceManager::TextureLayer ResourceManager::GetMaterialTexture(TextureHandle handle)
+{
+    if (m_renderer && m_renderer->SupportsBindlessTextures()) { return {GetTexture(handle), 0.0f}; }
+    return AcquireTextureLayer(handle);
+}
+
+TextureHandle ResourceManager::FindTexture(const std::string& filename) const
+{
+    auto it = m_textureHandles.find(filename);
+    return it != m_textureHandles.end() ? it->second : TextureHandle{};
+}
+
+bool ResourceManager::IsTextureReady(TextureHandle handle) const
+{
+    const TextureEntry* entry = m_textures.Get(handle);
+    return entry && entry->id != m_placeholderTexture && !entry->pending && !entry->evicted;
+}
+
+void ResourceManager::ProcessPendingUploads(double budgetMs)
+{
+    if (m_pendingTextureCount == 0) { return; }
+
+    std::vector<DecodedTexture> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        ready.swap(m_decodedTextures);
+    }
+
+    auto   start    = std::chrono::steady_clock::now();
+    size_t uploaded = 0;
+    for (; uploaded < ready.size(); ++uploaded)
+    {
+        // Хотя бы одна загрузка за кадр, иначе большая текстура не загрузится никогда
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (uploaded > 0 && elapsed.count() >= budgetMs) { break; }
+
+        DecodedTexture& decoded = ready[uploaded];
+
+        // Текстуру успели выгрузить, пока она декодировалась, или результат уже устарел
+        TextureEntry* entry = m_textures.Get(decoded.handle);
+        if (!entry || !entry->pending || !decoded.pixels)
+        {
+            if (entry && entry->pending)
+            {
+                entry->pending = false;
+                --m_pendingTextureCount;
+            }
+            stbi_image_free(decoded.pixels);
+            continue;
+        }
+        entry->pending = false;
+        --m_pendingTextureCount;
+
+        GLuint texture = CreateTextureFromData(decoded.pixels, decoded.width, decoded.height, decoded.channels, true);
+        stbi_image_free(decoded.pixels);
+
+        // При ошибке дескриптор остается на заглушке
+        if (texture == 0) { continue; }
+
+        ReplaceTexture(*entry, texture);
+        LOG_INFO("Texture {} loaded asynchronously ({}x{}, {} channels)",
+                 decoded.filename,
+                 decoded.width,
+                 decoded.height,
+                 decoded.channels);
+    }
+
+    // Не уложившиеся в бюджет результаты возвращаются в начало очереди
+    if (uploaded < ready.size())
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_decodedTextures.insert(m_decodedTextures.begin(),
+                                 std::make_move_iterator(ready.begin() + static_cast<std::ptrdiff_t>(uploaded)),
+                                 std::make_move_iterator(ready.end()));
+    }
+}
+
+BufferHandle ResourceManager::CreateBuffer(const std::string& name, const void* data, GLsizeiptr size, GLenum usage)
+{
+    auto it = m_bufferHandles.find(name);
+    if (it != m_bufferHandles.end())
+    {
+        ++m_buffers.Get(it->second)->refCount;
+        LOG_DEBUG("Buffer {} already created", name);
+        return it->second;
+    }
+
+    GLuint buffer = 0;
+    glCreateBuffers(1, &buffer);
+    glNamedBufferData(buffer, size, data, usage);
+
+    BufferHandle handle   = m_buffers.Insert({name, buffer, size, 1});
+    m_bufferHandles[name] = handle;
+    LOG_DEBUG("Buffer {} created ({} bytes)", name, size);
+    return handle;
+}
+
+GLuint ResourceManager::GetBuffer(BufferHandle handle) const
+{
+    const BufferEntry* entry = m_buffers.Get(handle);
+    return entry ? entry->id : 0;
+}
+
+void ResourceManager::ReleaseBuffer(BufferHandle handle)
+{
+    BufferEntry* entry = m_buffers.Get(handle);
+    if (!entry)
+    {
+        LOG_WARN("Buffer handle {:#x} released twice or never created", handle.value);
+        return;
+    }
+    if (--entry->refCount > 0) { return; }
+
+    m_releasedBuffers.push_back(entry->id);
+    m_bufferHandles.erase(entry->name);
+    m_buffers.Remove(handle);
+}
+
+void ResourceManager::CollectGarbage()
+{
+    ++m_frameIndex;
+    EnforceTextureBudget();
+
+    // К началу кадра пакеты прошлого кадра уже отправлены - освобожденные объекты больше никем не используются
+    for (GLuint program : m_releasedPrograms)
+    {
+        glDeleteProgram(program);
+        if (m_renderer) { m_renderer->OnProgramDeleted(program); }
+    }
+    for (GLuint texture : m_releasedTextures)
+    {
+        // Bindless дескриптор снимается с резидентности до удаления текстуры
+        if (m_renderer) { m_renderer->OnTextureDeleted(texture); }
+        glDeleteTextures(1, &texture);
+    }
+    for (GLuint buffer : m_releasedBuffers)
+    {
+        if (m_renderer) { m_renderer->DeleteVBO(buffer); }
+        else { glDeleteBuffers(1, &buffer); }
+    }
+    m_releasedPrograms.clear();
+    m_releasedTextures.clear();
+    m_releasedBuffers.clear();
+}
+
+bool ResourceManager::EnableHotReload()
+{
+    if (m_fileWatcher.IsActive()) { return true; }
+    if (m_pack.IsOpen())
+    {
+        LOG_WARN("Hot reload is unavailable when assets are loaded from a pack");
+        return false;
+    }
+    if (!m_fileWatcher.Initialize()) { return false; }
+
+    bool watching = false;
+    for (const std::string& directory : {m_assetsPath, "../" + m_assetsPath})
+    {
+        if (fs::exists(directory)) { watching = m_fileWatcher.AddDirectory(directory) || watching; }
+    }
+    if (!watching)
+    {
+        m_fileWatcher.Shutdown();
+        return false;
+    }
+
+    LOG_INFO("Hot reload enabled for {}", m_assetsPath);
+    return true;
+}
+
+void ResourceManager::WatchShaderSources(const std::string& name, const std::string& vertexFile,
+                                         const std::string& fragmentFile)
+{
+    m_shaderSourceFiles[name] = {vertexFile, fragmentFile};
+}
+
+void ResourceManager::ProcessHotReload()
+{
+    if (!m_fileWatcher.IsActive()) { return; }
+
+    std::vector<std::string> changed;
+    m_fileWatcher.Poll(changed);
+    for (const std::string& path : changed) { OnAssetChanged(path); }
+
+    std::vector<ReloadedShader> reloaded;
+    {
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+        reloaded.swap(m_reloadedShaders);
+    }
+    for (const ReloadedShader& shader : reloaded) { ApplyShaderSources(shader); }
+
+    // Подменяются только собранные драйвером программы - кадр не ждет компилятор.
+    // Без GL_KHR_parallel_shader_compile узнать это нельзя, и подмена происходит сразу
+    for (ShaderEntry& entry : m_shaders)
+    {
+        if (entry.reload.program == 0) { continue; }
+
+        GLint done = GL_TRUE;
+        if (SupportsParallelShaderCompile()) { glGetProgramiv(entry.reload.program, GL_COMPLETION_STATUS_KHR, &done); }
+        if (done == GL_TRUE) { SwapProgram(entry); }
+    }
+}
+
+void ResourceManager::OnAssetChanged(const std::string& path)
+{
+    std::string filename = ExtractFilename(path);
+    std::string key      = ToLower(filename);
+
+    if (HasExtension(filename, TEXTURE_EXTENSIONS))
+    {
+        // Новый файл сразу становится доступен по имени
+        m_textureFilenames.try_emplace(key, path);
+
+        // Изменение запеченной версии перезагружает текстуру исходного имени
+        std::string textureName = key.ends_with(".ytex") ? key.substr(0, key.size() - 5) : key;
+        for (size_t i = 0; i < m_textures.Size(); ++i)
+        {
+            // Вытесненная текстура подхватит новую версию при следующей загрузке
+            const TextureEntry& entry = m_textures.At(i);
+            if (!entry.evicted && ToLower(entry.name) == textureName) { ReloadTexture(m_textures.GetHandle(i)); }
+        }
+    }
+    else if (HasExtension(filename, SHADER_EXTENSIONS))
+    {
+        m_shaderFilenames.try_emplace(key, path);
+        for (const auto& [name, files] : m_shaderSourceFiles)
+        {
+            if (ToLower(files.vertexFile) == key || ToLower(files.fragmentFile) == key) { ReloadShader(name, files); }
+        }
+    }
+}
+
+void ResourceManager::ReloadTexture(TextureHandle handle)
+{
+    TextureEntry& entry = *m_textures.Get(handle);
+
+    // Старое декодирование еще не закончилось - изменение подхватит следующее сохранение
+    if (entry.pending)
+    {
+        LOG_DEBUG("Texture {} is still loading, reload skipped", entry.name);
+        return;
+    }
+
+    // Новый файл потоковой текстуры - загрузка снова с мелких уровней. Если изменен исходник, запеченная
+    // версия устарела: текстура перестает быть потоковой и загружается из исходника, как при вытеснении
+    if (entry.stream)
+    {
+        if (StartTextureStream(entry))
+        {
+            LOG_INFO("Texture {} reloaded, streaming restarted", entry.name);
+            return;
+        }
+        entry.stream.reset();
+    }
+
+    // Запеченные уровни не декодируются - загрузка из отображенной памяти сразу
+    AssetData cooked;
+    if (HasCookedTexture(entry.name) && OpenTextureData(CookedTextureName(entry.name), cooked))
+    {
+        if (GLuint texture = LoadCookedTexture(cooked.data, cooked.size, cooked.source))
+        {
+            ReplaceTexture(entry, texture);
+            LOG_INFO("Texture {} reloaded from {}", entry.name, cooked.source);
+        }
+        return;
+    }
+
+    auto source = std::make_shared<AssetData>();
+    if (!m_threadPool || !OpenTextureData(entry.name, *source))
+    {
+        LOG_ERROR("Failed to reload texture {}", entry.name);
+        return;
+    }
+
+    // Пока идет декодирование, рисуется старая версия - подмена в ProcessPendingUploads
+    LOG_INFO("Reloading texture {}", entry.name);
+    QueueTextureDecode(handle, std::move(source), *m_threadPool);
+}
+
+void ResourceManager::ReloadShader(const std::string& name, const ShaderSourceFiles& files)
+{
+    // Пути разрешаются на главном потоке - карты имен рабочему потоку трогать нельзя
+    std::string vertexPath   = FindShaderPath(files.vertexFile);
+    std::string fragmentPath = FindShaderPath(files.fragmentFile);
+    if (vertexPath.empty() || fragmentPath.empty())
+    {
+        LOG_ERROR("Shader sources {} / {} for {} not found", files.vertexFile, files.fragmentFile, name);
+        return;
+    }
+
+    auto read = [this, name, vertexPath, fragmentPath] {
+        ReloadedShader shader{name, ReadFile(vertexPath), ReadFile(fragmentPath)};
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+        m_reloadedShaders.push_back(std::move(shader));
+    };
+
+    if (m_threadPool) { m_threadPool->Submit(read); }
+    else { read(); }
+    LOG_INFO("Reloading shader {}", name);
+}
+
+void ResourceManager::ApplyShaderSources(const ReloadedShader& reloaded)
+{
+    if (reloaded.vertexSource.empty() || reloaded.fragmentSource.empty())
+    {
+        LOG_ERROR("Failed to read sources of shader {}, reload skipped", reloaded.name);
+        return;
+    }
+
+    auto variants = m_shaderVariants.find(reloaded.name);
+    if (variants == m_shaderVariants.end())
+    {
+        ShaderEntry* entry = m_shaders.Get(FindShader(reloaded.name));
+        if (!entry)
+        {
+            LOG_WARN("Shader {} is not loaded, reload skipped", reloaded.name);
+            return;
+        }
+        SubmitReload(*entry, reloaded.vertexSource, reloaded.fragmentSource);
+        return;
+    }
+
+    // Набор вариантов: маски закодированы порядком ключевых слов, поэтому их список меняться не должен
+    ShaderVariantSet updated;
+    if (!updated.Initialize(reloaded.vertexSource, reloaded.fragmentSource) ||
+        updated.GetFeatures() != variants->second.GetFeatures())
+    {
+        LOG_WARN("Feature keywords of shader {} changed, restart to apply", reloaded.name);
+        return;
+    }
+
+    // Собранные варианты пересобираются за теми же дескрипторами, кэш по маскам сохраняется.
+    // Несобравшиеся варианты выпадают из кэша и пробуются заново при следующем запросе
+    for (const auto& [mask, handle] : variants->second.GetVariants())
+    {
+        ShaderEntry* entry = m_shaders.Get(handle);
+        if (!entry) { continue; }
+        updated.StoreVariant(mask, handle);
+        SubmitReload(*entry, updated.BuildVertexSource(mask), updated.BuildFragmentSource(mask));
+    }
+    variants->second = std::move(updated);
+}
+
+void ResourceManager::SubmitReload(ShaderEntry& entry, const std::string& vertexSource,
+                                   const std::string& fragmentSource)
+{
+    // Более новое сохранение отменяет еще не собранную версию
+    DeletePendingProgram(entry.reload);
+    entry.reload = SubmitProgram(vertexSource, fragmentSource);
+}
+
+bool ResourceManager::SwapProgram(ShaderEntry& entry)
+{
+    PendingProgram pending = entry.reload;
+    entry.reload           = {};
+
+    // Исходная асинхронная сборка еще не проверена - ее заменит новая версия
+    if (entry.pending.program != 0) { FinalizeShader(entry); }
+
+    if (!ValidateProgram(entry.name, pending))
+    {
+        LOG_WARN("Shader {} reload failed, keeping the previous version", entry.name);
+        return false;
+    }
+
+    // Значения uniform, загруженные один раз при инициализации (сэмплеры и т.п.), переносятся в новую версию
+    ShaderProgram replacement(pending.program);
+    if (entry.program)
+    {
+        replacement.RestoreUniforms(*entry.program);
+        m_releasedPrograms.push_back(entry.program->GetID());
+        *entry.program = std::move(replacement);
+    }
+    else { entry.program = std::make_unique<ShaderProgram>(std::move(replacement)); }
+
+    LOG_INFO("Shader {} reloaded", entry.name);
+    return true;
+}
+
+GLuint ResourceManager::GetPlaceholderTexture()
+{
+    if (m_placeholderTexture != 0) { return m_placeholderTexture; }
+
+    // Шахматка 2x2 пурпурный/черный - заметна на экране, пока настоящая текстура не загружена
+    // clang-format off
+    const unsigned char pixels[] = {
+        255, 0, 255, 255,   0, 0, 0, 255,
+        0,   0, 0,   255,   255, 0, 255, 255,
+    };
+    // clang-format on
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_placeholderTexture);
+    glTextureParameteri(m_placeholderTexture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(m_placeholderTexture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(m_placeholderTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_placeholderTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureStorage2D(m_placeholderTexture, 1, GL_RGBA8, 2, 2);
+    glTextureSubImage2D(m_placeholderTexture, 0, 0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    return m_placeholderTexture;
+}
+
+GLuint ResourceManager::GetTexture(TextureHandle handle) const
+{
+    const TextureEntry* entry = m_textures.Get(handle);
+    if (!entry)
+    {
+        LOG_ERROR("Texture handle {:#x} is not valid", handle.value);
+        return 0;
+    }
+    entry->lastUsedFrame = m_frameIndex;
+    return entry->id;
+}
+
+void ResourceManager::ReleaseTexture(TextureHandle handle)
+{
+    TextureEntry* entry = m_textures.Get(handle);
+    if (!entry || entry->refCount == 0)
+    {
+        LOG_WARN("Texture handle {:#x} released twice or never loaded", handle.value);
+        return;
+    }
+    if (--entry->refCount > 0) { return; }
+
+    // Без ссылок текстура остается в памяти как кэш - выгружает ее EnforceTextureBudget,
+    // когда память понадобится, начиная с давно не использованных
+    entry->lastUsedFrame = m_frameIndex;
+    LOG_DEBUG("Texture {} is no longer referenced", entry->name);
+}
+
+std::vector<std::string> ResourceManager::GetAvailableTextures() const
+{
+    std::vector<std::string> textures;
+    for (uint32_t i = 0; i < m_pack.GetEntryCount(); ++i)
+    {
+        std::string_view name = m_pack.GetEntryName(i);
+        if (HasExtension(name, TEXTURE_EXTENSIONS)) { textures.emplace_back(name); }
+    }
+    for (const auto& [filename, path] : m_textureFilenames)
+    {
+        textures.push_back(filename);
+    }
+    return textures;
+}
+
+void ResourceManager::PrintAvailableResources() const
+{
+    LOG_INFO("=== Available Resources ===");
+
+    if (m_pack.IsOpen())
+    {
+        LOG_INFO("Asset pack ({} entries):", m_pack.GetEntryCount());
+        for (uint32_t i = 0; i < m_pack.GetEntryCount(); ++i)
+        {
+            LOG_INFO("  - {}", m_pack.GetEntryName(i));
+        }
+    }
+
+    LOG_INFO("Textures ({}):", m_textureFilenames.size());
+    for (const auto& [filename, path] : m_textureFilenames)
+    {
+        LOG_INFO("  - {}", filename);
+    }
+
+    LOG_INFO("Shaders ({}):", m_shaderFilenames.size());
+    for (const auto& [filename, path] : m_shaderFilenames)
+    {
+        LOG_INFO("  - {}", filename);
+    }
+
+    LOG_INFO("========================");
+}
+
+std::string ResourceManager::ReadFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        LOG_ERROR("Failed to open file {}", path);
+        return "";
+    }
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void ResourceManager::Shutdown()
+{
+    if (m_shutdown) { return; }
+
+    // Фоновое декодирование читает из отображенных файлов и пакета - дожидаемся его до закрытия
+    if (m_threadPool) { m_threadPool->WaitIdle(); }
+
+    // Все живые объекты уходят в общий список освобожденных и удаляются одним проходом
+    UnpackTextureArrays();
+    for (ShaderEntry& entry : m_shaders)
+    {
+        DeletePendingProgram(entry.pending);
+        DeletePendingProgram(entry.reload);
+        if (entry.program) { m_releasedPrograms.push_back(entry.program->GetID()); }
+    }
+    for (const TextureEntry& entry : m_textures)
+    {
+        if (entry.id != m_placeholderTexture) { m_releasedTextures.push_back(entry.id); }
+    }
+    for (const BufferEntry& entry : m_buffers) { m_releasedBuffers.push_back(entry.id); }
+    if (m_placeholderArray != 0)
+    {
+        m_releasedTextures.push_back(m_placeholderArray);
+        m_placeholderArray = 0;
+    }
+    if (m_placeholderTexture != 0)
+    {
+        m_releasedTextures.push_back(m_placeholderTexture);
+        m_placeholderTexture = 0;
+    }
+    CollectGarbage();
+
+    m_shaders.Clear();
+    m_textures.Clear();
+    m_buffers.Clear();
+    m_shaderHandles.clear();
+    m_textureHandles.clear();
+    m_bufferHandles.clear();
+    m_shaderVariants.clear();
+    m_pendingTextureCount = 0;
+
+    m_fileWatcher.Shutdown();
+    m_shaderSourceFiles.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+        m_reloadedShaders.clear();
+    }
+
+    // Декодированные, но так и не загруженные в GPU данные
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        for (DecodedTexture& decoded : m_decodedTextures) { stbi_image_free(decoded.pixels); }
+        m_decodedTextures.clear();
+        m_streamedMips.clear();
+    }
+
+    m_textureFilenames.clear();
+    m_shaderFilenames.clear();
+    m_pack.Close();
+    m_shutdown = true;
+
+    LOG_INFO("ResourceManager shutdown completed");
+}
+
+void ResourceManager::BindTexture(TextureHandle handle, GLenum textureUnit) const
+{
+    GLuint textureID = GetTexture(handle);
+    if (textureID != 0)
     {
-        LOG_WARN("Failed to bind texture {}: not loaded", filename);
+        GLuint unit = textureUnit - GL_TEXTURE0;
+        if (m_renderer) { m_renderer->BindTexture(unit, textureID); }
+        else { glBindTextureUnit(unit, textureID); }
     }
 }
 
 ResourceManager::~ResourceManager()
 {
-    Shutdown();
+    // Статическое разрушение идет после glfwTerminate - без контекста удалять уже нечего и нечем
+    if (!m_shutdown) { Shutdown(); }
 }
@@ -7,10 +7,27 @@
 #define RESOURCEMANAGER_H
 
 #include <glad/glad.h>
+#include <initializer_list>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include "../render/ProgramBinaryCache.h"
+#include "../render/ShaderProgram.h"
+#include "../render/ShaderVariants.h"
+#include "AssetPack.h"
+#include "FileWatcher.h"
+#include "MappedFile.h"
+#include "ResourceHandles.h"
+#include "TextureContainer.h"
+#include "SlotMap.h"
+
+class Renderer;
+class ThreadPool;
 
 class ResourceManager
 {
@@ -19,21 +36,128 @@ public:
 
     // Инициализация с автоматическим сканированием папок
     void Initialize(const std::string& assetsPath = "assets");
+    // Рендер (через него идут привязки, чтобы кэш состояния оставался согласованным) и пул фоновых загрузок.
+    // Выставляет их владелец - Application; nullptr отключает привязки через рендер и асинхронные загрузки
+    void SetRenderer(Renderer* renderer) { m_renderer = renderer; }
+    void SetThreadPool(ThreadPool* pool) { m_threadPool = pool; }
+
+    // Ресурсы выдаются дескрипторами (index + generation): имя разрешается только при загрузке,
+    // доступ каждый кадр - индекс в массиве, устаревший дескриптор после выгрузки просто не находится.
+    // Каждый Load* добавляет ссылку, Release* ее снимает. Объект GL освобожденного ресурса удаляется
+    // в CollectGarbage в начале следующего кадра - пакеты текущего кадра еще могут на него ссылаться
+    // (текстуры без ссылок не удаляются сразу, а остаются в кэше под бюджетом видеопамяти)
+
     // Шейдеры
-    GLuint LoadShader(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource);
-    GLuint GetShader(const std::string& name) const;
-    void UnloadShader(const std::string& name);
+    ShaderHandle LoadShader(const std::string& name, const std::string& vertexSource,
+                            const std::string& fragmentSource);
+    // Программа из одного вычислительного шейдера (.comp), исполняется через Renderer::Dispatch.
+    // Загружается синхронно и так же проходит через кэш бинарников
+    ShaderHandle LoadComputeShader(const std::string& name, const std::string& computeSource);
+    struct ShaderSource
+    {
+        std::string name;
+        std::string vertexSource;
+        std::string fragmentSource;
+    };
+    // Пакетная загрузка: все компиляции и линковки отправляются сразу, статус проверяется
+    // при первом обращении к программе (GetShader / GetShaderProgram) или в ProcessPendingShaders
+    std::vector<ShaderHandle> LoadShadersAsync(const std::vector<ShaderSource>& programs);
+    // true - программа собрана и ее можно получить без ожидания драйвера
+    bool IsShaderReady(ShaderHandle handle) const;
+    // Завершение уже собранных драйвером программ, без ожидания. Работает только с GL_KHR_parallel_shader_compile
+    void ProcessPendingShaders();
+    size_t GetPendingShaderCount() const;
+    // Дескриптор загруженной программы без добавления ссылки
+    ShaderHandle FindShader(const std::string& name) const;
+    GLuint       GetShader(ShaderHandle handle);
+    // Программа с таблицей uniform переменных, собранной при линковке. Адрес стабилен до выгрузки
+    ShaderProgram* GetShaderProgram(ShaderHandle handle);
+    void           ReleaseShader(ShaderHandle handle);
+    // Варианты шейдера: ключевые слова из "#pragma features ...", #define вставляются движком.
+    // Вариант собирается при первом запросе и кэшируется по битовой маске ключевых слов.
+    // Вариантами владеет набор - их дескрипторы действительны до UnloadShaderVariants
+    bool RegisterShaderVariants(const std::string& name, const std::string& vertexSource,
+                                const std::string& fragmentSource);
+    uint32_t GetShaderFeatureMask(const std::string& name, std::initializer_list<std::string_view> features) const;
+    ShaderHandle GetShaderVariant(const std::string& name, uint32_t featureMask);
+    // Заранее отправить варианты на сборку (через LoadShadersAsync), чтобы первый кадр не ждал компилятор
+    void WarmUpShaderVariants(const std::string& name, const std::vector<uint32_t>& featureMasks);
+    void UnloadShaderVariants(const std::string& name);
 
     // Текстуры - теперь поддерживают как файлы, так и встроенные данные
-    GLuint LoadTexture(const std::string& filename); // Сначала ищет встроенные, потом файлы
-    GLuint LoadTextureFromFile(const std::string& filename); // Принудительно из файла
-    GLuint LoadTextureFromMemory(const std::string& name, const unsigned char* data, size_t size); // Из памяти
-    GLuint GetTexture(const std::string& filename) const;
-    void UnloadTexture(const std::string& filename);
+    TextureHandle LoadTexture(const std::string& filename); // Сначала ищет встроенные, потом файлы
+    TextureHandle LoadTextureFromFile(const std::string& filename); // Принудительно из файла
+    TextureHandle LoadTextureFromMemory(const std::string& name, const unsigned char* data, size_t size); // Из памяти
+    // Асинхронная загрузка: декодирование на пуле потоков, загрузка в GPU в ProcessPendingUploads.
+    // До готовности дескриптор указывает на текстуру-заглушку, поэтому ID нужно запрашивать каждый кадр
+    TextureHandle LoadTextureAsync(const std::string& filename);
+    // Потоковая загрузка по уровням mip (только запеченные .ytex): сразу грузятся мелкие уровни, крупные
+    // читаются с диска на пуле по запросам RequestTextureResolution и выгружаются, когда перестают быть нужны.
+    // Без запеченной версии - обычная асинхронная загрузка
+    TextureHandle LoadTextureStreamed(const std::string& filename);
+    // Размер текстуры на экране в пикселях в этом кадре (см. Renderer::EstimateScreenSize).
+    // Из нескольких запросов за кадр берется наибольший
+    void RequestTextureResolution(TextureHandle handle, float screenSize);
+    // Загрузка прочитанных уровней в GPU (не дольше budgetMs) и новые чтения по запросам прошлого кадра
+    void ProcessTextureStreaming(double budgetMs);
+    TextureHandle FindTexture(const std::string& filename) const;
+    GLuint        GetTexture(TextureHandle handle) const;
+    bool          IsTextureReady(TextureHandle handle) const;
+    void          ReleaseTexture(TextureHandle handle);
+    // Упаковка небольших текстур в слои GL_TEXTURE_2D_ARRAY: текстуры одного формата, размера и числа уровней
+    // попадают в общий массив, и отрисовки с ними различаются слоем (InstanceData::textureLayer), а не привязкой.
+    // Отдельные текстуры остаются для шейдеров с sampler2D, замены (перезагрузка, mip) копируются в слой.
+    // Потоковые текстуры пакуются в текущем резидентном размере. Повторный вызов пересобирает массивы заново
+    // и заодно уплотняет их после упаковки по требованию (AcquireTextureLayer). Возвращает число упакованных текстур
+    static constexpr uint32_t TEXTURE_ARRAY_MAX_SIZE = 256;
+    size_t                    PackTextureArrays(uint32_t maxSize = TEXTURE_ARRAY_MAX_SIZE);
+    struct TextureLayer
+    {
+        GLuint texture = 0; // Массив, 0 - текстура не упакована
+        float  layer   = 0.0f;
+    };
+    TextureLayer GetTextureLayer(TextureHandle handle) const;
+    // Слой с упаковкой по требованию: неупакованная текстура сразу копируется в свободный слой массива своей
+    // формы (без ограничения размера). Потоковая текстура после смены резидентных уровней переходит в массив
+    // новой формы при следующем вызове. Еще не загруженная текстура получает слой заглушки
+    TextureLayer AcquireTextureLayer(TextureHandle handle);
+    // Текстура для DrawPacket программы с MaterialBuffer: с bindless - сама текстура, иначе ее слой массива.
+    // Неупакованная текстура (в том числе потоковая) получает слой по требованию через AcquireTextureLayer
+    TextureLayer GetMaterialTexture(TextureHandle handle);
+    // Загрузка декодированных текстур в GPU на главном потоке, не дольше budgetMs (минимум одна за вызов)
+    void ProcessPendingUploads(double budgetMs);
+    size_t GetPendingTextureCount() const { return m_pendingTextureCount; }
+    GLuint GetPlaceholderTexture();
+    // Бюджет видеопамяти текстур (с учетом mip). Текстуры без ссылок остаются в памяти как кэш и при превышении
+    // бюджета выгружаются начиная с давно не использованных; следующий Load* по имени загружает их снова
+    // за тем же дескриптором. 0 - без ограничения
+    void   SetTextureBudget(size_t bytes) { m_textureBudget = bytes; }
+    size_t GetTextureBudget() const { return m_textureBudget; }
+    size_t GetTextureMemoryUsage() const { return m_textureMemory; }
+
+    // Буферы (вершины, индексы и т.п.) с неизменным содержимым
+    BufferHandle CreateBuffer(const std::string& name, const void* data, GLsizeiptr size,
+                              GLenum usage = GL_STATIC_DRAW);
+    GLuint       GetBuffer(BufferHandle handle) const;
+    void         ReleaseBuffer(BufferHandle handle);
+
+    // Удаление объектов GL, освобожденных в прошлом кадре, и вытеснение текстур сверх бюджета
+    void CollectGarbage();
+    // Горячая перезагрузка: наблюдение за папкой ассетов (только без пакета и только на Linux)
+    bool EnableHotReload();
+    // Файлы исходников программы или набора вариантов, по изменению которых она пересобирается
+    void WatchShaderSources(const std::string& name, const std::string& vertexFile, const std::string& fragmentFile);
+    // Разбор изменений: текстуры декодируются и исходники читаются на пуле, программы собирает драйвер.
+    // Готовые объекты подменяются за теми же дескрипторами, ShaderProgram* остаются действительными
+    void ProcessHotReload();
+    // Исходник шейдера из пакета или из папки шейдеров
+    std::string ReadShaderSource(const std::string& filename) const;
     // Утилиты
     static std::string ReadFile(const std::string& path);
+    // Удаляет все объекты GL - вызывается, пока контекст, рендер и пул еще живы (Application::ShutdownEngine).
+    // Деструктор singleton'а повторяет его, только если Shutdown не вызывали
     void Shutdown();
-    void BindTexture(const std::string& filename, GLenum textureUnit) const;
+    void BindTexture(TextureHandle handle, GLenum textureUnit) const;
     // Информация о доступных ресурсах
     std::vector<std::string> GetAvailableTextures() const;
     void PrintAvailableResources() const;
@@ -44,23 +168,246 @@ private:
     // Сканирование папок
     void ScanTextures();
     void ScanShaders();
-    // Поиск файлов
+    // Поиск файлов без учета регистра
     std::string FindTexturePath(const std::string& filename) const;
     std::string FindShaderPath(const std::string& filename) const;
 
+    // Байты ассета: срез пакета или отображенный в память файл с диска
+    struct AssetData
+    {
+        MappedFile     file; // Пуст, если данные лежат в пакете
+        const uint8_t* data = nullptr;
+        size_t         size = 0;
+        std::string    source; // Путь или имя в пакете для сообщений
+    };
+    bool HasTextureData(const std::string& filename) const;
+    // Есть запеченная версия (<filename>.ytex) не старше исходника. В пакете исходников нет - годится любая
+    bool HasCookedTexture(const std::string& filename) const;
+    bool OpenTextureData(const std::string& filename, AssetData& asset) const;
+
+    // Программа, отправленная драйверу, но еще не проверенная
+    struct PendingProgram
+    {
+        GLuint   program        = 0;
+        GLuint   vertexShader   = 0; // Все стадии 0 - программа загружена из кэша бинарников
+        GLuint   fragmentShader = 0;
+        GLuint   computeShader  = 0;
+        uint64_t cacheKey       = 0;
+
+        bool FromCache() const { return vertexShader == 0 && fragmentShader == 0 && computeShader == 0; }
+    };
+    PendingProgram SubmitProgram(const std::string& vertexSource, const std::string& fragmentSource);
+    PendingProgram SubmitComputeProgram(const std::string& computeSource);
+    // Проверка статусов и сохранение в кэш бинарников. При ошибке объекты GL удаляются
+    bool ValidateProgram(const std::string& name, PendingProgram& pending);
+    static void DeletePendingProgram(PendingProgram& pending);
+
+    struct ShaderEntry
+    {
+        std::string                    name;
+        std::unique_ptr<ShaderProgram> program; // nullptr, пока программа собирается или если сборка не удалась
+        PendingProgram                 pending; // Отправлена LoadShadersAsync, еще не проверена
+        PendingProgram                 reload;  // Новая версия после правки исходников
+        uint32_t                       refCount = 0;
+    };
+    // Потоковая текстура: в GPU уровни [residentLevel, mipCount), остальные читаются из файла по запросу
+    struct TextureStream
+    {
+        static constexpr uint32_t NO_REQUEST = ~0u;
+
+        std::shared_ptr<AssetData> source; // Держит отображение файла, пока текстура загружается по уровням
+        YtexView                   view;
+        GLenum                     internalFormat = 0;
+        GLenum                     format         = 0;
+        bool                       compressed     = false;
+        uint32_t                   initialLevel   = 0; // Ниже него уровни не выгружаются
+        uint32_t                   residentLevel  = 0;
+        uint32_t                   requestedLevel = NO_REQUEST; // Самый детальный уровень, запрошенный за кадр
+        uint64_t                   fineFrame      = 0; // Последний кадр, когда residentLevel был нужен
+        bool                       reading        = false; // Уровень residentLevel - 1 читается на пуле
+    };
+    struct TextureEntry
+    {
+        std::string                    name;
+        GLuint                         id            = 0; // Заглушка, пока идет асинхронная загрузка или вытеснена
+        size_t                         memorySize    = 0; // Байт в видеопамяти вместе с цепочкой mip
+        mutable uint64_t               lastUsedFrame = 0; // Для LRU: обновляется при каждом обращении
+        uint32_t                       refCount      = 0;
+        bool                           pending       = false; // Декодируется на пуле
+        bool                           evicted       = false; // Выгружена по бюджету, загрузится при следующем Load*
+        int32_t                        arrayIndex    = -1; // Массив в m_textureArrays, -1 - не упакована
+        uint32_t                       arrayLayer    = 0;
+        std::unique_ptr<TextureStream> stream; // nullptr - все уровни загружены сразу
+    };
+    struct BufferEntry
+    {
+        std::string name;
+        GLuint      id       = 0;
+        GLsizeiptr  size     = 0;
+        uint32_t    refCount = 0;
+    };
+
+    ShaderHandle  AddShaderReference(const std::string& name);
+    TextureHandle AddTextureReference(const std::string& name);
+    TextureHandle InsertTexture(const std::string& name, GLuint texture);
+    // Синхронное создание: запеченная версия или декодирование исходника
+    GLuint CreateTexture(const std::string& filename);
+    // Повторная загрузка вытесненной текстуры за ее дескриптором
+    void RestoreTexture(TextureHandle handle, bool async);
+    void EnforceTextureBudget();
+    // Проверка отправленной программы и рефлексия при первом обращении
+    bool FinalizeShader(ShaderEntry& entry);
+
+    // Горячая перезагрузка
+    struct ShaderSourceFiles
+    {
+        std::string vertexFile;
+        std::string fragmentFile;
+    };
+    // Исходники, прочитанные рабочим потоком
+    struct ReloadedShader
+    {
+        std::string name;
+        std::string vertexSource;
+        std::string fragmentSource;
+    };
+    void OnAssetChanged(const std::string& path);
+    void ReloadTexture(TextureHandle handle);
+    void ReloadShader(const std::string& name, const ShaderSourceFiles& files);
+    void ApplyShaderSources(const ReloadedShader& reloaded);
+    void SubmitReload(ShaderEntry& entry, const std::string& vertexSource, const std::string& fragmentSource);
+    // Новая версия встает на место старой за тем же дескриптором. При ошибке остается старая
+    bool SwapProgram(ShaderEntry& entry);
+
     // Извлечение имени файла без пути и расширения
     std::string ExtractFilename(const std::string& path) const;
 
     // Вспомогательная функция для загрузки текстуры из данных в памяти
-    GLuint CreateTextureFromData(const unsigned char* data, int width, int height, int channels);
+    // staged - копирование через потоковый буфер рендера (PBO), драйвер забирает данные без блокировки
+    GLuint CreateTextureFromData(const unsigned char* data, int width, int height, int channels, bool staged = false);
+
+    // Загрузка .ytex, созданного yagl_texcook: уровни mip грузятся как есть прямо из отображенной памяти
+    GLuint LoadCookedTexture(const uint8_t* data, size_t size, const std::string& path);
+    bool   ParseCookedTexture(const uint8_t* data, size_t size, const std::string& path, TextureStream& stream);
+    // Текстура из уровней [firstLevel, mipCount). Уровни, уже загруженные в previous (начиная с residentLevel),
+    // копируются на GPU; уровень firstLevel берется из firstLevelData, если он прочитан заранее
+    GLuint BuildCookedTexture(const TextureStream& stream, uint32_t firstLevel, GLuint previous,
+                              const uint8_t* firstLevelData);
+    // Открытие запеченной версии и загрузка начальных уровней. false - запеченной версии нет или она повреждена
+    bool StartTextureStream(TextureEntry& entry);
+    void QueueMipRead(TextureHandle handle, TextureStream& stream, ThreadPool& pool);
+
+    // Массивы упакованных текстур: слой i - копия текстуры layers[i]
+    struct TextureShape
+    {
+        GLint internalFormat = 0;
+        GLint width          = 0;
+        GLint height         = 0;
+        GLint levels         = 0;
+
+        bool operator==(const TextureShape&) const = default;
+    };
+    struct TextureArray
+    {
+        GLuint                     id         = 0; // 0 - массив освобожден, запись ждет повторного использования
+        TextureShape               shape;
+        size_t                     memorySize = 0;
+        std::vector<TextureHandle> layers; // Пустой дескриптор - свободный слой
+    };
+    static TextureShape QueryTextureShape(GLuint texture);
+    static void         CopyToArrayLayer(GLuint texture, const TextureArray& array, uint32_t layer);
+    void                UnpackTextureArrays();
+    // Массив на capacity слоев (все свободны), индекс в m_textureArrays
+    size_t CreateTextureArray(const TextureShape& shape, uint32_t capacity);
+    // Перенос слоев в хранилище большей емкости - immutable хранилище не растет на месте
+    void GrowTextureArray(TextureArray& array, uint32_t capacity);
+    void AssignTextureLayer(TextureHandle handle, TextureEntry& entry);
+    // Освобождает слой текстуры, опустевший массив удаляется
+    void FreeTextureLayer(TextureEntry& entry);
+    TextureLayer GetPlaceholderLayer();
+
+    void QueueTextureDecode(TextureHandle handle, std::shared_ptr<AssetData> source, ThreadPool& pool);
+    void ReplaceTexture(TextureEntry& entry, GLuint texture);
+
+    // Результат фонового декодирования, ожидающий загрузки в GPU
+    struct DecodedTexture
+    {
+        TextureHandle  handle;
+        std::string    filename;
+        unsigned char* pixels   = nullptr; // Память stb_image, nullptr при ошибке
+        int            width    = 0;
+        int            height   = 0;
+        int            channels = 0;
+    };
+
+    // Уровень mip, прочитанный рабочим потоком
+    struct StreamedMip
+    {
+        TextureHandle              handle;
+        std::shared_ptr<AssetData> source; // Сверяется с потоком текстуры - файл мог смениться за время чтения
+        uint32_t                   level = 0;
+        std::vector<uint8_t>       data;
+    };
+
+    // Потоковая загрузка: начальный уровень не крупнее INITIAL_SIZE, лишний уровень выгружается,
+    // если не был нужен DROP_FRAMES кадров подряд
+    static constexpr uint32_t STREAMING_INITIAL_SIZE = 64;
+    static constexpr uint64_t STREAMING_DROP_FRAMES  = 120;
 
     std::string m_assetsPath;
-    std::unordered_map<std::string, GLuint> m_shaders;
-    std::unordered_map<std::string, GLuint> m_textures;
+    Renderer*   m_renderer   = nullptr;
+    ThreadPool* m_threadPool = nullptr;
+
+    // Плотные хранилища ресурсов и разрешение имен при загрузке
+    SlotMap<ShaderEntry, ShaderHandle>                m_shaders;
+    SlotMap<TextureEntry, TextureHandle>              m_textures;
+    SlotMap<BufferEntry, BufferHandle>                m_buffers;
+    std::unordered_map<std::string, ShaderHandle>     m_shaderHandles;
+    std::unordered_map<std::string, TextureHandle>    m_textureHandles;
+    std::unordered_map<std::string, BufferHandle>     m_bufferHandles;
+    std::unordered_map<std::string, ShaderVariantSet> m_shaderVariants;
+
+    // Учет видеопамяти текстур. Кадр отсчитывается в CollectGarbage
+    static constexpr size_t DEFAULT_TEXTURE_BUDGET = 512ull * 1024 * 1024;
+    size_t                  m_textureBudget        = DEFAULT_TEXTURE_BUDGET;
+    size_t                  m_textureMemory        = 0;
+    uint64_t                m_frameIndex           = 0;
+
+    // Массивы упакованных текстур (PackTextureArrays, AcquireTextureLayer)
+    std::vector<TextureArray> m_textureArrays;
+    GLuint                    m_placeholderArray = 0; // Заглушка одним слоем - для еще не загруженных текстур
+
+    // Освобожденные объекты GL, ожидающие CollectGarbage
+    std::vector<GLuint> m_releasedPrograms;
+    std::vector<GLuint> m_releasedTextures;
+    std::vector<GLuint> m_releasedBuffers;
+
+    // Асинхронные загрузки: готовые к загрузке в GPU результаты от рабочих потоков
+    GLuint                      m_placeholderTexture  = 0;
+    size_t                      m_pendingTextureCount = 0;
+    std::vector<DecodedTexture> m_decodedTextures;
+    std::vector<StreamedMip>    m_streamedMips;
+    std::mutex                  m_decodedMutex; // Общий для декодированных текстур и прочитанных уровней
+
+    // Пакет ассетов - если открыт, папки не сканируются
+    AssetPack m_pack;
+
+    // Shutdown уже выполнен (до следующего Initialize) - деструктор его не повторяет
+    bool m_shutdown = false;
+
+    // Слинкованные программы между запусками
+    static constexpr const char* SHADER_CACHE_DIRECTORY = "shader_cache";
+    ProgramBinaryCache           m_programCache;
+
+    // Горячая перезагрузка
+    FileWatcher                                        m_fileWatcher;
+    std::unordered_map<std::string, ShaderSourceFiles> m_shaderSourceFiles;
+    std::vector<ReloadedShader>                        m_reloadedShaders;
+    std::mutex                                         m_reloadMutex;
 
     // Карты для быстрого поиска путей по именам файлов
-    std::unordered_map<std::string, std::string> m_textureFilenames; // filename -> full_path
-    std::unordered_map<std::string, std::string> m_shaderFilenames; // filename -> full_path
+    std::unordered_map<std::string, std::string> m_textureFilenames; // lowercase filename -> full_path
+    std::unordered_map<std::string, std::string> m_shaderFilenames; // lowercase filename -> full_path
 };
 
 #define RESOURCE_MANAGER ResourceManager::GetInstance()
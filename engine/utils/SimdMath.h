@@ -0,0 +1,21 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef SIMDMATH_H
+#define SIMDMATH_H
+
+// Доступные наборы инструкций. SSE2 входит в базовый x86-64, AVX включается опцией YAGL_ENABLE_AVX.
+// На остальных архитектурах ядра используют скалярный путь
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YAGL_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define YAGL_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#endif // SIMDMATH_H
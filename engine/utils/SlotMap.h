@@ -0,0 +1,154 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * 32-битный дескриптор: индекс слота (младшие 20 бит) и поколение слота (старшие 12 бит)
+ * Поколение растет при каждом удалении, поэтому дескриптор удаленного объекта перестает находиться,
+ * даже если его слот уже занят другим. Поколения начинаются с 1 - нулевое значение всегда пустой дескриптор.
+ * Tag различает дескрипторы разных типов ресурсов на этапе компиляции.
+ */
+template <typename Tag>
+struct Handle
+{
+    static constexpr uint32_t INDEX_BITS      = 20;
+    static constexpr uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    uint32_t value = 0;
+
+    static Handle Make(uint32_t index, uint32_t generation) { return {(generation << INDEX_BITS) | index}; }
+
+    uint32_t GetIndex() const { return value & INDEX_MASK; }
+    uint32_t GetGeneration() const { return value >> INDEX_BITS; }
+
+    explicit operator bool() const { return value != 0; }
+    bool     operator==(const Handle& other) const { return value == other.value; }
+    bool     operator!=(const Handle& other) const { return value != other.value; }
+};
+
+/**
+ * Плотное хранилище с доступом по дескрипторам
+ * Значения лежат подряд в одном массиве, слоты переводят индекс дескриптора в позицию значения -
+ * поиск это два обращения к массивам без хэширования. Удаление переносит последнее значение на место
+ * удаленного, поэтому адреса значений меняются при вставке и удалении: хранить нужно дескриптор.
+ */
+template <typename T, typename HandleT>
+class SlotMap
+{
+public:
+    // Пустой дескриптор, если исчерпаны индексы
+    HandleT Insert(T value)
+    {
+        uint32_t slotIndex;
+        if (m_freeHead != INVALID)
+        {
+            slotIndex  = m_freeHead;
+            m_freeHead = m_slots[slotIndex].dense;
+        }
+        else
+        {
+            if (m_slots.size() > HandleT::INDEX_MASK) { return {}; }
+            slotIndex = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back({INVALID, 1});
+        }
+
+        Slot& slot = m_slots[slotIndex];
+        slot.dense = static_cast<uint32_t>(m_values.size());
+        m_values.push_back(std::move(value));
+        m_denseToSlot.push_back(slotIndex);
+        return HandleT::Make(slotIndex, slot.generation);
+    }
+
+    T* Get(HandleT handle) { return const_cast<T*>(std::as_const(*this).Get(handle)); }
+
+    const T* Get(HandleT handle) const
+    {
+        uint32_t index = handle.GetIndex();
+        if (!handle || index >= m_slots.size() || m_slots[index].generation != handle.GetGeneration())
+        {
+            return nullptr;
+        }
+        return &m_values[m_slots[index].dense];
+    }
+
+    bool Contains(HandleT handle) const { return Get(handle) != nullptr; }
+
+    bool Remove(HandleT handle)
+    {
+        if (!Contains(handle)) { return false; }
+
+        uint32_t slotIndex = handle.GetIndex();
+        uint32_t dense     = m_slots[slotIndex].dense;
+        uint32_t last      = static_cast<uint32_t>(m_values.size() - 1);
+        if (dense != last)
+        {
+            m_values[dense]                     = std::move(m_values[last]);
+            m_denseToSlot[dense]                = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].dense = dense;
+        }
+        m_values.pop_back();
+        m_denseToSlot.pop_back();
+
+        Release(slotIndex);
+        return true;
+    }
+
+    void Clear()
+    {
+        for (uint32_t slotIndex : m_denseToSlot) { Release(slotIndex); }
+        m_values.clear();
+        m_denseToSlot.clear();
+    }
+
+    // Обход по плотному массиву
+    size_t   Size() const { return m_values.size(); }
+    bool     Empty() const { return m_values.empty(); }
+    T&       At(size_t denseIndex) { return m_values[denseIndex]; }
+    const T& At(size_t denseIndex) const { return m_values[denseIndex]; }
+    HandleT  GetHandle(size_t denseIndex) const
+    {
+        uint32_t slotIndex = m_denseToSlot[denseIndex];
+        return HandleT::Make(slotIndex, m_slots[slotIndex].generation);
+    }
+
+    auto begin() { return m_values.begin(); }
+    auto end() { return m_values.end(); }
+    auto begin() const { return m_values.begin(); }
+    auto end() const { return m_values.end(); }
+
+private:
+    static constexpr uint32_t INVALID = ~0u;
+
+    struct Slot
+    {
+        uint32_t dense;      // Позиция значения, у свободного слота - следующий свободный
+        uint32_t generation; // Поколение живого дескриптора этого слота
+    };
+
+    // Новое поколение делает старые дескрипторы недействительными, слот уходит в список свободных
+    void Release(uint32_t slotIndex)
+    {
+        Slot& slot      = m_slots[slotIndex];
+        slot.generation = (slot.generation + 1) & HandleT::GENERATION_MASK;
+        if (slot.generation == 0) { slot.generation = 1; }
+        slot.dense = m_freeHead;
+        m_freeHead = slotIndex;
+    }
+
+    std::vector<T>        m_values;
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<Slot>     m_slots;
+    uint32_t              m_freeHead = INVALID;
+};
+#endif // SLOTMAP_H
@@ -0,0 +1,142 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef TEXTURECONTAINER_H
+#define TEXTURECONTAINER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Формат запеченной текстуры .ytex - готовые к загрузке в GPU уровни mip
+ * Файл создается утилитой yagl_texcook: пиксели уже перевернуты по вертикали (как stbi_set_flip_vertically_on_load),
+ * цепочка mip посчитана заранее, строки упакованы без выравнивания (GL_UNPACK_ALIGNMENT = 1).
+ *
+ * Раскладка: YtexHeader | YtexMip[mipCount] | данные уровней (каждый с выравниванием YTEX_DATA_ALIGNMENT)
+ * Все числа little-endian.
+ */
+
+constexpr uint32_t YTEX_MAGIC          = 0x58455459; // "YTEX"
+constexpr uint16_t YTEX_VERSION        = 1;
+constexpr uint32_t YTEX_DATA_ALIGNMENT = 16;
+constexpr uint32_t YTEX_MAX_MIPS       = 16;
+
+// Формат пикселей уровней
+enum class YtexFormat : uint32_t
+{
+    R8    = 1,
+    RGB8  = 2,
+    RGBA8 = 3,
+    BC1   = 4, // Блоки 4x4 по 8 байт, без альфы
+    BC3   = 5, // Блоки 4x4 по 16 байт, альфа + цвет
+};
+
+enum YtexFlags : uint16_t
+{
+    YTEX_FLAG_FLIPPED = 1 << 0, // Строки идут снизу вверх, как ожидает OpenGL
+};
+
+struct YtexHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t format; // YtexFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipCount;
+    uint32_t reserved[2];
+};
+
+struct YtexMip
+{
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset; // От начала файла
+    uint64_t size;   // В байтах
+};
+
+static_assert(sizeof(YtexHeader) == 32, "YtexHeader layout is part of the file format");
+static_assert(sizeof(YtexMip) == 24, "YtexMip layout is part of the file format");
+
+inline bool IsYtexCompressed(YtexFormat format) { return format == YtexFormat::BC1 || format == YtexFormat::BC3; }
+
+// Размер одного уровня в байтах
+inline uint64_t YtexLevelSize(YtexFormat format, uint32_t width, uint32_t height)
+{
+    uint64_t blocks = static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4);
+    switch (format)
+    {
+    case YtexFormat::R8: return static_cast<uint64_t>(width) * height;
+    case YtexFormat::RGB8: return static_cast<uint64_t>(width) * height * 3;
+    case YtexFormat::RGBA8: return static_cast<uint64_t>(width) * height * 4;
+    case YtexFormat::BC1: return blocks * 8;
+    case YtexFormat::BC3: return blocks * 16;
+    }
+    return 0;
+}
+
+// Разобранный файл - указатели внутрь отображенной памяти, без копирования
+struct YtexView
+{
+    const YtexHeader* header = nullptr;
+    const YtexMip*    mips   = nullptr;
+    const uint8_t*    base   = nullptr;
+
+    YtexFormat     GetFormat() const { return static_cast<YtexFormat>(header->format); }
+    const uint8_t* GetLevelData(uint32_t level) const { return base + mips[level].offset; }
+};
+
+// Проверка заголовка, цепочки и границ всех уровней. false - файл поврежден или другой версии.
+// Размеры уровней сверяются с заголовком: GL читает уровень по размерам хранилища, а не по записи в таблице
+inline bool ParseYtex(const void* data, size_t size, YtexView& view)
+{
+    if (!data || size < sizeof(YtexHeader)) { return false; }
+
+    const auto* base   = static_cast<const uint8_t*>(data);
+    const auto* header = reinterpret_cast<const YtexHeader*>(base);
+    if (header->magic != YTEX_MAGIC || header->version != YTEX_VERSION) { return false; }
+    if (header->mipCount == 0 || header->mipCount > YTEX_MAX_MIPS) { return false; }
+    if (header->format < static_cast<uint32_t>(YtexFormat::R8) ||
+        header->format > static_cast<uint32_t>(YtexFormat::BC3))
+    {
+        return false;
+    }
+    if (header->width == 0 || header->height == 0) { return false; }
+
+    // Цепочка не длиннее полной до 1x1
+    uint32_t fullChain = 1;
+    for (uint32_t extent = header->width > header->height ? header->width : header->height; extent > 1; extent /= 2)
+    {
+        ++fullChain;
+    }
+    if (header->mipCount > fullChain) { return false; }
+
+    size_t tableEnd = sizeof(YtexHeader) + header->mipCount * sizeof(YtexMip);
+    if (size < tableEnd) { return false; }
+
+    const auto* mips = reinterpret_cast<const YtexMip*>(base + sizeof(YtexHeader));
+    for (uint32_t i = 0; i < header->mipCount; ++i)
+    {
+        uint32_t width  = header->width >> i;
+        uint32_t height = header->height >> i;
+        if (mips[i].width != (width > 0 ? width : 1) || mips[i].height != (height > 0 ? height : 1)) { return false; }
+        if (mips[i].offset < tableEnd || mips[i].offset > size || mips[i].size > size - mips[i].offset)
+        {
+            return false;
+        }
+        if (mips[i].size != YtexLevelSize(static_cast<YtexFormat>(header->format), mips[i].width, mips[i].height))
+        {
+            return false;
+        }
+    }
+
+    view.header = header;
+    view.mips   = mips;
+    view.base   = base;
+    return true;
+}
+#endif // TEXTURECONTAINER_H
@@ -0,0 +1,105 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "ThreadPool.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    if (threadCount == 0) { threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1; }
+
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) { m_workers.emplace_back(&ThreadPool::WorkerLoop, this); }
+
+    LOG_INFO("Thread pool started with {} workers", threadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+
+    // Оставшиеся в очереди задачи дорабатываются до выхода потоков
+    for (std::thread& worker : m_workers) { worker.join(); }
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& f)
+{
+    if (count == 0) { return; }
+
+    // Помощник, взятый пулом уже после возврата, видит исчерпанный счетчик и не трогает f -
+    // поэтому состояние живет в shared_ptr, а не на стеке вызывающего
+    struct State
+    {
+        std::atomic<size_t>                next{0};
+        std::atomic<size_t>                done{0};
+        const std::function<void(size_t)>* f     = nullptr;
+        size_t                             count = 0;
+    };
+    auto state   = std::make_shared<State>();
+    state->f     = &f;
+    state->count = count;
+
+    auto work = [](State& shared) {
+        for (size_t index = shared.next++; index < shared.count; index = shared.next++)
+        {
+            (*shared.f)(index);
+            if (++shared.done == shared.count) { shared.done.notify_one(); }
+        }
+    };
+
+    size_t helpers = std::min<size_t>(GetThreadCount(), count - 1);
+    for (size_t i = 0; i < helpers; ++i) { Submit([state, work] { work(*state); }); }
+    work(*state);
+
+    // Ждем только индексы, которые уже исполняются на пуле
+    for (size_t done = state->done; done != count; done = state->done) { state->done.wait(done); }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) { return; }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_activeTasks;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeTasks;
+            if (m_tasks.empty() && m_activeTasks == 0) { m_idle.notify_all(); }
+        }
+    }
+}
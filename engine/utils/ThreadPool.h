@@ -0,0 +1,54 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Пул рабочих потоков для фоновых задач движка (декодирование ресурсов и т.п.)
+ * Задачи не должны обращаться к OpenGL - контекст принадлежит только главному потоку.
+ */
+class ThreadPool
+{
+public:
+    // 0 - по числу ядер минус главный поток
+    explicit ThreadPool(uint32_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task);
+    // Ожидание завершения всех поставленных задач
+    void WaitIdle();
+    // f(index) для каждого index из [0, count) на пуле и вызывающем потоке. Индексы разбираются из общего
+    // счетчика, поэтому вызывающий поток не ждет, пока пул доберется до помощников за чужими задачами в очереди,
+    // а сам забирает все, что не успели взять. Возврат - после завершения всех f; из задачи пула вызывать можно
+    void ParallelFor(size_t count, const std::function<void(size_t)>& f);
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread>          m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_taskAvailable;
+    std::condition_variable           m_idle;
+    uint32_t                          m_activeTasks = 0; // Задачи, исполняемые прямо сейчас
+    bool                              m_stopping    = false;
+};
+#endif // THREADPOOL_H
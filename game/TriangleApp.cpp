@@ -3,8 +3,10 @@
 #include "../engine/utils/Logger.h"
 #include "AllShaders.h"
 #include "GLFW/glfw3.h"
-#include "glm/gtc/type_ptr.hpp"
+#include "render/ShaderProgram.h"
 #include "render/TransformManager.h"
+#include "scene/Components.h"
+#include "scene/Scene.h"
 #include "utils/ResourceManager.h"
 #include <chrono>
 
@@ -24,15 +26,21 @@ void TriangleApp::Initialize()
     // Показываем доступные ресурсы (для отладки)
     RESOURCE_MANAGER.PrintAvailableResources();
 
-    // Пытаемся использовать встроенные шейдеры через ResourceManager
-    m_shaderProgram = RESOURCE_MANAGER.LoadShader(
-        "triangle_shader",
-        // Уникальное имя для кэширования
-        EmbeddedShaders::TRIANGLE_VERTEX_SHADER,
-        EmbeddedShaders::TRIANGLE_FRAGMENT_SHADER
-        );
+    // Встроенные шейдеры регистрируются как набор вариантов, нужный вариант выбирается маской ключевых слов
+    RESOURCE_MANAGER.RegisterShaderVariants("triangle_shader",
+                                            EmbeddedShaders::TRIANGLE_VERTEX_SHADER,
+                                            EmbeddedShaders::TRIANGLE_FRAGMENT_SHADER);
+    // Правки assets/shaders/triangle.* подхватываются без перезапуска
+    RESOURCE_MANAGER.WatchShaderSources("triangle_shader", "triangle.vert", "triangle.frag");
+    RESOURCE_MANAGER.EnableHotReload();
+    uint32_t texturedMask = RESOURCE_MANAGER.GetShaderFeatureMask("triangle_shader", {"TEXTURED"});
+    RESOURCE_MANAGER.WarmUpShaderVariants("triangle_shader", {texturedMask});
 
-    if (m_shaderProgram != 0)
+    // Дескриптором варианта владеет набор - отдельная ссылка на него не нужна
+    m_shaderHandle = RESOURCE_MANAGER.GetShaderVariant("triangle_shader", texturedMask);
+    m_shader       = RESOURCE_MANAGER.GetShaderProgram(m_shaderHandle);
+
+    if (m_shader)
     {
         LOG_INFO("Successfully loaded embedded shaders via ResourceManager!");
     } else
@@ -41,8 +49,21 @@ void TriangleApp::Initialize()
         return;
     }
 
-    RESOURCE_MANAGER.LoadTexture("container.jpg");
-    RESOURCE_MANAGER.LoadTexture("awesomeface.png");
+    // GPU отсечение (Renderer::EnableGpuCulling) здесь не включается: оно работает только для DrawData
+    // отрисовок, а triangle_shader получает матрицу uniform'ом - сцену отсекают индексы и FrustumCuller
+
+    // Таблица uniform переменных собрана при линковке - проверяем наличие один раз, а не каждый кадр
+    if (!m_shader->HasUniform(UniformNames::Model)) { LOG_WARN("Model uniform not found in shader"); }
+    if (!m_shader->UsesFrameData()) { LOG_WARN("FrameData block not found in shader"); }
+
+    // Текстуры декодируются в фоне, до готовности вместо них используется заглушка.
+    // Запеченная версия загружается по уровням mip - крупные подгружаются по размеру квадрата на экране
+    m_containerTexture = RESOURCE_MANAGER.LoadTextureStreamed("container.jpg");
+    m_faceTexture      = RESOURCE_MANAGER.LoadTextureStreamed("awesomeface.png");
+
+    // Сэмплеры привязаны к юнитам 0 и 1 на все время работы программы
+    m_shader->SetInt(UniformNames::OurTexture1, 0);
+    m_shader->SetInt(UniformNames::OurTexture2, 1);
 
 
     // =============================================
@@ -64,168 +85,113 @@ void TriangleApp::Initialize()
     };
     // clang-format on
 
-    // Генерация буферов
-    m_VAO = GetRenderer()->CreateVAO();
-    m_VBO = GetRenderer()->CreateVBO(vertices, sizeof(vertices));
-
-    // Создаем EBO для индексов
-    glGenBuffers(1, &m_EBO);
-
-    glBindVertexArray(m_VAO);
-
-    // Привязка VBO
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-
-    // Привязка EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // Атрибут позиций
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*) 0);
-    glEnableVertexAttribArray(0);
-
-    // Атрибут цветов
-    glVertexAttribPointer(1,
-                          3,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          8 * sizeof(GLfloat),
-                          (void*) (3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    // Атрибут текстуры
-    glVertexAttribPointer(2,
-                          2,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          8 * sizeof(GLfloat),
-                          (void*) (6 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(2);
+    // Раскладка вершины: позиция, цвет, текстурные координаты
+    VertexLayout layout;
+    layout.stride     = 8 * sizeof(GLfloat);
+    layout.attributes = {
+        {0, 3, 0},                   // Атрибут позиций
+        {1, 3, 3 * sizeof(GLfloat)}, // Атрибут цветов
+        {2, 2, 6 * sizeof(GLfloat)}, // Атрибут текстуры
+    };
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // Буферы принадлежат ResourceManager, VAO ссылается на их ID
+    m_vertexBuffer = RESOURCE_MANAGER.CreateBuffer("triangle_vertices", vertices, sizeof(vertices));
+    m_indexBuffer  = RESOURCE_MANAGER.CreateBuffer("triangle_indices", indices, sizeof(indices));
+    m_VAO          = GetRenderer()->CreateVAO(RESOURCE_MANAGER.GetBuffer(m_vertexBuffer),
+                                     RESOURCE_MANAGER.GetBuffer(m_indexBuffer),
+                                     layout);
+
+    // Неподвижный ряд квадратов за вращающимся: трансформации запекаются в вершины, весь ряд -
+    // один батч и один вызов отрисовки
+    StaticBatcher& batcher = GetRenderer()->GetStaticBatcher();
+    for (int column = -2; column <= 2; ++column)
+    {
+        StaticMeshDesc tile;
+        tile.vertices    = vertices;
+        tile.vertexCount = 4;
+        tile.indices     = indices;
+        tile.indexCount  = 6;
+        tile.layout      = layout;
+        tile.program     = m_shader;
+        tile.textures    = {m_containerTexture, m_faceTexture};
+        tile.position    = glm::vec3(static_cast<float>(column), -1.2f, -1.5f);
+        tile.scale       = glm::vec3(0.8f);
+        if (StaticMeshId id = batcher.Add(tile)) { m_backgroundTiles.push_back(id); }
+    }
+
+    // Квадрат 1x1 в начале координат. Матрицу пересчитывает Scene::UpdateTransforms,
+    // пакет отрисовки и запросы разрешения текстур отправляет Scene::SubmitDraws
+    Scene& scene = *GetScene();
+    m_quad       = scene.CreateEntity();
+    scene.Add<Transform>(m_quad);
+    scene.Add<WorldTransform>(m_quad);
+    scene.Add<MeshComponent>(m_quad, {.vao = m_VAO, .indexCount = 6});
+    scene.Add<MaterialComponent>(m_quad, {.shader = m_shaderHandle, .textures = {m_containerTexture, m_faceTexture}});
+    scene.Add<Bounds>(m_quad, {.extents = glm::vec3(0.5f, 0.5f, 0.0f)});
 
     LOG_INFO("Triangle Application Initialized!");
 }
 
-void TriangleApp::Render()
+void TriangleApp::Update(float /*deltaTime*/)
 {
-    if (m_shaderProgram == 0 || m_VAO == 0)
-    {
-        LOG_ERROR("Shader program or VAO is invalid! Shader: {}, VAO: {}", m_shaderProgram, m_VAO);
-        return;
-    }
-
-    glUseProgram(m_shaderProgram);
-
-    // УПРОЩЕННЫЙ ПОДХОД: Используем только одну матрицу model для простоты
-    glm::mat4 model = glm::mat4(1.0f);
-    // Небольшое вращение для проверки
-    model = glm::rotate(model, (float) glfwGetTime() * 0.5f, glm::vec3(0.0f, 0.0f, 1.0f));
-
-    glm::mat4 view = glm::mat4(1.0f);
-    view           = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
-
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
-
-    // Установка матриц
-    GLint modelLoc = glGetUniformLocation(m_shaderProgram, "model");
-    GLint viewLoc  = glGetUniformLocation(m_shaderProgram, "view");
-    GLint projLoc  = glGetUniformLocation(m_shaderProgram, "projection");
-
-    if (modelLoc != -1)
-    {
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        //LOG_DEBUG("Model matrix set");
-    } else
+    // Небольшое вращение для проверки - углы в Transform задаются в градусах.
+    // EditTransform помечает матрицу к пересчету в Scene::UpdateTransforms
+    if (Transform* transform = GetScene()->EditTransform(m_quad))
     {
-        LOG_WARN("Model uniform not found in shader");
-    }
-
-    if (viewLoc != -1)
-    {
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-        //LOG_DEBUG("View matrix set");
-    } else
-    {
-        LOG_WARN("View uniform not found in shader");
+        transform->rotation.z = glm::degrees(static_cast<float>(glfwGetTime()) * 0.5f);
     }
+}
 
-    if (projLoc != -1)
-    {
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-        //LOG_DEBUG("Projection matrix set");
-    } else
+void TriangleApp::Render()
+{
+    if (!m_shader || m_VAO == 0)
     {
-        LOG_WARN("Projection uniform not found in shader");
+        LOG_ERROR("Shader program or VAO is invalid! Shader: {:#x}, VAO: {}", m_shaderHandle.value, m_VAO);
+        return;
     }
 
-    // Устанавливаем время для анимации
-    GLint timeLoc = glGetUniformLocation(m_shaderProgram, "time");
-    if (timeLoc != -1)
-    {
-        glUniform1f(timeLoc, (float) glfwGetTime());
-    }
+    glm::vec3 cameraPosition = glm::vec3(0.0f, 0.0f, 3.0f);
+    glm::mat4 view           = glm::translate(glm::mat4(1.0f), -cameraPosition);
 
-    // Устанавливаем цвета для градиента
-    GLint colorStartLoc = glGetUniformLocation(m_shaderProgram, "colorStart");
-    GLint colorEndLoc   = glGetUniformLocation(m_shaderProgram, "colorEnd");
+    // Соотношение сторон берется из текущей области отрисовки - проекция корректна после изменения размера окна
+    Renderer* renderer   = GetRenderer();
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), renderer->GetAspectRatio(), 0.1f, 100.0f);
 
-    if (colorStartLoc != -1)
-    {
-        glUniform3f(colorStartLoc, 1.0f, 0.7f, 0.5f);
-    }
-    if (colorEndLoc != -1)
-    {
-        glUniform3f(colorEndLoc, 0.3f, 0.8f, 1.0f);
-    }
+    // Камера и время кадра уходят в общий uniform блок FrameData
+    renderer->SetCamera(view, projection, cameraPosition);
 
-    // Привязываем текстуры (если они есть)
-    GLint texture1Loc = glGetUniformLocation(m_shaderProgram, "ourTexture1");
-    GLint texture2Loc = glGetUniformLocation(m_shaderProgram, "ourTexture2");
+    // Устанавливаем цвета для градиента (повторная загрузка неизменных значений пропускается)
+    m_shader->SetVec3(UniformNames::ColorStart, glm::vec3(1.0f, 0.7f, 0.5f));
+    m_shader->SetVec3(UniformNames::ColorEnd, glm::vec3(0.3f, 0.8f, 1.0f));
 
-    if (texture1Loc != -1)
+    if (const WorldTransform* world = GetScene()->Get<WorldTransform>(m_quad))
     {
-        RESOURCE_MANAGER.BindTexture("container.jpg", GL_TEXTURE0);
-        glUniform1i(texture1Loc, 0);
+        LOG_INFO_THROTTLED("Model matrix: [{:.2f}, {:.2f}, {:.2f}, {:.2f}]",
+                           world->matrix[0][0],
+                           world->matrix[0][1],
+                           world->matrix[0][2],
+                           world->matrix[0][3]);
     }
-
-    if (texture2Loc != -1)
-    {
-        RESOURCE_MANAGER.BindTexture("awesomeface.png", GL_TEXTURE1);
-        glUniform1i(texture2Loc, 1);
-    }
-
-    LOG_INFO_THROTTLED("Model matrix: [{:.2f}, {:.2f}, {:.2f}, {:.2f}]",
-                       model[0][0],
-                       model[0][1],
-                       model[0][2],
-                       model[0][3]);
-
-    // Отрисовка
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-    glUseProgram(0);
 }
 
 void TriangleApp::Shutdown()
 {
     LOG_INFO("Shutting down Triangle Application...");
 
-    if (m_shaderProgram != 0)
-    {
-        RESOURCE_MANAGER.UnloadShader("triangle_shader");
-        m_shaderProgram = 0;
-    }
+    GetScene()->DestroyEntity(m_quad);
+    m_quad = {};
 
-    if (m_textureID != 0)
-    {
-        // Указываем имя файла для выгрузки
-        RESOURCE_MANAGER.UnloadTexture("container.jpg");
-        RESOURCE_MANAGER.UnloadTexture("awesomeface.png");
-        m_textureID = 0;
-    }
+    // Программы удаляются в начале следующего кадра, дескрипторы после выгрузки просто не находятся
+    RESOURCE_MANAGER.UnloadShaderVariants("triangle_shader");
+    for (StaticMeshId id : m_backgroundTiles) { GetRenderer()->GetStaticBatcher().Remove(id); }
+    m_backgroundTiles.clear();
+    m_shaderHandle = {};
+    m_shader       = nullptr;
+
+    RESOURCE_MANAGER.ReleaseTexture(m_containerTexture);
+    RESOURCE_MANAGER.ReleaseTexture(m_faceTexture);
+    m_containerTexture = {};
+    m_faceTexture      = {};
 
     // Очистка геометрии
     if (m_VAO != 0)
@@ -234,15 +200,8 @@ void TriangleApp::Shutdown()
         m_VAO = 0;
     }
 
-    if (m_VBO != 0)
-    {
-        GetRenderer()->DeleteVBO(m_VBO);
-        m_VBO = 0;
-    }
-
-    if (m_EBO != 0)
-    {
-        glDeleteBuffers(1, &m_EBO);
-        m_EBO = 0;
-    }
+    RESOURCE_MANAGER.ReleaseBuffer(m_vertexBuffer);
+    RESOURCE_MANAGER.ReleaseBuffer(m_indexBuffer);
+    m_vertexBuffer = {};
+    m_indexBuffer  = {};
 }
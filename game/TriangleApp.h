@@ -7,8 +7,14 @@
 #ifndef TRIANGLEAPP_H
 #define TRIANGLEAPP_H
 
+#include <vector>
+
 #include "../engine/core/Application.h"
+#include "../engine/render/StaticBatcher.h"
+#include "../engine/scene/Entity.h"
+#include "../engine/utils/ResourceHandles.h"
 
+class ShaderProgram;
 
 class TriangleApp : public Application {
 public:
@@ -16,15 +22,22 @@ public:
         Application(800, 600, "TriangleApp") {}
 
     void Initialize() override;
+    void Update(float deltaTime) override;
     void Render() override;
     void Shutdown() override;
     //virtual void OnWindowResize(int width, int height) override;
 
 private:
-    GLuint m_textureID     = 0;
-    GLuint m_shaderProgram = 0;
-    GLuint m_VAO           = 0;
-    GLuint m_VBO           = 0;
-    GLuint m_EBO           = 0;
+    TextureHandle  m_containerTexture;
+    TextureHandle  m_faceTexture;
+    ShaderHandle   m_shaderHandle;
+    ShaderProgram* m_shader = nullptr; // Программа с закэшированными uniform локациями, адрес стабилен до выгрузки
+    GLuint         m_VAO    = 0;
+    BufferHandle   m_vertexBuffer;
+    BufferHandle   m_indexBuffer;
+    Entity         m_quad; // Квадрат в сцене - матрица и пакет отрисовки собираются системами сцены
+
+    // Неподвижный фон - меши в батче статической геометрии рендера
+    std::vector<StaticMeshId> m_backgroundTiles;
 };
 #endif // TRIANGLEAPP_H
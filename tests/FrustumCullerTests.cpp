@@ -0,0 +1,41 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "SceneTestUtils.h"
+#include "TestUtils.h"
+#include "scene/FrustumCuller.h"
+#include "utils/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Пакетная проверка боксов FrustumCuller (SIMD, последовательно и в пуле) против скалярного Intersects
+int main()
+{
+    std::mt19937 random(1234);
+    ThreadPool   pool(3);
+
+    // Больше порога параллельной проверки и не кратно ширине вектора
+    Test::BoxSet set     = Test::MakeBoxes(random, 20003);
+    Frustum      frustum = Test::MakeFrustum(glm::vec3(0.0f, 20.0f, 300.0f), glm::vec3(40.0f, 0.0f, 0.0f));
+
+    std::vector<uint32_t> expected = Test::BruteForce(set, frustum);
+    Test::Check(!expected.empty() && expected.size() < set.boxes.size(), "frustum sees part of the scene");
+
+    FrustumCuller culler;
+    for (size_t i = 0; i < set.boxes.size(); ++i) { culler.Add(set.handles[i], set.boxes[i]); }
+
+    for (ThreadPool* cullPool : {static_cast<ThreadPool*>(nullptr), &pool})
+    {
+        std::vector<uint32_t> visible;
+        for (uint32_t index : culler.Cull(frustum, cullPool)) { visible.push_back(culler.GetEntity(index).value); }
+        std::sort(visible.begin(), visible.end());
+        Test::Check(visible == expected, cullPool ? "parallel FrustumCuller matches Intersects"
+                                                  : "FrustumCuller matches Intersects");
+    }
+
+    return Test::Finish("frustum culler");
+}
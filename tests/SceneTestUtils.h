@@ -0,0 +1,72 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef SCENETESTUTILS_H
+#define SCENETESTUTILS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "scene/Entity.h"
+#include "scene/Geometry.h"
+#include "utils/SlotMap.h"
+
+/**
+ * Сцена из случайных боксов и эталон видимости полным перебором Intersects -
+ * общее для тестов отсечения и пространственных индексов
+ */
+namespace Test
+{
+    // Мелкие боксы вперемешку с редкими крупными, как в реальных уровнях
+    struct BoxSet
+    {
+        SlotMap<int, Entity> entities;
+        std::vector<Entity>  handles;
+        std::vector<Aabb>    boxes;
+    };
+
+    inline BoxSet MakeBoxes(std::mt19937& random, size_t count)
+    {
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.1f, 3.0f);
+        std::uniform_int_distribution<int>    large(0, 49);
+
+        BoxSet set;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float     scale = large(random) == 0 ? 40.0f : 1.0f;
+            glm::vec3 center(position(random), position(random), position(random));
+            glm::vec3 extents(size(random) * scale, size(random) * scale, size(random) * scale);
+            set.handles.push_back(set.entities.Insert(0));
+            set.boxes.push_back(Aabb::FromCenterExtents(center, extents));
+        }
+        return set;
+    }
+
+    inline Frustum MakeFrustum(const glm::vec3& eye, const glm::vec3& target)
+    {
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.5f, 600.0f);
+        glm::mat4 view       = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+        return Frustum::FromMatrix(projection * view);
+    }
+
+    // Отсортированные значения хендлов всех боксов, пересекающих пирамиду
+    inline std::vector<uint32_t> BruteForce(const BoxSet& set, const Frustum& frustum)
+    {
+        std::vector<uint32_t> visible;
+        for (size_t i = 0; i < set.boxes.size(); ++i)
+        {
+            if (Intersects(frustum, set.boxes[i])) { visible.push_back(set.handles[i].value); }
+        }
+        std::sort(visible.begin(), visible.end());
+        return visible;
+    }
+} // namespace Test
+#endif // SCENETESTUTILS_H
@@ -0,0 +1,74 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "SceneTestUtils.h"
+#include "TestUtils.h"
+#include "scene/Bvh.h"
+#include "scene/FrustumCuller.h"
+#include "scene/LooseOctree.h"
+#include "utils/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Выборки BVH (последовательная и параллельная сборка) и октодерева против полного перебора
+int main()
+{
+    std::mt19937 random(1234);
+    ThreadPool   pool(3);
+
+    // Больше размера поддерева, которое BVH строит отдельной задачей
+    Test::BoxSet set = Test::MakeBoxes(random, 30000);
+
+    std::vector<Bvh::Item> items;
+    for (size_t i = 0; i < set.boxes.size(); ++i) { items.push_back({set.handles[i], set.boxes[i]}); }
+
+    Bvh serial;
+    Bvh parallel;
+    serial.Build(items);
+    parallel.Build(items, &pool);
+    Test::Check(parallel.GetObjectCount() == set.boxes.size(), "parallel BVH keeps every object");
+
+    LooseOctree octree(600.0f, 8);
+    for (size_t i = 0; i < set.boxes.size(); ++i) { octree.Update(set.handles[i], set.boxes[i]); }
+
+    std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+    for (int view = 0; view < 16; ++view)
+    {
+        glm::vec3 eye(position(random), position(random), position(random));
+        glm::vec3 target(position(random), position(random), position(random));
+        Frustum   frustum = Test::MakeFrustum(eye, target);
+
+        std::vector<uint32_t> expected = Test::BruteForce(set, frustum);
+        auto                  query    = [&](auto& index) {
+            std::vector<uint32_t> found;
+            index.QueryFrustum(frustum, [&](Entity entity, const Aabb&) { found.push_back(entity.value); });
+            std::sort(found.begin(), found.end());
+            return found;
+        };
+        Test::Check(query(serial) == expected, "BVH frustum query matches brute force");
+        Test::Check(query(parallel) == expected, "parallel BVH frustum query matches brute force");
+        Test::Check(query(octree) == expected, "octree frustum query matches brute force");
+
+        // Путь сцены: кандидаты из обоих индексов, затем пакетная проверка
+        FrustumCuller culler;
+        auto          collect = [&](Entity entity, const Aabb& box) { culler.Add(entity, box); };
+        parallel.CollectFrustumCandidates(frustum, collect);
+        std::vector<uint32_t> visible;
+        for (uint32_t index : culler.Cull(frustum, &pool)) { visible.push_back(culler.GetEntity(index).value); }
+        std::sort(visible.begin(), visible.end());
+        Test::Check(visible == expected, "BVH candidates culled by FrustumCuller match brute force");
+
+        culler.Clear();
+        octree.CollectFrustumCandidates(frustum, collect);
+        visible.clear();
+        for (uint32_t index : culler.Cull(frustum, &pool)) { visible.push_back(culler.GetEntity(index).value); }
+        std::sort(visible.begin(), visible.end());
+        Test::Check(visible == expected, "octree candidates culled by FrustumCuller match brute force");
+    }
+
+    return Test::Finish("spatial index");
+}
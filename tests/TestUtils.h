@@ -0,0 +1,38 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#pragma once
+
+#ifndef TESTUTILS_H
+#define TESTUTILS_H
+
+#include <cstdio>
+
+/**
+ * Общее для тестовых исполняемых файлов - без тестового фреймворка
+ * Расхождения печатаются по мере проверки, код возврата main ненулевой при любом из них
+ */
+namespace Test
+{
+    inline int& Failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void Check(bool condition, const char* what)
+    {
+        if (condition) { return; }
+        std::printf("FAILED: %s\n", what);
+        ++Failures();
+    }
+
+    // Итог для возврата из main
+    inline int Finish(const char* suite)
+    {
+        if (Failures() == 0) { std::printf("All %s checks passed\n", suite); }
+        return Failures() == 0 ? 0 : 1;
+    }
+} // namespace Test
+#endif // TESTUTILS_H
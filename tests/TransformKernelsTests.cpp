@@ -0,0 +1,84 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+
+#include "TestUtils.h"
+#include "render/TransformManager.h"
+#include "scene/TransformKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Ядра пересчета матриц (SSE/AVX) против скалярного glm
+namespace
+{
+    float MaxDifference(const glm::mat4& a, const glm::mat4& b)
+    {
+        float difference = 0.0f;
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                difference = std::max(difference, std::abs(a[column][row] - b[column][row]));
+            }
+        }
+        return difference;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937                          random(1234);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> scale(0.25f, 4.0f);
+
+    // 19 узлов - полные пачки по 4 и 8 и скалярный хвост
+    constexpr size_t       COUNT = 19;
+    std::vector<Transform> locals(COUNT);
+    std::vector<glm::mat4> matrices(COUNT);
+    for (Transform& local : locals)
+    {
+        local.position = glm::vec3(position(random), position(random), position(random));
+        local.rotation = glm::vec3(angle(random), angle(random), angle(random));
+        local.scale    = glm::vec3(scale(random), scale(random), scale(random));
+    }
+    TransformKernels::ComposeLocal(locals.data(), matrices.data(), COUNT);
+
+    float difference = 0.0f;
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        glm::mat4 expected = TransformManager::CreateModelMatrix(locals[i].position, locals[i].rotation,
+                                                                 locals[i].scale);
+        difference         = std::max(difference, MaxDifference(matrices[i], expected));
+    }
+    Test::Check(difference < 1e-4f, "ComposeLocal matches T * Rx * Ry * Rz * S");
+
+    glm::mat4 product;
+    TransformKernels::Multiply(matrices[0], matrices[1], product);
+    Test::Check(MaxDifference(product, matrices[0] * matrices[1]) < 1e-3f, "Multiply matches glm");
+
+    // Цепочка и ветвление: родитель всегда раньше потомка
+    std::vector<uint32_t> parents = {~0u, 0, 1, 0, 3, ~0u, 5, 2, 7, 8, 4, 10, 6, 12, 13, 14, 11, 16, 17};
+    std::vector<uint32_t> nodes(COUNT);
+    for (uint32_t i = 0; i < COUNT; ++i) { nodes[i] = i; }
+
+    std::vector<glm::mat4> world(COUNT);
+    TransformKernels::ComposeWorld(nodes.data(), COUNT, parents.data(), matrices.data(), world.data());
+
+    difference = 0.0f;
+    std::vector<glm::mat4> expected(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        expected[i] = parents[i] == ~0u ? matrices[i] : expected[parents[i]] * matrices[i];
+        // Ошибка растет с глубиной и величиной переносов - сравниваем относительно масштаба значений
+        float magnitude = std::max(1.0f, MaxDifference(expected[i], glm::mat4(0.0f)));
+        difference      = std::max(difference, MaxDifference(world[i], expected[i]) / magnitude);
+    }
+    Test::Check(difference < 1e-4f, "ComposeWorld matches parent * local");
+
+    return Test::Finish("transform kernel");
+}
@@ -0,0 +1,186 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+// yagl_pack - сборка пакета ассетов .ypak
+// Использование: yagl_pack <папка assets> <файл пакета>
+// Ключ записи - имя файла без пути в нижнем регистре, так же как ResourceManager ищет ресурсы по имени.
+// Исходные изображения, у которых есть запеченная версия (<имя>.ytex), в пакет не попадают
+
+#include "utils/AssetPackFormat.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct PackedFile
+    {
+        fs::path    path;
+        std::string name; // В нижнем регистре
+        uint64_t    size = 0;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+    void WritePadding(std::ofstream& file, uint64_t target)
+    {
+        static const char zeros[YPAK_DATA_ALIGNMENT] = {};
+        while (static_cast<uint64_t>(file.tellp()) < target)
+        {
+            uint64_t remaining = target - static_cast<uint64_t>(file.tellp());
+            file.write(zeros, static_cast<std::streamsize>(std::min<uint64_t>(remaining, sizeof(zeros))));
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <assets dir> <output.ypak>\n", argv[0]);
+        return 1;
+    }
+
+    fs::path assetsDir  = argv[1];
+    fs::path outputPath = argv[2];
+    if (!fs::exists(assetsDir))
+    {
+        std::fprintf(stderr, "Assets directory %s does not exist\n", assetsDir.string().c_str());
+        return 1;
+    }
+
+    // Сбор файлов в детерминированном порядке - пакет не меняется без изменения ассетов
+    std::vector<PackedFile>         files;
+    std::unordered_set<std::string> names;
+    std::vector<fs::path>           paths;
+    for (const auto& entry : fs::recursive_directory_iterator(assetsDir))
+    {
+        if (entry.is_regular_file()) { paths.push_back(entry.path()); }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    auto lowerName = [](const fs::path& path) {
+        std::string name = path.filename().string();
+        std::transform(name.begin(), name.end(), name.begin(), YpakToLower);
+        return name;
+    };
+
+    // Движок берет запеченную версию вместо исходника - исходник рядом с ней в пакете был бы мертвым грузом
+    std::unordered_set<std::string> cooked;
+    for (const fs::path& path : paths)
+    {
+        std::string name = lowerName(path);
+        if (name.ends_with(".ytex")) { cooked.insert(name.substr(0, name.size() - 5)); }
+    }
+
+    size_t replaced = 0;
+    for (const fs::path& path : paths)
+    {
+        PackedFile file;
+        file.path = path;
+        file.name = lowerName(path);
+        file.size = fs::file_size(path);
+
+        if (cooked.contains(file.name))
+        {
+            ++replaced;
+            continue;
+        }
+        if (!names.insert(file.name).second)
+        {
+            std::fprintf(stderr, "  duplicate asset name %s, skipping %s\n", file.name.c_str(), path.string().c_str());
+            continue;
+        }
+        files.push_back(std::move(file));
+    }
+
+    // Хэш-таблица с заполнением не больше половины - в среднем одна-две пробы на поиск
+    uint32_t bucketCount = 16;
+    while (bucketCount < files.size() * 2) { bucketCount *= 2; }
+    std::vector<uint32_t> buckets(bucketCount, YPAK_EMPTY_BUCKET);
+
+    std::string            strings;
+    std::vector<YpakEntry> entries(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        YpakEntry& entry = entries[i];
+        entry.nameHash   = YpakHashName(files[i].name);
+        entry.nameOffset = static_cast<uint32_t>(strings.size());
+        entry.nameLength = static_cast<uint32_t>(files[i].name.size());
+        entry.size       = files[i].size;
+        entry.storedSize = files[i].size;
+        entry.flags      = 0;
+        strings += files[i].name;
+
+        uint32_t slot = static_cast<uint32_t>(entry.nameHash) & (bucketCount - 1);
+        while (buckets[slot] != YPAK_EMPTY_BUCKET) { slot = (slot + 1) & (bucketCount - 1); }
+        buckets[slot] = static_cast<uint32_t>(i);
+    }
+
+    YpakHeader header{};
+    header.magic         = YPAK_MAGIC;
+    header.version       = YPAK_VERSION;
+    header.entryCount    = static_cast<uint32_t>(entries.size());
+    header.bucketCount   = bucketCount;
+    header.entriesOffset = sizeof(YpakHeader);
+    header.bucketsOffset = header.entriesOffset + entries.size() * sizeof(YpakEntry);
+    header.stringsOffset = header.bucketsOffset + buckets.size() * sizeof(uint32_t);
+
+    uint64_t offset = header.stringsOffset + strings.size();
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        offset                = AlignUp(offset, YPAK_DATA_ALIGNMENT);
+        entries[i].dataOffset = offset;
+        offset += entries[i].storedSize;
+    }
+
+    if (outputPath.has_parent_path()) { fs::create_directories(outputPath.parent_path()); }
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output.is_open())
+    {
+        std::fprintf(stderr, "Failed to write %s\n", outputPath.string().c_str());
+        return 1;
+    }
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(entries.data()),
+                 static_cast<std::streamsize>(entries.size() * sizeof(YpakEntry)));
+    output.write(reinterpret_cast<const char*>(buckets.data()),
+                 static_cast<std::streamsize>(buckets.size() * sizeof(uint32_t)));
+    output.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    std::vector<char> buffer;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        WritePadding(output, entries[i].dataOffset);
+
+        std::ifstream input(files[i].path, std::ios::binary);
+        buffer.resize(files[i].size);
+        if (!input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+        {
+            std::fprintf(stderr, "Failed to read %s\n", files[i].path.string().c_str());
+            return 1;
+        }
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+
+    if (!output.good())
+    {
+        std::fprintf(stderr, "Failed to write %s\n", outputPath.string().c_str());
+        return 1;
+    }
+
+    std::printf("Packed %zu assets into %s (%llu KB), %zu sources replaced by cooked versions\n",
+                files.size(),
+                outputPath.string().c_str(),
+                static_cast<unsigned long long>(offset / 1024),
+                replaced);
+    return 0;
+}
@@ -0,0 +1,415 @@
+//
+// Created by l1nuvv on 17.10.2026.
+//
+// yagl_texcook - запекание текстур в формат .ytex
+// Использование: yagl_texcook <папка исходников> <папка результата> [--bc]
+//   --bc  сжатие BC1 (RGB) / BC3 (RGBA), одноканальные текстуры остаются R8
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "utils/TextureContainer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct Image
+    {
+        uint32_t             width    = 0;
+        uint32_t             height   = 0;
+        uint32_t             channels = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    // Следующий уровень mip - усреднение 2x2 (нечетный край повторяет последний столбец/строку)
+    Image Downsample(const Image& source)
+    {
+        Image result;
+        result.width    = std::max(source.width / 2, 1u);
+        result.height   = std::max(source.height / 2, 1u);
+        result.channels = source.channels;
+        result.pixels.resize(static_cast<size_t>(result.width) * result.height * result.channels);
+
+        for (uint32_t y = 0; y < result.height; ++y)
+        {
+            uint32_t y0 = std::min(y * 2, source.height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+            for (uint32_t x = 0; x < result.width; ++x)
+            {
+                uint32_t x0 = std::min(x * 2, source.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+                for (uint32_t c = 0; c < source.channels; ++c)
+                {
+                    auto at = [&](uint32_t sx, uint32_t sy) {
+                        return static_cast<uint32_t>(source.pixels[(sy * source.width + sx) * source.channels + c]);
+                    };
+                    uint32_t sum = at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1);
+                    result.pixels[(y * result.width + x) * result.channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        return result;
+    }
+
+    // =============================================
+    // BC1/BC3 - простой кодировщик по ограничивающему параллелепипеду блока
+    // =============================================
+
+    uint16_t PackRGB565(const uint8_t* rgb)
+    {
+        return static_cast<uint16_t>(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+    }
+
+    void UnpackRGB565(uint16_t color, int* rgb)
+    {
+        rgb[0] = ((color >> 11) & 31) * 255 / 31;
+        rgb[1] = ((color >> 5) & 63) * 255 / 63;
+        rgb[2] = (color & 31) * 255 / 31;
+    }
+
+    // block - 16 пикселей RGBA
+    void EncodeColorBlock(const uint8_t block[16][4], uint8_t* output)
+    {
+        uint8_t minColor[3] = {255, 255, 255};
+        uint8_t maxColor[3] = {0, 0, 0};
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                minColor[c] = std::min(minColor[c], block[i][c]);
+                maxColor[c] = std::max(maxColor[c], block[i][c]);
+            }
+        }
+
+        // Сдвиг концов внутрь на 1/16 диапазона уменьшает среднюю ошибку
+        for (int c = 0; c < 3; ++c)
+        {
+            int inset   = (maxColor[c] - minColor[c]) / 16;
+            minColor[c] = static_cast<uint8_t>(std::min(minColor[c] + inset, 255));
+            maxColor[c] = static_cast<uint8_t>(std::max(maxColor[c] - inset, 0));
+        }
+
+        uint16_t color0 = PackRGB565(maxColor);
+        uint16_t color1 = PackRGB565(minColor);
+        // color0 > color1 - режим 4 цветов
+        if (color0 < color1) { std::swap(color0, color1); }
+
+        int palette[4][3];
+        UnpackRGB565(color0, palette[0]);
+        UnpackRGB565(color1, palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        uint32_t indices = 0;
+        if (color0 != color1)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                int bestIndex    = 0;
+                int bestDistance = INT32_MAX;
+                for (int p = 0; p < 4; ++p)
+                {
+                    int distance = 0;
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        int delta = block[i][c] - palette[p][c];
+                        distance += delta * delta;
+                    }
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex    = p;
+                    }
+                }
+                indices |= static_cast<uint32_t>(bestIndex) << (i * 2);
+            }
+        }
+
+        std::memcpy(output, &color0, 2);
+        std::memcpy(output + 2, &color1, 2);
+        std::memcpy(output + 4, &indices, 4);
+    }
+
+    void EncodeAlphaBlock(const uint8_t block[16][4], uint8_t* output)
+    {
+        uint8_t alpha0 = 0;
+        uint8_t alpha1 = 255;
+        for (int i = 0; i < 16; ++i)
+        {
+            alpha0 = std::max(alpha0, block[i][3]);
+            alpha1 = std::min(alpha1, block[i][3]);
+        }
+
+        // alpha0 > alpha1 - режим 8 значений
+        int palette[8] = {alpha0, alpha1};
+        for (int i = 1; i < 7; ++i) { palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7; }
+
+        uint64_t indices = 0;
+        if (alpha0 != alpha1)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                int bestIndex    = 0;
+                int bestDistance = INT32_MAX;
+                for (int p = 0; p < 8; ++p)
+                {
+                    int distance = std::abs(block[i][3] - palette[p]);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex    = p;
+                    }
+                }
+                indices |= static_cast<uint64_t>(bestIndex) << (i * 3);
+            }
+        }
+
+        output[0] = alpha0;
+        output[1] = alpha1;
+        for (int i = 0; i < 6; ++i) { output[2 + i] = static_cast<uint8_t>(indices >> (i * 8)); }
+    }
+
+    std::vector<uint8_t> CompressBC(const Image& image, YtexFormat format)
+    {
+        size_t               blockSize = format == YtexFormat::BC3 ? 16 : 8;
+        uint32_t             blocksX   = (image.width + 3) / 4;
+        uint32_t             blocksY   = (image.height + 3) / 4;
+        std::vector<uint8_t> output(static_cast<size_t>(blocksX) * blocksY * blockSize);
+
+        uint8_t* cursor = output.data();
+        for (uint32_t by = 0; by < blocksY; ++by)
+        {
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                // Пиксели за краем изображения повторяют крайние
+                uint8_t block[16][4];
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    uint32_t       x     = std::min(bx * 4 + i % 4, image.width - 1);
+                    uint32_t       y     = std::min(by * 4 + i / 4, image.height - 1);
+                    const uint8_t* pixel = &image.pixels[(y * image.width + x) * image.channels];
+                    for (uint32_t c = 0; c < 3; ++c) { block[i][c] = pixel[std::min(c, image.channels - 1)]; }
+                    block[i][3] = image.channels == 4 ? pixel[3] : 255;
+                }
+
+                if (format == YtexFormat::BC3)
+                {
+                    EncodeAlphaBlock(block, cursor);
+                    EncodeColorBlock(block, cursor + 8);
+                }
+                else { EncodeColorBlock(block, cursor); }
+                cursor += blockSize;
+            }
+        }
+        return output;
+    }
+
+    // Запеченный файл новее исходника и сжат так же, как просили сейчас (одноканальные не сжимаются никогда)
+    bool IsUpToDate(const fs::path& destination, fs::file_time_type sourceTime, bool compress)
+    {
+        std::error_code error;
+        if (!fs::exists(destination, error) || fs::last_write_time(destination, error) < sourceTime) { return false; }
+
+        YtexHeader    header{};
+        std::ifstream file(destination, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != YTEX_MAGIC ||
+            header.version != YTEX_VERSION)
+        {
+            return false;
+        }
+
+        auto format = static_cast<YtexFormat>(header.format);
+        return format == YtexFormat::R8 || IsYtexCompressed(format) == compress;
+    }
+
+    size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+    bool CookTexture(const fs::path& source, const fs::path& destination, bool compress)
+    {
+        int width    = 0;
+        int height   = 0;
+        int channels = 0;
+        // Переворот тот же, что делает загрузчик движка для исходных файлов
+        stbi_set_flip_vertically_on_load(true);
+        uint8_t* data = stbi_load(source.string().c_str(), &width, &height, &channels, 0);
+        if (!data)
+        {
+            std::fprintf(stderr, "  failed to decode %s: %s\n", source.string().c_str(), stbi_failure_reason());
+            return false;
+        }
+
+        // Двухканальные (яркость + альфа) приводятся к RGBA - движок их не поддерживает
+        Image image;
+        image.width    = static_cast<uint32_t>(width);
+        image.height   = static_cast<uint32_t>(height);
+        image.channels = channels == 2 ? 4 : static_cast<uint32_t>(channels);
+        image.pixels.resize(static_cast<size_t>(image.width) * image.height * image.channels);
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+        {
+            if (channels == 2)
+            {
+                uint8_t* pixel = &image.pixels[i * 4];
+                pixel[0] = pixel[1] = pixel[2] = data[i * 2];
+                pixel[3]                       = data[i * 2 + 1];
+            }
+            else { std::memcpy(&image.pixels[i * image.channels], &data[i * image.channels], image.channels); }
+        }
+        stbi_image_free(data);
+
+        YtexFormat format = YtexFormat::RGBA8;
+        if (image.channels == 1) { format = YtexFormat::R8; }
+        if (image.channels == 3) { format = YtexFormat::RGB8; }
+        if (compress && image.channels == 3) { format = YtexFormat::BC1; }
+        if (compress && image.channels == 4) { format = YtexFormat::BC3; }
+
+        // Полная цепочка mip до 1x1
+        std::vector<Image> levels;
+        levels.push_back(std::move(image));
+        while ((levels.back().width > 1 || levels.back().height > 1) && levels.size() < YTEX_MAX_MIPS)
+        {
+            levels.push_back(Downsample(levels.back()));
+        }
+
+        YtexHeader header{};
+        header.magic    = YTEX_MAGIC;
+        header.version  = YTEX_VERSION;
+        header.flags    = YTEX_FLAG_FLIPPED;
+        header.format   = static_cast<uint32_t>(format);
+        header.width    = levels[0].width;
+        header.height   = levels[0].height;
+        header.mipCount = static_cast<uint32_t>(levels.size());
+
+        std::vector<YtexMip>              mips(levels.size());
+        std::vector<std::vector<uint8_t>> payloads(levels.size());
+        size_t offset = sizeof(YtexHeader) + sizeof(YtexMip) * levels.size();
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            payloads[i] = IsYtexCompressed(format) ? CompressBC(levels[i], format) : std::move(levels[i].pixels);
+
+            offset         = AlignUp(offset, YTEX_DATA_ALIGNMENT);
+            mips[i].width  = levels[i].width;
+            mips[i].height = levels[i].height;
+            mips[i].offset = offset;
+            mips[i].size   = payloads[i].size();
+            offset += payloads[i].size();
+        }
+
+        // Запущенная игра держит .ytex отображенным для потоковой загрузки: усечение файла на месте
+        // обрывает отображение (SIGBUS при чтении уровня). Запись во временный файл и переименование -
+        // старое отображение продолжает видеть прежний файл, горячая перезагрузка откроет новый
+        fs::create_directories(destination.parent_path());
+        fs::path tempPath = destination;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                std::fprintf(stderr, "  failed to write %s\n", tempPath.string().c_str());
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(mips.data()),
+                       static_cast<std::streamsize>(sizeof(YtexMip) * mips.size()));
+            for (size_t i = 0; i < payloads.size(); ++i)
+            {
+                // Заполнение нулями до выровненного начала уровня
+                static const char padding[YTEX_DATA_ALIGNMENT] = {};
+                file.write(padding,
+                           static_cast<std::streamsize>(mips[i].offset - static_cast<uint64_t>(file.tellp())));
+                file.write(reinterpret_cast<const char*>(payloads[i].data()),
+                           static_cast<std::streamsize>(payloads[i].size()));
+            }
+
+            file.close();
+            if (!file)
+            {
+                std::fprintf(stderr, "  failed to write %s\n", tempPath.string().c_str());
+                fs::remove(tempPath);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        fs::rename(tempPath, destination, error);
+        if (error)
+        {
+            std::fprintf(stderr, "  failed to replace %s: %s\n", destination.string().c_str(), error.message().c_str());
+            fs::remove(tempPath, error);
+            return false;
+        }
+
+        std::printf("  %s -> %s (%ux%u, %u mips, format %u)\n",
+                    source.filename().string().c_str(),
+                    destination.filename().string().c_str(),
+                    header.width,
+                    header.height,
+                    header.mipCount,
+                    header.format);
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <source dir> <output dir> [--bc]\n", argv[0]);
+        return 1;
+    }
+
+    fs::path sourceDir = argv[1];
+    fs::path outputDir = argv[2];
+    bool     compress  = argc > 3 && std::strcmp(argv[3], "--bc") == 0;
+
+    if (!fs::exists(sourceDir))
+    {
+        std::fprintf(stderr, "Source directory %s does not exist\n", sourceDir.string().c_str());
+        return 1;
+    }
+
+    const std::vector<std::string> supportedExtensions = {".jpg", ".jpeg", ".png", ".bmp", ".tga"};
+
+    int cooked  = 0;
+    int skipped = 0;
+    int failed  = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(sourceDir))
+    {
+        if (!entry.is_regular_file()) { continue; }
+
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (std::find(supportedExtensions.begin(), supportedExtensions.end(), extension) == supportedExtensions.end())
+        {
+            continue;
+        }
+
+        // "textures/wall.png" -> "cooked/wall.png.ytex" - движок ищет запеченную версию по полному имени исходника
+        fs::path destination = outputDir / fs::relative(entry.path(), sourceDir);
+        destination += ".ytex";
+
+        // Неизменившиеся исходники не перезапекаются
+        if (IsUpToDate(destination, entry.last_write_time(), compress))
+        {
+            ++skipped;
+            continue;
+        }
+
+        if (CookTexture(entry.path(), destination, compress)) { ++cooked; }
+        else { ++failed; }
+    }
+
+    std::printf("Textures cooked: %d, up to date: %d, failed: %d\n", cooked, skipped, failed);
+    return failed == 0 ? 0 : 1;
+}